@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_AHO_H_
+#define INC_NCV_AHO_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The s_aho struct is an Aho-Corasick automaton for a list of patterns. It
+ * finds the occurrences of all patterns with a single scan of a string. The
+ * number of occurrences of each pattern can be counted, which is used for
+ * the summary of a multi pattern search.
+ *
+ * The struct is defined in the source file.
+ *****************************************************************************/
+
+typedef struct s_aho s_aho;
+
+s_aho* s_aho_create(wchar_t **patterns, const int no_patterns, const bool case_insensitive);
+
+void s_aho_free(s_aho *aho);
+
+int s_aho_no_patterns(const s_aho *aho);
+
+const wchar_t* s_aho_pattern(const s_aho *aho, const int idx);
+
+bool s_aho_matches(const s_aho *aho, const wchar_t *str);
+
+wchar_t* s_aho_search(const s_aho *aho, const wchar_t *str, const size_t offset, size_t *len);
+
+void s_aho_reset_counts(s_aho *aho);
+
+int s_aho_count(s_aho *aho, const wchar_t *str);
+
+int s_aho_get_count(const s_aho *aho, const int idx);
+
+#endif /* INC_NCV_AHO_H_ */
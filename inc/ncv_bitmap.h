@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_BITMAP_H_
+#define INC_NCV_BITMAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * A compressed bitmap with the indices of rows, similar to a roaring bitmap.
+ * The indices are split in chunks of 65536 indices. A chunk with a few
+ * indices stores them as a sorted array of 16 bit values, a chunk with many
+ * indices stores a bit set of 1024 64 bit words. Chunks without indices are
+ * not stored.
+ *****************************************************************************/
+
+#define BITMAP_CHUNK_SHIFT 16
+
+#define BITMAP_CHUNK_BITS (1 << BITMAP_CHUNK_SHIFT)
+
+#define BITMAP_CHUNK_WORDS (BITMAP_CHUNK_BITS / 64)
+
+//
+// A chunk with more indices than the maximum of the array is a bit set,
+// because the bit set is smaller.
+//
+#define BITMAP_ARRAY_MAX 4096
+
+/******************************************************************************
+ * The number of 64 bit words of a plain bit set for a number of bits and the
+ * macros to access the bits.
+ *****************************************************************************/
+
+#define s_bits_words(n) (((n) + 63) / 64)
+
+#define s_bits_get(w,i) (((w)[(i) >> 6] >> ((i) & 63)) & 1)
+
+#define s_bits_set(w,i) ((w)[(i) >> 6] |= UINT64_C(1) << ((i) & 63))
+
+/******************************************************************************
+ * The definition of a chunk. Either the array or the words are set.
+ *****************************************************************************/
+
+typedef struct s_bitmap_chunk {
+
+	//
+	// The upper 16 bits of the indices of the chunk.
+	//
+	int key;
+
+	int cardinality;
+
+	uint16_t *array;
+
+	uint64_t *words;
+
+} s_bitmap_chunk;
+
+typedef struct s_bitmap {
+
+	s_bitmap_chunk *chunks;
+
+	int no_chunks;
+
+	int cardinality;
+
+} s_bitmap;
+
+/******************************************************************************
+ * The operations to combine two bitmaps.
+ *****************************************************************************/
+
+enum e_bitmap_op {
+	E_BITMAP_AND, E_BITMAP_OR, E_BITMAP_AND_NOT
+};
+
+/******************************************************************************
+ * Function definitions.
+ *****************************************************************************/
+
+#define s_bitmap_cardinality(b) ((b)->cardinality)
+
+void s_bitmap_init(s_bitmap *bitmap);
+
+void s_bitmap_free(s_bitmap *bitmap);
+
+void s_bitmap_from_bits(s_bitmap *bitmap, const uint64_t *bits, const int no_bits);
+
+void s_bitmap_to_bits(const s_bitmap *bitmap, uint64_t *bits, const int no_bits);
+
+bool s_bitmap_contains(const s_bitmap *bitmap, const int idx);
+
+void s_bitmap_combine(s_bitmap *result, const s_bitmap *bitmap_1, const s_bitmap *bitmap_2, const enum e_bitmap_op op);
+
+void s_bitmap_not(s_bitmap *result, const s_bitmap *bitmap, const int no_bits);
+
+size_t s_bitmap_size(const s_bitmap *bitmap);
+
+#endif /* INC_NCV_BITMAP_H_ */
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_BLOCKS_H_
+#define INC_NCV_BLOCKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The rows of the table are grouped in blocks of 4096 rows. The block of a
+ * row is given by the index of the row in the unfiltered table.
+ *****************************************************************************/
+
+#define BLOCK_SHIFT 12
+
+#define BLOCK_ROWS (1 << BLOCK_SHIFT)
+
+#define s_blocks_count(n) (((n) + BLOCK_ROWS - 1) >> BLOCK_SHIFT)
+
+#define s_blocks_of_row(i) ((i) >> BLOCK_SHIFT)
+
+/******************************************************************************
+ * The number of 64 bit words of the bloom filter of the bigrams.
+ *****************************************************************************/
+
+#define BLOCK_BLOOM_WORDS 16
+
+/******************************************************************************
+ * The summary of a column of a block contains the chars and the bigrams (two
+ * consecutive chars) of the fields. The chars are lower case and are hashed
+ * to the bits of a word, the bigrams are hashed to the bits of a small bloom
+ * filter. If a char or a bigram of a string is missing in the summary, no
+ * field of the block contains the string, so the block can be skipped.
+ *****************************************************************************/
+
+typedef struct s_block_summary {
+
+	uint64_t chars;
+
+	uint64_t bigrams[BLOCK_BLOOM_WORDS];
+
+} s_block_summary;
+
+/******************************************************************************
+ * The s_blocks struct contains the summaries of all blocks and columns of a
+ * table. If the number of blocks is 0, there are no summaries and no block
+ * can be skipped.
+ *****************************************************************************/
+
+typedef struct s_blocks {
+
+	int no_blocks;
+
+	int no_columns;
+
+	s_block_summary *summaries;
+
+} s_blocks;
+
+void s_blocks_init(s_blocks *blocks);
+
+void s_blocks_create(s_blocks *blocks, wchar_t ***rows, const int no_rows, const int no_columns);
+
+void s_blocks_free(s_blocks *blocks);
+
+bool s_blocks_may_contain(const s_blocks *blocks, const int block, const int column, const wchar_t *str);
+
+#endif /* INC_NCV_BLOCKS_H_ */
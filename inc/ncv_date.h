@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_DATE_H_
+#define INC_NCV_DATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The number of rows of a column, that are used to detect the date format.
+ * The rows are spread over the column.
+ *****************************************************************************/
+
+#define DATE_SAMPLE 64
+
+/******************************************************************************
+ * The order of the parts of a date. The numerical dates have a separator,
+ * like: 2026-10-16, 16.10.2026 or 10/16/2026. The dates with a month name
+ * are: Oct 16 2026, Oct 16, 2026 or 16 Oct 2026. A date can be followed by a
+ * time: 16/10/2026 14:03 or 2026-10-16T14:03:59.
+ *****************************************************************************/
+
+enum e_date_order {
+	E_DATE_YMD, E_DATE_DMY, E_DATE_MDY, E_DATE_MON_D_Y, E_DATE_D_MON_Y
+};
+
+/******************************************************************************
+ * The s_date_fmt struct is the format of the dates of a column.
+ *****************************************************************************/
+
+typedef struct s_date_fmt {
+
+	enum e_date_order order;
+
+	//
+	// The separator of the parts of the date.
+	//
+	wchar_t sep;
+
+} s_date_fmt;
+
+int64_t s_date_epoch(const int year, const int month, const int day, const int hour, const int min, const int sec);
+
+bool s_date_parse(const s_date_fmt *fmt, const wchar_t *str, int64_t *epoch);
+
+bool s_date_parse_iso(const wchar_t *str, int64_t *epoch);
+
+bool s_date_detect(wchar_t ***rows, const int first, const int last, const int col, unsigned int *candidates, s_date_fmt *fmt);
+
+bool s_date_narrow(unsigned int *candidates, const wchar_t *str, s_date_fmt *fmt);
+
+#endif /* INC_NCV_DATE_H_ */
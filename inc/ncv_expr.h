@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_EXPR_H_
+#define INC_NCV_EXPR_H_
+
+#include "ncv_num.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The s_expr struct is a compiled filter expression, which is a boolean
+ * combination of column predicates, like:
+ *
+ * status=FAIL AND latency>500 AND NOT host~test
+ *
+ * The supported syntax is:
+ *
+ * col=value  col!=value   field equals (not) the value
+ * col~value  col!~value   field contains (not) the value
+ * col<num    col<=num     numeric comparisons, fields that
+ * col>num    col>=num     do not start with a number do not match
+ * col BETWEEN a AND b    inclusive numeric range
+ * col>2026-10-16          dates are compared with ISO dates, which can have
+ *                         a time: "2026-10-16 14:03"
+ * value                   a field of any column contains the value
+ * x AND y    x OR y       combinations, AND binds stronger than OR, terms
+ * NOT x      ( x )        without AND / OR are combined with AND
+ *
+ * A column is a 1-based column number or the name of a header column. A value
+ * can be quoted: "a value". The expression is compiled to a predicate tree,
+ * where the operands of AND and OR are ordered by their costs, so cheap
+ * predicates are evaluated first. The numeric comparisons are ranges, which
+ * can be evaluated with the parsed values of a column (see: ncv_num.h).
+ *
+ * The struct is defined in the source file.
+ *****************************************************************************/
+
+typedef struct s_expr s_expr;
+
+s_expr* s_expr_create(const wchar_t *str, const bool case_insensitive, wchar_t **header, const int no_columns);
+
+void s_expr_free(s_expr *expr);
+
+bool s_expr_eval(const s_expr *expr, wchar_t **row, const int row_idx);
+
+s_num_range* s_expr_get_ranges(s_expr *expr, int *no_ranges);
+
+bool s_expr_may_match_block(const s_expr *expr, const s_blocks *blocks, const int block);
+
+bool s_expr_field_matches(const s_expr *expr, const int column, const wchar_t *str);
+
+wchar_t* s_expr_search(const s_expr *expr, const int column, const wchar_t *str, const size_t offset, size_t *len);
+
+#endif /* INC_NCV_EXPR_H_ */
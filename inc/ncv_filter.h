@@ -25,10 +25,25 @@
 #ifndef INC_NCV_FILTER_H_
 #define INC_NCV_FILTER_H_
 
+#include "ncv_regex.h"
+#include "ncv_fuzzy.h"
+#include "ncv_aho.h"
+#include "ncv_expr.h"
+
 #include <stdbool.h>
+#include <stdint.h>
 #include <wchar.h>
 
-#define FILTER_STR_LEN 32
+#define FILTER_STR_LEN 128
+
+/******************************************************************************
+ * The filter can be restricted to a set of columns. The set is defined by a
+ * string like: "2,5-7" with 1-based column numbers. The syntax of the string
+ * is checked when it is set. The columns are created by s_filter_prepare(),
+ * which checks them against the number of columns of the table.
+ *****************************************************************************/
+
+#define FILTER_COLS_LEN 32
 
 /******************************************************************************
  * The filter struct contains the filter string and a flag, whether the
@@ -52,11 +67,86 @@ typedef struct s_filter {
 	//
 	bool is_search;
 
+	//
+	// A flag that defines whether the filter string is a regular expression.
+	//
+	bool is_regex;
+
+	//
+	// A flag that defines whether the search is approximate, which means
+	// that a match can have a few errors (typos). The regex flag has
+	// precedence.
+	//
+	bool is_fuzzy;
+
+	//
+	// A flag that defines whether the filter string is a list of patterns,
+	// separated by: | or a file with one pattern per line: @file. A field
+	// matches if it contains one of the patterns. The regex and the fuzzy
+	// flags have precedence.
+	//
+	bool is_multi;
+
+	//
+	// A flag that defines whether the filter string is a boolean expression
+	// with column predicates. It has precedence over the regex flag.
+	//
+	bool is_expr;
+
 	//
 	// The actual filter string.
 	//
 	wchar_t str[FILTER_STR_LEN + 1];
 
+	//
+	// The compiled regular expression, if the filter is an active regex
+	// filter. It is owned by the filter and created by s_filter_prepare().
+	//
+	s_regex *regex;
+
+	//
+	// The compiled expression, if the filter is an active expression filter.
+	// It is owned by the filter and created by s_filter_prepare().
+	//
+	s_expr *expr;
+
+	//
+	// The compiled pattern, if the filter is an active fuzzy filter. It is
+	// owned by the filter and created by s_filter_prepare().
+	//
+	s_fuzzy *fuzzy;
+
+	//
+	// The automaton of the patterns, if the filter is an active multi
+	// pattern filter. It is owned by the filter and created by
+	// s_filter_prepare(). It contains the number of occurrences of each
+	// pattern, which are counted while indexing the matches.
+	//
+	s_aho *aho;
+
+	//
+	// The string that defines the columns the filter is restricted to. An
+	// empty string means that all columns are searched.
+	//
+	wchar_t cols_str[FILTER_COLS_LEN + 1];
+
+	//
+	// A flag that the columns string contains a column, so the filter is
+	// restricted.
+	//
+	bool is_restricted;
+
+	//
+	// The searched columns of a restricted filter, as a bitmap and as an
+	// ordered array of the 0-based column indices. Both are owned by the
+	// filter and created by s_filter_prepare().
+	//
+	uint64_t *col_bits;
+
+	int *columns;
+
+	int no_columns;
+
 	//
 	// A flag that this filter was updated.
 	//
@@ -69,6 +159,24 @@ typedef struct s_filter {
 
 } s_filter;
 
+/******************************************************************************
+ * The delimiter of the patterns of a multi pattern filter, the prefix of a
+ * file with patterns and the maximum length of a line of the file.
+ *****************************************************************************/
+
+#define FILTER_MULTI_DELIM L'|'
+
+#define FILTER_MULTI_FILE L'@'
+
+#define FILTER_MULTI_LINE_LEN 1024
+
+/******************************************************************************
+ * The maximum length of the key of a filter for the cache of the results,
+ * which consists of the flags, the columns and the filter string.
+ *****************************************************************************/
+
+#define FILTER_KEY_LEN (FILTER_STR_LEN + FILTER_COLS_LEN + 16)
+
 /******************************************************************************
  * For readability a few constants are defined.
  *****************************************************************************/
@@ -89,8 +197,6 @@ typedef struct s_filter {
  * Function and macro definitions
  *****************************************************************************/
 
-#define s_filter_init(f) s_filter_set(f, SF_IS_INACTIVE, L"", SF_IS_INSENSITIVE, SF_IS_FILTERING)
-
 #define s_filter_is_active(f) ((f)->is_active)
 
 #define s_filter_is_filtering(f) (!(f)->is_search)
@@ -101,14 +207,46 @@ typedef struct s_filter {
 
 #define s_filter_len(f) wcslen((f)->str)
 
+#define s_filter_is_expr(f) ((f)->is_expr)
+
+#define s_filter_is_restricted(f) (!(f)->is_expr && (f)->is_restricted)
+
+void s_filter_init(s_filter *filter);
+
+void s_filter_free(s_filter *filter);
+
+bool s_filter_prepare(s_filter *filter, wchar_t **header, const int no_columns);
+
+bool s_filter_is_prepared(const s_filter *filter);
+
 bool s_filter_set(s_filter *filter, const bool is_active, const wchar_t *str, const bool case_insensitive, const bool is_search);
 
 bool s_filter_set_inactive(s_filter *filter);
 
 bool s_filter_update(s_filter *to_filter, const s_filter *from_filter);
 
+bool s_filter_is_refinement(const s_filter *old_filter, const s_filter *new_filter);
+
+bool s_filter_cache_key(const s_filter *filter, wchar_t *key, const size_t size);
+
+bool s_filter_set_columns(s_filter *filter, const wchar_t *cols_str);
+
+bool s_filter_has_column(const s_filter *filter, const int column);
+
+int s_filter_num_columns(const s_filter *filter, const int no_columns);
+
+int s_filter_get_column(const s_filter *filter, const int idx);
+
 wchar_t* s_filter_search_str(const s_filter *filter, const wchar_t *str);
 
+bool s_filter_matches(const s_filter *filter, const int column, const wchar_t *str);
+
+bool s_filter_matches_row(const s_filter *filter, wchar_t **row, const int row_idx, const int no_columns);
+
+bool s_filter_may_match_block(const s_filter *filter, const s_blocks *blocks, const int block, const int no_columns);
+
+wchar_t* s_filter_search_match(const s_filter *filter, const int column, const wchar_t *str, const size_t offset, size_t *len);
+
 //
 // Function declarations that only make sense with debug mode.
 //
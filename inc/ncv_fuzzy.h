@@ -0,0 +1,65 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_FUZZY_H_
+#define INC_NCV_FUZZY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The maximum length of a fuzzy pattern, which is the number of bits of the
+ * bit vectors of the algorithm.
+ *****************************************************************************/
+
+#define FUZZY_MAX_LEN 64
+
+/******************************************************************************
+ * The s_fuzzy struct is a compiled pattern for an approximate search. A string
+ * matches, if it contains a substring with an edit distance (Levenshtein) to
+ * the pattern, that is not greater than the maximum number of errors. The
+ * maximum depends on the length of the pattern:
+ *
+ * length 1 - 3: 0, length 4 - 7: 1, length 8 - 11: 2, longer: 3
+ *
+ * The search is done with the bit-parallel algorithm of Myers, which processes
+ * a char of the string with a few bit operations.
+ *
+ * The struct is defined in the source file.
+ *****************************************************************************/
+
+typedef struct s_fuzzy s_fuzzy;
+
+s_fuzzy* s_fuzzy_create(const wchar_t *pattern, const bool case_insensitive);
+
+void s_fuzzy_free(s_fuzzy *fuzzy);
+
+int s_fuzzy_max_errors(const s_fuzzy *fuzzy);
+
+bool s_fuzzy_matches(const s_fuzzy *fuzzy, const wchar_t *str);
+
+wchar_t* s_fuzzy_search(const s_fuzzy *fuzzy, const wchar_t *str, const size_t offset, size_t *len);
+
+#endif /* INC_NCV_FUZZY_H_ */
@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_JOB_H_
+#define INC_NCV_JOB_H_
+
+#include "ncv_table.h"
+
+#include <pthread.h>
+
+/******************************************************************************
+ * The s_job struct is used to do the filtering and sorting of a table in a
+ * background thread, so the ui stays responsive. The thread works on a copy of
+ * the table, that shares the field data, but has its own row pointers, row
+ * heights, match index and filter. The ui thread uses the unchanged table,
+ * until the job finished and the result is published to the table. If the job
+ * is cancelled, the result is thrown away.
+ *****************************************************************************/
+
+typedef struct s_job {
+
+	pthread_t thread;
+
+	//
+	// The mutex and the condition are used to wait for the end of the job.
+	//
+	pthread_mutex_t mutex;
+
+	pthread_cond_t cond;
+
+	bool is_done;
+
+	//
+	// The copy of the table and the cursor, which are updated by the thread.
+	//
+	s_table table;
+
+	s_cursor cursor;
+
+	bool filter_changed;
+
+	bool sort_changed;
+
+	//
+	// A flag that the new filter is a refinement of the filter of the table,
+	// so only the rows of the current view have to be filtered.
+	//
+	bool refine;
+
+	//
+	// A flag that the job only indexes the remaining matches of a search.
+	//
+	bool count_only;
+
+	//
+	// A flag that the job combines the view of the filter with the rows of
+	// the previous filter, with the given operation.
+	//
+	bool is_combine;
+
+	enum e_combine combine;
+
+	//
+	// The message of s_table_update_filter_sort().
+	//
+	wchar_t *result;
+
+	//
+	// The progress and the cancel flag of the job.
+	//
+	s_progress progress;
+
+} s_job;
+
+void s_job_start(s_job *job, const s_table *table, const s_cursor *cursor, const s_filter *filter, const s_sort *sort, const bool filter_changed, const bool sort_changed);
+
+void s_job_start_count(s_job *job, const s_table *table, const s_cursor *cursor);
+
+void s_job_start_combine(s_job *job, const s_table *table, const s_cursor *cursor, const enum e_combine combine);
+
+bool s_job_wait(s_job *job, const int timeout_ms);
+
+void s_job_cancel(s_job *job);
+
+wchar_t* s_job_finish(s_job *job, s_table *table, s_cursor *cursor);
+
+#endif /* INC_NCV_JOB_H_ */
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_LRU_H_
+#define INC_NCV_LRU_H_
+
+#include "ncv_bitmap.h"
+
+#include <wchar.h>
+
+/******************************************************************************
+ * The number of entries of the cache.
+ *****************************************************************************/
+
+#define LRU_SIZE 8
+
+/******************************************************************************
+ * The s_lru struct is a small cache with the bitmaps of the rows, that
+ * matched a filter. The key of an entry is the normalized filter. If the
+ * cache is full, the least recently used entry is replaced.
+ *****************************************************************************/
+
+typedef struct s_lru_entry {
+
+	wchar_t *key;
+
+	s_bitmap bitmap;
+
+	//
+	// The value of the clock of the cache, when the entry was used.
+	//
+	unsigned long used;
+
+} s_lru_entry;
+
+typedef struct s_lru {
+
+	s_lru_entry entries[LRU_SIZE];
+
+	int no_entries;
+
+	unsigned long clock;
+
+} s_lru;
+
+void s_lru_init(s_lru *lru);
+
+void s_lru_free(s_lru *lru);
+
+const s_bitmap* s_lru_get(s_lru *lru, const wchar_t *key);
+
+void s_lru_put(s_lru *lru, const wchar_t *key, s_bitmap *bitmap);
+
+const s_bitmap* s_lru_get_other(const s_lru *lru, const wchar_t *key);
+
+#endif /* INC_NCV_LRU_H_ */
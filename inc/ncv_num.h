@@ -0,0 +1,214 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_NUM_H_
+#define INC_NCV_NUM_H_
+
+#include "ncv_progress.h"
+#include "ncv_blocks.h"
+#include "ncv_date.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The bitmaps have one bit for each row of the table. The macros return the
+ * number of 64 bit words for a number of rows and the bit of a row.
+ *****************************************************************************/
+
+#define s_num_bitmap_words(n) (((n) + 63) / 64)
+
+#define s_num_bit(b, i) (((b)[(i) >> 6] >> ((i) & 63)) & 1)
+
+/******************************************************************************
+ * The types of a column, which are inferred from the values of the column.
+ * Integer and float columns have numbers with the same suffix. Boolean
+ * columns have the values true and false, which are the numbers 1 and 0.
+ * Date columns have dates with the same format, which are the seconds since
+ * 1970-01-01. All other columns are string columns.
+ *****************************************************************************/
+
+enum e_num_type {
+	E_NUM_TYPE_STR, E_NUM_TYPE_INT, E_NUM_TYPE_FLOAT, E_NUM_TYPE_BOOL, E_NUM_TYPE_DATE
+};
+
+/******************************************************************************
+ * The s_num_infer struct collects the characteristics of the values of a
+ * column, which are used to infer the type of the column.
+ *****************************************************************************/
+
+typedef struct s_num_infer {
+
+	//
+	// The number of values, that are not empty.
+	//
+	int no_values;
+
+	//
+	// The number of numbers, integers and booleans of the values.
+	//
+	int no_nums;
+
+	int no_ints;
+
+	int no_bools;
+
+	//
+	// The suffix of the first number and a flag, that indicates that all
+	// numbers have this suffix.
+	//
+	const wchar_t *suffix;
+
+	bool same_suffix;
+
+} s_num_infer;
+
+/******************************************************************************
+ * The s_num_column struct contains the parsed numerical values of a column of
+ * the table. The arrays are indexed with the index of the row in the
+ * unfiltered and unsorted table. A column is parsed once on demand and is
+ * used for numerical sorting and for filtering with numerical ranges. The
+ * parsing infers the type of the column.
+ *****************************************************************************/
+
+typedef struct s_num_column {
+
+	//
+	// The flag indicates that the column was parsed.
+	//
+	bool is_parsed;
+
+	//
+	// The values of the fields. Fields that are empty or that are not numbers
+	// have the value NaN, so they never match a range.
+	//
+	double *values;
+
+	//
+	// A number can have a non numerical suffix, like: "1000,00 Euro". The
+	// pointer points into the field content and is NULL if the field is not
+	// a number.
+	//
+	const wchar_t **suffixes;
+
+	//
+	// The type of the column, which is inferred without the first row, which
+	// can be a header. The suffix is the suffix of the numbers of the column.
+	// The flag indicates that the first row is empty or has the type.
+	//
+	enum e_num_type type;
+
+	const wchar_t *suffix;
+
+	bool first_has_type;
+
+	//
+	// The format of the dates of a date column.
+	//
+	s_date_fmt date_fmt;
+
+	//
+	// The bitmaps of the fields that are numbers and the fields that are
+	// empty.
+	//
+	uint64_t *valid;
+
+	uint64_t *empty;
+
+	//
+	// The minimum and the maximum of the valid values of each block of rows
+	// (see: ncv_blocks.h). A block without a valid value has an empty range.
+	//
+	double *block_min;
+
+	double *block_max;
+
+} s_num_column;
+
+/******************************************************************************
+ * The s_num_range struct is a range of numerical values of a column, like:
+ * latency > 500 or latency between 500 and 1000. The bitmap contains the rows
+ * with a value in the range and the blocks bitmap contains the blocks with at
+ * least one of these rows. They are NULL until the range is applied to a
+ * parsed column.
+ *****************************************************************************/
+
+typedef struct s_num_range {
+
+	int column;
+
+	double min;
+
+	bool min_incl;
+
+	double max;
+
+	bool max_incl;
+
+	//
+	// If the range was applied to a date column, the fields of the column
+	// are dates with the format.
+	//
+	bool is_date;
+
+	s_date_fmt date_fmt;
+
+	uint64_t *bitmap;
+
+	uint64_t *blocks;
+
+} s_num_range;
+
+void s_num_column_init(s_num_column *column);
+
+void s_num_column_free(s_num_column *column);
+
+bool s_num_column_parse(s_num_column *column, wchar_t ***rows, const int no_rows, const int col, s_progress *progress);
+
+wchar_t s_num_decimal_point();
+
+bool s_num_parse_dec(const wchar_t *str, const wchar_t decimal, double *value, const wchar_t **suffix);
+
+bool s_num_parse(const wchar_t *str, double *value, const wchar_t **suffix);
+
+bool s_num_parse_field(const wchar_t *str, const wchar_t decimal, double *value, const wchar_t **suffix, bool *is_bool);
+
+void s_num_infer_init(s_num_infer *infer);
+
+void s_num_infer_add(s_num_infer *infer, const double value, const wchar_t *suffix, const bool is_bool);
+
+enum e_num_type s_num_infer_type(const s_num_infer *infer);
+
+bool s_num_infer_matches(const s_num_infer *infer, const wchar_t *str, const wchar_t decimal);
+
+void s_num_range_init(s_num_range *range, const int column, const double min, const bool min_incl, const double max, const bool max_incl);
+
+void s_num_range_free(s_num_range *range);
+
+bool s_num_range_matches(const s_num_range *range, const double value);
+
+void s_num_range_apply(s_num_range *range, const s_num_column *column, const int no_rows);
+
+#endif /* INC_NCV_NUM_H_ */
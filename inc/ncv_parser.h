@@ -27,6 +27,12 @@
 
 #include "ncv_table.h"
 
+/******************************************************************************
+ * The maximum number of rows of a sample, which bounds the memory.
+ *****************************************************************************/
+
+#define SAMPLE_MAX_ROWS 10000000
+
 /******************************************************************************
  * The struct contains the configuration of the parser.
  *****************************************************************************/
@@ -55,6 +61,12 @@ typedef struct s_cfg_parser {
 	//
 	bool strict;
 
+	//
+	// If the value is greater than 0, the table is a uniform random sample
+	// with the given number of rows (and the first row).
+	//
+	int sample;
+
 } s_cfg_parser;
 
 void parser_process_file(FILE *file, const s_cfg_parser *cfg_parser, s_table *table);
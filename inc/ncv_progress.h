@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_PROGRESS_H_
+#define INC_NCV_PROGRESS_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * The phases of an update of the table (filtering / searching, sorting and
+ * indexing the matches).
+ *****************************************************************************/
+
+enum e_phase {
+	E_PHASE_FILTER, E_PHASE_SORT, E_PHASE_INDEX
+};
+
+/******************************************************************************
+ * The structure is shared between the ui thread and a thread that does the
+ * filtering and sorting in the background. The background thread reports the
+ * current phase and the number of processed rows. The ui thread can set the
+ * cancel flag, which is checked by the background thread.
+ *
+ * All members are atomic, so no locking is necessary. The functions accept a
+ * NULL pointer, which is the case if the update runs in the ui thread.
+ *****************************************************************************/
+
+typedef struct s_progress {
+
+	atomic_bool cancelled;
+
+	atomic_int phase;
+
+	atomic_int done;
+
+	atomic_int total;
+
+	//
+	// The number of matches, that are indexed so far.
+	//
+	atomic_int found;
+
+} s_progress;
+
+/******************************************************************************
+ * The function is called by the background thread at the start of a phase.
+ *****************************************************************************/
+
+static inline void s_progress_phase(s_progress *progress, const enum e_phase phase, const int total) {
+
+	if (progress != NULL) {
+		atomic_store_explicit(&progress->phase, phase, memory_order_relaxed);
+		atomic_store_explicit(&progress->total, total, memory_order_relaxed);
+		atomic_store_explicit(&progress->done, 0, memory_order_relaxed);
+	}
+}
+
+/******************************************************************************
+ * The function checks whether the update was cancelled by the ui thread.
+ *****************************************************************************/
+
+static inline bool s_progress_is_cancelled(s_progress *progress) {
+	return progress != NULL && atomic_load_explicit(&progress->cancelled, memory_order_relaxed);
+}
+
+/******************************************************************************
+ * The function is called by the background thread with the number of
+ * processed rows. It returns true if the update was cancelled.
+ *****************************************************************************/
+
+static inline bool s_progress_step(s_progress *progress, const int done) {
+
+	if (progress == NULL) {
+		return false;
+	}
+
+	atomic_store_explicit(&progress->done, done, memory_order_relaxed);
+
+	return atomic_load_explicit(&progress->cancelled, memory_order_relaxed);
+}
+
+/******************************************************************************
+ * The function is called by the background thread with the number of matches,
+ * that are indexed so far.
+ *****************************************************************************/
+
+static inline void s_progress_found(s_progress *progress, const int found) {
+
+	if (progress != NULL) {
+		atomic_store_explicit(&progress->found, found, memory_order_relaxed);
+	}
+}
+
+#endif /* INC_NCV_PROGRESS_H_ */
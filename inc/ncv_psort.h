@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_PSORT_H_
+#define INC_NCV_PSORT_H_
+
+#include <stddef.h>
+
+/******************************************************************************
+ * The minimum number of elements of a run, that is sorted by a thread. Smaller
+ * arrays are sorted by the calling thread.
+ *****************************************************************************/
+
+#define PSORT_MIN_RUN 16384
+
+/******************************************************************************
+ * The maximum number of threads of a parallel sort.
+ *****************************************************************************/
+
+#define PSORT_MAX_THREADS 64
+
+/******************************************************************************
+ * The comparison function, which has the same signature as the comparison
+ * function of qsort_r.
+ *****************************************************************************/
+
+typedef int (*psort_cmp)(const void*, const void*, void*);
+
+int psort_threads();
+
+void psort_r(void *base, const size_t nmemb, const size_t size, psort_cmp cmp, void *arg, const int no_threads);
+
+#endif /* INC_NCV_PSORT_H_ */
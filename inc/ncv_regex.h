@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_REGEX_H_
+#define INC_NCV_REGEX_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * The s_regex struct is a compiled regular expression. The expression is
+ * compiled to a program for a non backtracking virtual machine. Matching is
+ * done with a lazily built DFA, where the DFA states are cached. Searching the
+ * position of a match is done with a simulation of the program (pike vm). In
+ * both cases the time is linear with the length of the string, so there are
+ * no pathological patterns.
+ *
+ * The supported syntax is:
+ *
+ * c          literal char             .          any char except new line
+ * \c         escaped char             \d \w \s   digit, word and space chars
+ * [a-z]      char class               [^a-z]     negated char class
+ * ^ $        start / end of string    ( )        group
+ * x|y        alternative              x* x+ x?   repetitions
+ * x{n,m}     bounded repetitions
+ *
+ * The struct is defined in the source file.
+ *****************************************************************************/
+
+typedef struct s_regex s_regex;
+
+s_regex* s_regex_create(const wchar_t *pattern, const bool case_insensitive);
+
+void s_regex_free(s_regex *regex);
+
+bool s_regex_matches(s_regex *regex, const wchar_t *str);
+
+wchar_t* s_regex_search(const s_regex *regex, const wchar_t *str, const size_t offset, size_t *len);
+
+#endif /* INC_NCV_REGEX_H_ */
@@ -0,0 +1,99 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_SAMPLE_H_
+#define INC_NCV_SAMPLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/******************************************************************************
+ * A row of the sample with its fields and its number in the csv file, which
+ * starts with 1.
+ *****************************************************************************/
+
+typedef struct s_sample_row {
+
+	long number;
+
+	wchar_t **fields;
+
+	int no_fields;
+
+	int size;
+
+} s_sample_row;
+
+/******************************************************************************
+ * The s_sample struct is a reservoir with a uniform random sample of the rows
+ * of a csv file, which is read as a stream. The first row is always part of
+ * the sample, because it may be the header. For each other row it is decided
+ * before the row is parsed, whether it is kept and which row of the
+ * reservoir it replaces. So the fields of a row that is not kept are not
+ * copied and the memory is bounded by the size of the reservoir.
+ *****************************************************************************/
+
+typedef struct s_sample {
+
+	//
+	// The number of rows of the reservoir and the number of rows, that are
+	// currently in the reservoir.
+	//
+	int size;
+
+	int no_rows;
+
+	s_sample_row *rows;
+
+	s_sample_row first;
+
+	//
+	// The number of rows, that were read so far.
+	//
+	long no_read;
+
+	//
+	// The row that is currently parsed, which is NULL if the row is not kept.
+	//
+	s_sample_row *current;
+
+	//
+	// The state of the xorshift random number generator.
+	//
+	uint64_t random;
+
+} s_sample;
+
+void s_sample_init(s_sample *sample, const int size, const uint64_t seed);
+
+void s_sample_free(s_sample *sample);
+
+void s_sample_start_row(s_sample *sample);
+
+void s_sample_add_field(s_sample *sample, const wchar_t *str);
+
+void s_sample_sort(s_sample *sample);
+
+#endif /* INC_NCV_SAMPLE_H_ */
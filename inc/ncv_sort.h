@@ -30,15 +30,31 @@
 #include <stdbool.h>
 
 /******************************************************************************
- * The s_sort struct contains the data necessary for the sorting.
+ * The maximum number of columns, that can be used for sorting.
  *****************************************************************************/
 
-typedef struct s_sort {
+#define SORT_MAX_KEYS 4
 
-	//
-	// The flag that indicates that the sorting is active.
-	//
-	bool is_active;
+/******************************************************************************
+ * The type of a sort key. An automatic key is sorted numerically, if all
+ * values of the column are numbers and as strings otherwise. A string key is
+ * always sorted as strings. A collation key is sorted with the collation of
+ * the locale (LC_COLLATE). A natural key compares the numbers in the strings
+ * by their values (host2 < host10).
+ *****************************************************************************/
+
+enum e_sort_type {
+	E_SORT_AUTO, E_SORT_STR, E_SORT_COLL, E_SORT_NAT
+};
+
+#define SORT_NO_TYPES 4
+
+/******************************************************************************
+ * The s_sort_key struct contains a column, that is used for sorting, with its
+ * direction and type.
+ *****************************************************************************/
+
+typedef struct s_sort_key {
 
 	//
 	// The column that should be used for sorting.
@@ -50,12 +66,88 @@ typedef struct s_sort {
 	//
 	enum e_direction direction;
 
+	//
+	// The type of the column values.
+	//
+	enum e_sort_type type;
+
+} s_sort_key;
+
+/******************************************************************************
+ * The s_sort struct contains the data necessary for the sorting. The rows are
+ * sorted by the first key. Rows with equal values are sorted by the next
+ * key. Rows that are equal for all keys keep the order of the file.
+ *****************************************************************************/
+
+typedef struct s_sort {
+
+	//
+	// The flag that indicates that the sorting is active.
+	//
+	bool is_active;
+
+	//
+	// The keys in the order of their priority.
+	//
+	int no_keys;
+
+	s_sort_key keys[SORT_MAX_KEYS];
+
 } s_sort;
 
 #define s_sort_is_active(s) ((s)->is_active)
 
+/******************************************************************************
+ * The s_sort_perm struct contains the sorted rows of a view of the table for
+ * a column. The rows are the indices of the rows in the unfiltered table
+ * without the header, sorted in forward direction. Rows with equal values
+ * have the same rank. The view is the id of the set of rows, that was sorted
+ * with the type.
+ *****************************************************************************/
+
+typedef struct s_sort_perm {
+
+	int view;
+
+	enum e_sort_type type;
+
+	int size;
+
+	int *rows;
+
+	int *ranks;
+
+	int no_ranks;
+
+} s_sort_perm;
+
+/******************************************************************************
+ * The s_sort_cache struct contains a permutation for each column and the last
+ * id, that was given to a view.
+ *****************************************************************************/
+
+typedef struct s_sort_cache {
+
+	int no_columns;
+
+	int last_view;
+
+	s_sort_perm *perms;
+
+} s_sort_cache;
+
+void s_sort_cache_init(s_sort_cache *cache, const int no_columns);
+
+void s_sort_cache_free(s_sort_cache *cache);
+
 bool s_sort_set_inactive(s_sort *sort, const bool uninit);
 
 bool s_sort_update(s_sort *sort, const int column, const enum e_direction direction);
 
+bool s_sort_add_key(s_sort *sort, const int column, const enum e_direction direction);
+
+bool s_sort_toggle_type(s_sort *sort, const int column);
+
+int s_sort_key_idx(const s_sort *sort, const int column);
+
 #endif /* INC_NCV_SORT_H_ */
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_SPANS_H_
+#define INC_NCV_SPANS_H_
+
+#include "ncv_filter.h"
+
+/******************************************************************************
+ * A span is a part of a line of a field that matches the filter and is
+ * highlighted. The start and the length are the number of chars.
+ *****************************************************************************/
+
+typedef struct s_span {
+
+	int line;
+
+	int start;
+
+	int len;
+
+} s_span;
+
+/******************************************************************************
+ * The spans of a field are computed once for a filter and are cached, so
+ * printing the field only has to switch the attributes at the span borders.
+ * The cache is direct mapped and the key is the pointer to the field content,
+ * which identifies the row and the column of the field. Each entry has the
+ * generation of the cache, which is incremented if the filter changed. So an
+ * entry with an other generation is outdated and recomputed on the next
+ * access.
+ *****************************************************************************/
+
+#define SPANS_CACHE_SIZE 1024
+
+typedef struct s_spans_entry {
+
+	//
+	// The key of the entry and the generation in which it was computed.
+	//
+	const wchar_t *field;
+
+	unsigned int generation;
+
+	//
+	// The spans of the field, ordered by line and start. The array grows on
+	// demand and is reused by an other field with the same hash.
+	//
+	s_span *spans;
+
+	int count;
+
+	int size;
+
+} s_spans_entry;
+
+typedef struct s_spans_cache {
+
+	unsigned int generation;
+
+	s_spans_entry entries[SPANS_CACHE_SIZE];
+
+} s_spans_cache;
+
+void s_spans_cache_init(s_spans_cache *cache);
+
+void s_spans_cache_free(s_spans_cache *cache);
+
+void s_spans_cache_invalidate(s_spans_cache *cache);
+
+const s_spans_entry* s_spans_cache_get(s_spans_cache *cache, const int column, const wchar_t *field, const s_filter *filter);
+
+#endif /* INC_NCV_SPANS_H_ */
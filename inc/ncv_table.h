@@ -28,6 +28,10 @@
 #include "ncv_sort.h"
 #include "ncv_filter.h"
 #include "ncv_cursor.h"
+#include "ncv_progress.h"
+#include "ncv_num.h"
+#include "ncv_blocks.h"
+#include "ncv_lru.h"
 #include "ncv_common.h"
 
 /******************************************************************************
@@ -67,7 +71,9 @@ typedef struct s_table {
 
 	//
 	// A two dimensional array with the fields of the csv file. The parameter
-	// __fields has the data, while fields has pointers to the row data.
+	// __fields has the data, while fields has pointers to the row data. The
+	// rows are allocated in one block, so the index of a row in the
+	// unfiltered table can be computed from the row pointer.
 	//
 	wchar_t ***__fields;
 
@@ -90,6 +96,66 @@ typedef struct s_table {
 	//
 	s_sort sort;
 
+	//
+	// The positions of the fields that match the filter in view order, which
+	// is row by row of the filtered and sorted table. The number of matches
+	// is the count of the filter, matches_size is the allocated size.
+	//
+	s_field *matches;
+
+	int matches_size;
+
+	//
+	// If the limit is greater than 0, the indexing of the matches of a search
+	// stops after the row, that reached the limit. In this case is_counting
+	// is set, which means that the count of the filter is only a lower
+	// bound, until the remaining matches are indexed.
+	//
+	int match_limit;
+
+	bool is_counting;
+
+	//
+	// An array with the parsed numerical values of each column. A column is
+	// parsed on demand and only once.
+	//
+	s_num_column *num_cache;
+
+	//
+	// The sorted rows of the columns, which are reused while the set of rows
+	// of the view is unchanged. The view is the id of the current set of
+	// rows. It is 0 for the unfiltered table and changes with each filtering.
+	// The cache is shared with the copy of the table of a background update.
+	//
+	s_sort_cache *sort_cache;
+
+	int view;
+
+	//
+	// The summaries of the blocks of rows, which are used to skip blocks
+	// that cannot match a filter. They are created after loading the table.
+	//
+	s_blocks blocks;
+
+	//
+	// The cache with the bitmaps of the rows, that matched recent filters.
+	// It is shared with the copy of the table of a background update.
+	//
+	s_lru *filter_cache;
+
+	//
+	// If the view of a filter was combined with the rows of an other filter,
+	// the bitmap contains the rows of the view. Otherwise it is empty.
+	//
+	s_bitmap combined;
+
+	//
+	// If the filtering and sorting is done in a background thread, the
+	// progress is reported here and the cancel flag is checked. In the ui
+	// thread the pointer is NULL.
+	//
+	s_progress *progress;
+
 } s_table;
 
 /******************************************************************************
@@ -108,6 +174,24 @@ typedef struct s_table {
 
 #define s_table_has_all_rows(t) ((t)->no_rows == (t)->__no_rows)
 
+/******************************************************************************
+ * The combinations of the current view of a filter with the rows of the
+ * previous filter (AND / OR) or with the rows that are not in the view (NOT).
+ *****************************************************************************/
+
+enum e_combine {
+	E_COMBINE_AND, E_COMBINE_OR, E_COMBINE_NOT
+};
+
+#define s_table_is_combined(t) ((t)->combined.no_chunks > 0)
+
+/******************************************************************************
+ * The macro returns the index of a row in the unfiltered table for a pointer
+ * to the row.
+ *****************************************************************************/
+
+#define s_table_row_idx(t, r) ((int) (((r) - (t)->__fields[0]) / (t)->no_columns))
+
 void s_table_init(s_table *table, const int no_columns, const int no_rows);
 
 void s_table_free(s_table *table);
@@ -124,8 +208,18 @@ void s_table_cursor_on_table(const s_table *table, const s_cursor *cursor);
 
 wchar_t* s_table_update_filter_sort(s_table *table, s_cursor *cursor, const bool filter_changed, const bool sort_changed);
 
+wchar_t* s_table_refine_filter(s_table *table, s_cursor *cursor);
+
+wchar_t* s_table_combine_filter(s_table *table, s_cursor *cursor, const enum e_combine combine);
+
+void s_table_count_matches(s_table *table);
+
+const s_num_column* s_table_num_column(s_table *table, const int column);
+
 bool s_table_prev_next(const s_table *table, s_cursor *cursor, const enum e_direction direction);
 
+int s_table_match_idx(const s_table *table, const s_cursor *cursor);
+
 void s_table_dump(const s_table *table);
 
 #define s_table_set_defaults(t) (t).show_header = true
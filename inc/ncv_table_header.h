@@ -45,4 +45,6 @@ double get_table_mean(const s_table *table, const int max_rows, const int column
 
 double get_table_std_dev(const s_table *table, const int max_rows, const int column, double (*fct_ptr)(const wchar_t *str), const double mean);
 
+bool check_column_type(const s_table *table, const int max_rows, const int column, const wchar_t decimal);
+
 #endif /* INC_NCV_TABLE_HEADER_H_ */
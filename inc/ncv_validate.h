@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INC_NCV_VALIDATE_H_
+#define INC_NCV_VALIDATE_H_
+
+#include "ncv_parser.h"
+
+#include <stdio.h>
+
+/******************************************************************************
+ * The size of the buffer, which is used to read the csv file.
+ *****************************************************************************/
+
+#define VALIDATE_BUF_SIZE 65536
+
+/******************************************************************************
+ * The result of a validation with the number of rows and the number of errors
+ * of each kind.
+ *****************************************************************************/
+
+typedef struct s_validate_result {
+
+	long no_rows;
+
+	long column_errors;
+
+	long quote_errors;
+
+	long char_errors;
+
+	long encoding_errors;
+
+} s_validate_result;
+
+#define s_validate_no_errors(r) ((r)->column_errors + (r)->quote_errors + (r)->char_errors + (r)->encoding_errors)
+
+void validate_file(FILE *file, const s_cfg_parser *cfg_parser, FILE *out, s_validate_result *result);
+
+#endif /* INC_NCV_VALIDATE_H_ */
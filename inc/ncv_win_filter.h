@@ -47,4 +47,10 @@ bool win_filter_process_input(s_filter *filter, const int key_type, const wint_t
 
 void win_filter_prepair_show();
 
+bool win_filter_is_live();
+
+bool win_filter_peek_filter(s_filter *filter);
+
+void win_filter_set_count(const int count, const bool is_counting);
+
 #endif
@@ -31,6 +31,10 @@ void win_footer_init();
 
 void win_footer_set_msg(wchar_t *message);
 
+void win_footer_set_progress(const s_progress *job_progress);
+
+void win_footer_set_counting(const s_progress *count_progress);
+
 void win_footer_resize();
 
 void win_footer_refresh_no();
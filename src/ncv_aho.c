@@ -0,0 +1,467 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_aho.h"
+#include "ncv_common.h"
+
+#include <string.h>
+#include <wctype.h>
+
+/******************************************************************************
+ * The number of chars, that have a direct entry in the transition table of
+ * the root node.
+ *****************************************************************************/
+
+#define AHO_ASCII 128
+
+#define AHO_ROOT 0
+
+/******************************************************************************
+ * A node of the automaton is a prefix of a pattern. The edges to the child
+ * nodes are stored in the edge arrays of the automaton, sorted by the chars,
+ * starting with the index: first.
+ *
+ * The failure link points to the node of the longest proper suffix of the
+ * prefix, the dictionary link points to the next node on the failure path,
+ * that is a complete pattern.
+ *****************************************************************************/
+
+typedef struct s_aho_node {
+
+	int fail;
+
+	int dict;
+
+	//
+	// The index of the pattern that ends at this node or -1.
+	//
+	int pattern;
+
+	int depth;
+
+	int first;
+
+	int count;
+
+} s_aho_node;
+
+/******************************************************************************
+ * The definition of the automaton. The root has an additional table with the
+ * transitions for the ASCII chars, because most of the chars of a string
+ * start from the root.
+ *****************************************************************************/
+
+struct s_aho {
+
+	bool case_insensitive;
+
+	s_aho_node *nodes;
+
+	int no_nodes;
+
+	wchar_t *edge_chars;
+
+	int *edge_targets;
+
+	int root[AHO_ASCII];
+
+	//
+	// A copy of the patterns, the node of each pattern and the number of
+	// occurrences of the nodes that are patterns.
+	//
+	wchar_t **patterns;
+
+	int *pattern_nodes;
+
+	int no_patterns;
+
+	int *node_counts;
+};
+
+/******************************************************************************
+ * The function folds a char, if the search is case insensitive.
+ *****************************************************************************/
+
+static inline wchar_t aho_fold(const s_aho *aho, const wchar_t chr) {
+	return aho->case_insensitive ? (wchar_t) towlower((wint_t) chr) : chr;
+}
+
+/******************************************************************************
+ * The function returns the child of a node for a char or -1 if the node has
+ * no such edge. The edges are sorted, so a binary search is used.
+ *****************************************************************************/
+
+static int aho_goto(const s_aho *aho, const int node, const wchar_t chr) {
+	int lo = aho->nodes[node].first;
+	int hi = lo + aho->nodes[node].count - 1;
+	int mid;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+
+		if (aho->edge_chars[mid] == chr) {
+			return aho->edge_targets[mid];
+		}
+
+		if (aho->edge_chars[mid] < chr) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return -1;
+}
+
+/******************************************************************************
+ * The function returns the next state of the automaton for a (folded) char.
+ * If the node has no edge for the char, the failure links are followed.
+ *****************************************************************************/
+
+static int aho_next(const s_aho *aho, int node, const wchar_t chr) {
+	int next;
+
+	while (node != AHO_ROOT) {
+
+		if ((next = aho_goto(aho, node, chr)) >= 0) {
+			return next;
+		}
+
+		node = aho->nodes[node].fail;
+	}
+
+	if ((unsigned) chr < AHO_ASCII) {
+		return aho->root[chr];
+	}
+
+	next = aho_goto(aho, AHO_ROOT, chr);
+
+	return next >= 0 ? next : AHO_ROOT;
+}
+
+/******************************************************************************
+ * The function returns the node of the longest pattern, that ends at the
+ * given node, or -1 if there is none.
+ *****************************************************************************/
+
+static inline int aho_output(const s_aho *aho, const int node) {
+	return aho->nodes[node].pattern >= 0 ? node : aho->nodes[node].dict;
+}
+
+/******************************************************************************
+ * The function sorts the edges of a node by their chars. The number of edges
+ * is small, so an insertion sort is used.
+ *****************************************************************************/
+
+static void aho_sort_edges(s_aho *aho, const int first, const int count) {
+	wchar_t chr;
+	int target, j;
+
+	for (int i = first + 1; i < first + count; i++) {
+		chr = aho->edge_chars[i];
+		target = aho->edge_targets[i];
+
+		for (j = i - 1; j >= first && aho->edge_chars[j] > chr; j--) {
+			aho->edge_chars[j + 1] = aho->edge_chars[j];
+			aho->edge_targets[j + 1] = aho->edge_targets[j];
+		}
+
+		aho->edge_chars[j + 1] = chr;
+		aho->edge_targets[j + 1] = target;
+	}
+}
+
+/******************************************************************************
+ * The function creates the automaton for the patterns. First a trie of the
+ * patterns is created, with the children of a node as a linked list. Then
+ * the nodes are processed in breadth first order, which creates the sorted
+ * edges and the failure and dictionary links. The function returns NULL if
+ * there is no pattern or a pattern is empty.
+ *****************************************************************************/
+
+s_aho* s_aho_create(wchar_t **patterns, const int no_patterns, const bool case_insensitive) {
+	int node, child;
+	wchar_t chr;
+
+	size_t total = 0;
+
+	for (int i = 0; i < no_patterns; i++) {
+		const size_t len = wcslen(patterns[i]);
+
+		if (len == 0) {
+			log_debug("Pattern: %d is empty", i);
+			return NULL;
+		}
+
+		total += len;
+	}
+
+	if (no_patterns == 0) {
+		log_debug_str("No patterns!");
+		return NULL;
+	}
+
+	const int max_nodes = (int) total + 1;
+
+	s_aho *aho = xmalloc(sizeof(s_aho));
+
+	aho->case_insensitive = case_insensitive;
+	aho->nodes = xmalloc(sizeof(s_aho_node) * max_nodes);
+
+	aho->no_patterns = no_patterns;
+	aho->patterns = xmalloc(sizeof(wchar_t*) * no_patterns);
+	aho->pattern_nodes = xmalloc(sizeof(int) * no_patterns);
+
+	//
+	// The trie with the children as linked lists.
+	//
+	int *tmp_first = xmalloc(sizeof(int) * max_nodes);
+	int *tmp_next = xmalloc(sizeof(int) * max_nodes);
+	wchar_t *tmp_chars = xmalloc(sizeof(wchar_t) * max_nodes);
+
+	tmp_first[AHO_ROOT] = -1;
+	aho->nodes[AHO_ROOT].pattern = -1;
+	aho->nodes[AHO_ROOT].depth = 0;
+	aho->no_nodes = 1;
+
+	for (int i = 0; i < no_patterns; i++) {
+		node = AHO_ROOT;
+
+		for (const wchar_t *ptr = patterns[i]; *ptr != W_STR_TERM; ptr++) {
+			chr = aho_fold(aho, *ptr);
+
+			for (child = tmp_first[node]; child >= 0 && tmp_chars[child] != chr; child = tmp_next[child]) {
+				;
+			}
+
+			if (child < 0) {
+				child = aho->no_nodes++;
+
+				tmp_chars[child] = chr;
+				tmp_first[child] = -1;
+				tmp_next[child] = tmp_first[node];
+				tmp_first[node] = child;
+
+				aho->nodes[child].pattern = -1;
+				aho->nodes[child].depth = aho->nodes[node].depth + 1;
+			}
+
+			node = child;
+		}
+
+		//
+		// For duplicate patterns, the node has the first pattern.
+		//
+		if (aho->nodes[node].pattern < 0) {
+			aho->nodes[node].pattern = i;
+		}
+
+		aho->pattern_nodes[i] = node;
+
+		aho->patterns[i] = xmalloc(sizeof(wchar_t) * (wcslen(patterns[i]) + 1));
+		wcscpy(aho->patterns[i], patterns[i]);
+	}
+
+	//
+	// Process the nodes in breadth first order. The failure link of a node
+	// points to a node with a lower depth, which is already processed.
+	//
+	aho->edge_chars = xmalloc(sizeof(wchar_t) * aho->no_nodes);
+	aho->edge_targets = xmalloc(sizeof(int) * aho->no_nodes);
+
+	int *queue = xmalloc(sizeof(int) * aho->no_nodes);
+	int head = 0, tail = 0, no_edges = 0;
+
+	queue[tail++] = AHO_ROOT;
+
+	aho->nodes[AHO_ROOT].fail = AHO_ROOT;
+	aho->nodes[AHO_ROOT].dict = -1;
+
+	while (head < tail) {
+		node = queue[head++];
+
+		s_aho_node *current = &aho->nodes[node];
+
+		current->first = no_edges;
+
+		for (child = tmp_first[node]; child >= 0; child = tmp_next[child]) {
+			aho->edge_chars[no_edges] = tmp_chars[child];
+			aho->edge_targets[no_edges] = child;
+			no_edges++;
+
+			queue[tail++] = child;
+		}
+
+		current->count = no_edges - current->first;
+
+		aho_sort_edges(aho, current->first, current->count);
+
+		if (node == AHO_ROOT) {
+
+			for (int i = 0; i < AHO_ASCII; i++) {
+				aho->root[i] = AHO_ROOT;
+			}
+
+			for (int i = current->first; i < current->first + current->count; i++) {
+				if ((unsigned) aho->edge_chars[i] < AHO_ASCII) {
+					aho->root[aho->edge_chars[i]] = aho->edge_targets[i];
+				}
+			}
+		}
+
+		for (int i = current->first; i < current->first + current->count; i++) {
+			s_aho_node *next = &aho->nodes[aho->edge_targets[i]];
+
+			next->fail = node == AHO_ROOT ? AHO_ROOT : aho_next(aho, current->fail, aho->edge_chars[i]);
+			next->dict = aho_output(aho, next->fail);
+		}
+	}
+
+	free(queue);
+	free(tmp_chars);
+	free(tmp_next);
+	free(tmp_first);
+
+	aho->node_counts = xmalloc(sizeof(int) * aho->no_nodes);
+	s_aho_reset_counts(aho);
+
+	log_debug("Patterns: %d nodes: %d", no_patterns, aho->no_nodes);
+
+	return aho;
+}
+
+/******************************************************************************
+ * The function frees the automaton.
+ *****************************************************************************/
+
+void s_aho_free(s_aho *aho) {
+
+	for (int i = 0; i < aho->no_patterns; i++) {
+		free(aho->patterns[i]);
+	}
+
+	free(aho->patterns);
+	free(aho->pattern_nodes);
+	free(aho->node_counts);
+
+	free(aho->edge_chars);
+	free(aho->edge_targets);
+	free(aho->nodes);
+
+	free(aho);
+}
+
+/******************************************************************************
+ * The functions return the number of patterns and a pattern.
+ *****************************************************************************/
+
+int s_aho_no_patterns(const s_aho *aho) {
+	return aho->no_patterns;
+}
+
+const wchar_t* s_aho_pattern(const s_aho *aho, const int idx) {
+	return aho->patterns[idx];
+}
+
+/******************************************************************************
+ * The function checks whether the string contains one of the patterns. It
+ * stops with the first occurrence.
+ *****************************************************************************/
+
+bool s_aho_matches(const s_aho *aho, const wchar_t *str) {
+	int node = AHO_ROOT;
+
+	for (const wchar_t *ptr = str; *ptr != W_STR_TERM; ptr++) {
+		node = aho_next(aho, node, aho_fold(aho, *ptr));
+
+		if (aho_output(aho, node) >= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function searches the first occurrence of a pattern, starting at the
+ * offset. The first occurrence is the one that ends first, if several
+ * patterns end at the same char, the longest is returned. The function
+ * returns a pointer to the start of the occurrence and sets its length, or
+ * returns NULL if there is no occurrence.
+ *****************************************************************************/
+
+wchar_t* s_aho_search(const s_aho *aho, const wchar_t *str, const size_t offset, size_t *len) {
+	int node = AHO_ROOT;
+	int out;
+
+	for (const wchar_t *ptr = str + offset; *ptr != W_STR_TERM; ptr++) {
+		node = aho_next(aho, node, aho_fold(aho, *ptr));
+
+		if ((out = aho_output(aho, node)) >= 0) {
+			*len = (size_t) aho->nodes[out].depth;
+			return (wchar_t*) ptr - aho->nodes[out].depth + 1;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function resets the counts of the occurrences of the patterns.
+ *****************************************************************************/
+
+void s_aho_reset_counts(s_aho *aho) {
+	memset(aho->node_counts, 0, sizeof(int) * aho->no_nodes);
+}
+
+/******************************************************************************
+ * The function counts the occurrences of all patterns in the string, with a
+ * single scan. Overlapping occurrences are counted. The function returns the
+ * number of occurrences in the string.
+ *****************************************************************************/
+
+int s_aho_count(s_aho *aho, const wchar_t *str) {
+	int node = AHO_ROOT;
+	int total = 0;
+
+	for (const wchar_t *ptr = str; *ptr != W_STR_TERM; ptr++) {
+		node = aho_next(aho, node, aho_fold(aho, *ptr));
+
+		for (int out = aho_output(aho, node); out >= 0; out = aho->nodes[out].dict) {
+			aho->node_counts[out]++;
+			total++;
+		}
+	}
+
+	return total;
+}
+
+/******************************************************************************
+ * The function returns the number of occurrences of a pattern, since the
+ * last reset. Duplicate patterns have the same count.
+ *****************************************************************************/
+
+int s_aho_get_count(const s_aho *aho, const int idx) {
+	return aho->node_counts[aho->pattern_nodes[idx]];
+}
@@ -0,0 +1,377 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_bitmap.h"
+#include "ncv_common.h"
+
+#include <string.h>
+
+/******************************************************************************
+ * The function returns the number of set bits of the words of a chunk.
+ *****************************************************************************/
+
+static int words_count(const uint64_t *words) {
+	int count = 0;
+
+	for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+		count += __builtin_popcountll(words[i]);
+	}
+
+	return count;
+}
+
+/******************************************************************************
+ * The function expands a chunk to the bit set of the chunk. If the chunk is
+ * NULL, the bit set is empty.
+ *****************************************************************************/
+
+static void chunk_to_words(const s_bitmap_chunk *chunk, uint64_t *words) {
+
+	if (chunk != NULL && chunk->words != NULL) {
+		memcpy(words, chunk->words, sizeof(uint64_t) * BITMAP_CHUNK_WORDS);
+		return;
+	}
+
+	memset(words, 0, sizeof(uint64_t) * BITMAP_CHUNK_WORDS);
+
+	if (chunk != NULL) {
+		for (int i = 0; i < chunk->cardinality; i++) {
+			s_bits_set(words, chunk->array[i]);
+		}
+	}
+}
+
+/******************************************************************************
+ * The function adds a chunk with the bit set to the end of the bitmap. The
+ * chunk is stored as an array or as a bit set, depending on the number of
+ * indices. An empty chunk is not added.
+ *****************************************************************************/
+
+static void bitmap_add_chunk(s_bitmap *bitmap, const int key, const uint64_t *words) {
+	uint64_t word;
+	int idx = 0;
+
+	const int cardinality = words_count(words);
+
+	if (cardinality == 0) {
+		return;
+	}
+
+	bitmap->chunks = xrealloc(bitmap->chunks, sizeof(s_bitmap_chunk) * (bitmap->no_chunks + 1));
+
+	s_bitmap_chunk *chunk = &bitmap->chunks[bitmap->no_chunks++];
+
+	chunk->key = key;
+	chunk->cardinality = cardinality;
+
+	if (cardinality > BITMAP_ARRAY_MAX) {
+		chunk->array = NULL;
+		chunk->words = xmalloc(sizeof(uint64_t) * BITMAP_CHUNK_WORDS);
+		memcpy(chunk->words, words, sizeof(uint64_t) * BITMAP_CHUNK_WORDS);
+
+	} else {
+		chunk->words = NULL;
+		chunk->array = xmalloc(sizeof(uint16_t) * cardinality);
+
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+			for (word = words[i]; word != 0; word &= word - 1) {
+				chunk->array[idx++] = (uint16_t) (i * 64 + __builtin_ctzll(word));
+			}
+		}
+	}
+
+	bitmap->cardinality += cardinality;
+}
+
+/******************************************************************************
+ * The function returns the chunk with the key or NULL if the bitmap has no
+ * such chunk.
+ *****************************************************************************/
+
+static const s_bitmap_chunk* bitmap_get_chunk(const s_bitmap *bitmap, const int key) {
+	int low = 0;
+	int high = bitmap->no_chunks - 1;
+	int mid;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+
+		if (bitmap->chunks[mid].key == key) {
+			return &bitmap->chunks[mid];
+		}
+
+		if (bitmap->chunks[mid].key < key) {
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function initializes an empty bitmap.
+ *****************************************************************************/
+
+void s_bitmap_init(s_bitmap *bitmap) {
+
+	bitmap->chunks = NULL;
+	bitmap->no_chunks = 0;
+	bitmap->cardinality = 0;
+}
+
+/******************************************************************************
+ * The function frees the chunks of the bitmap, which is empty afterwards.
+ *****************************************************************************/
+
+void s_bitmap_free(s_bitmap *bitmap) {
+
+	for (int i = 0; i < bitmap->no_chunks; i++) {
+		free(bitmap->chunks[i].array);
+		free(bitmap->chunks[i].words);
+	}
+
+	free(bitmap->chunks);
+
+	s_bitmap_init(bitmap);
+}
+
+/******************************************************************************
+ * The function creates a bitmap from a plain bit set with a number of bits.
+ * The bitmap is initialized by the function.
+ *****************************************************************************/
+
+void s_bitmap_from_bits(s_bitmap *bitmap, const uint64_t *bits, const int no_bits) {
+	uint64_t words[BITMAP_CHUNK_WORDS];
+
+	s_bitmap_init(bitmap);
+
+	const int no_words = s_bits_words(no_bits);
+
+	for (int start = 0; start < no_words; start += BITMAP_CHUNK_WORDS) {
+		const int len = no_words - start < BITMAP_CHUNK_WORDS ? no_words - start : BITMAP_CHUNK_WORDS;
+
+		memcpy(words, bits + start, sizeof(uint64_t) * len);
+		memset(words + len, 0, sizeof(uint64_t) * (BITMAP_CHUNK_WORDS - len));
+
+		bitmap_add_chunk(bitmap, start / BITMAP_CHUNK_WORDS, words);
+	}
+}
+
+/******************************************************************************
+ * The function expands the bitmap to a plain bit set with a number of bits.
+ * Indices that are not smaller than the number of bits are ignored.
+ *****************************************************************************/
+
+void s_bitmap_to_bits(const s_bitmap *bitmap, uint64_t *bits, const int no_bits) {
+	int idx;
+
+	memset(bits, 0, sizeof(uint64_t) * s_bits_words(no_bits));
+
+	for (int i = 0; i < bitmap->no_chunks; i++) {
+		const s_bitmap_chunk *chunk = &bitmap->chunks[i];
+		const int base = chunk->key << BITMAP_CHUNK_SHIFT;
+
+		if (chunk->words != NULL) {
+
+			for (int j = 0; j < BITMAP_CHUNK_WORDS && (base >> 6) + j < s_bits_words(no_bits); j++) {
+				bits[(base >> 6) + j] = chunk->words[j];
+			}
+
+		} else {
+
+			for (int j = 0; j < chunk->cardinality; j++) {
+				if ((idx = base + chunk->array[j]) < no_bits) {
+					s_bits_set(bits, idx);
+				}
+			}
+		}
+	}
+
+	//
+	// Clear the bits of the last word, that are not part of the bit set.
+	//
+	if (no_bits % 64 != 0) {
+		bits[no_bits / 64] &= (UINT64_C(1) << (no_bits % 64)) - 1;
+	}
+}
+
+/******************************************************************************
+ * The function checks whether the bitmap contains an index.
+ *****************************************************************************/
+
+bool s_bitmap_contains(const s_bitmap *bitmap, const int idx) {
+	int low, high, mid;
+
+	const s_bitmap_chunk *chunk = bitmap_get_chunk(bitmap, idx >> BITMAP_CHUNK_SHIFT);
+
+	if (chunk == NULL) {
+		return false;
+	}
+
+	const uint16_t value = (uint16_t) (idx & (BITMAP_CHUNK_BITS - 1));
+
+	if (chunk->words != NULL) {
+		return s_bits_get(chunk->words, value);
+	}
+
+	low = 0;
+	high = chunk->cardinality - 1;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+
+		if (chunk->array[mid] == value) {
+			return true;
+		}
+
+		if (chunk->array[mid] < value) {
+			low = mid + 1;
+		} else {
+			high = mid - 1;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function combines two bitmaps chunk by chunk. Chunks, that cannot
+ * contribute to the result, are skipped, for example the chunks that are
+ * only in one of the bitmaps for an AND. The result is initialized by the
+ * function.
+ *****************************************************************************/
+
+void s_bitmap_combine(s_bitmap *result, const s_bitmap *bitmap_1, const s_bitmap *bitmap_2, const enum e_bitmap_op op) {
+	uint64_t words_1[BITMAP_CHUNK_WORDS];
+	uint64_t words_2[BITMAP_CHUNK_WORDS];
+	const s_bitmap_chunk *chunk_1, *chunk_2;
+	int key;
+
+	s_bitmap_init(result);
+
+	int idx_1 = 0;
+	int idx_2 = 0;
+
+	while (idx_1 < bitmap_1->no_chunks || idx_2 < bitmap_2->no_chunks) {
+
+		//
+		// Get the chunks with the smallest key.
+		//
+		chunk_1 = idx_1 < bitmap_1->no_chunks ? &bitmap_1->chunks[idx_1] : NULL;
+		chunk_2 = idx_2 < bitmap_2->no_chunks ? &bitmap_2->chunks[idx_2] : NULL;
+
+		if (chunk_1 != NULL && (chunk_2 == NULL || chunk_1->key <= chunk_2->key)) {
+			key = chunk_1->key;
+		} else {
+			key = chunk_2->key;
+		}
+
+		if (chunk_1 != NULL && chunk_1->key == key) {
+			idx_1++;
+		} else {
+			chunk_1 = NULL;
+		}
+
+		if (chunk_2 != NULL && chunk_2->key == key) {
+			idx_2++;
+		} else {
+			chunk_2 = NULL;
+		}
+
+		if ((op == E_BITMAP_AND && (chunk_1 == NULL || chunk_2 == NULL)) || (op == E_BITMAP_AND_NOT && chunk_1 == NULL)) {
+			continue;
+		}
+
+		chunk_to_words(chunk_1, words_1);
+		chunk_to_words(chunk_2, words_2);
+
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+
+			switch (op) {
+
+			case E_BITMAP_AND:
+				words_1[i] &= words_2[i];
+				break;
+
+			case E_BITMAP_OR:
+				words_1[i] |= words_2[i];
+				break;
+
+			case E_BITMAP_AND_NOT:
+				words_1[i] &= ~words_2[i];
+				break;
+			}
+		}
+
+		bitmap_add_chunk(result, key, words_1);
+	}
+}
+
+/******************************************************************************
+ * The function creates the complement of a bitmap, with the indices that are
+ * smaller than the number of bits. The result is initialized by the
+ * function.
+ *****************************************************************************/
+
+void s_bitmap_not(s_bitmap *result, const s_bitmap *bitmap, const int no_bits) {
+	uint64_t words[BITMAP_CHUNK_WORDS];
+
+	s_bitmap_init(result);
+
+	for (int key = 0; (key << BITMAP_CHUNK_SHIFT) < no_bits; key++) {
+
+		chunk_to_words(bitmap_get_chunk(bitmap, key), words);
+
+		for (int i = 0; i < BITMAP_CHUNK_WORDS; i++) {
+			words[i] = ~words[i];
+		}
+
+		//
+		// Clear the bits of the last chunk, that are not part of the bitmap.
+		//
+		const int len = no_bits - (key << BITMAP_CHUNK_SHIFT);
+
+		for (int i = len; i < BITMAP_CHUNK_BITS; i++) {
+			words[i >> 6] &= ~(UINT64_C(1) << (i & 63));
+		}
+
+		bitmap_add_chunk(result, key, words);
+	}
+}
+
+/******************************************************************************
+ * The function returns the number of bytes, that are allocated by the bitmap.
+ *****************************************************************************/
+
+size_t s_bitmap_size(const s_bitmap *bitmap) {
+	size_t size = sizeof(s_bitmap_chunk) * bitmap->no_chunks;
+
+	for (int i = 0; i < bitmap->no_chunks; i++) {
+		size += bitmap->chunks[i].words != NULL ? sizeof(uint64_t) * BITMAP_CHUNK_WORDS : sizeof(uint16_t) * bitmap->chunks[i].cardinality;
+	}
+
+	return size;
+}
@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_blocks.h"
+#include "ncv_common.h"
+
+#include <string.h>
+#include <wctype.h>
+
+/******************************************************************************
+ * The functions return the bit of a char and the bit of a bigram in the bloom
+ * filter. The chars are folded to lower case, so the summaries can be used
+ * for case sensitive and case insensitive searches.
+ *****************************************************************************/
+
+static inline wchar_t block_fold(const wchar_t chr) {
+	return (wchar_t) towlower((wint_t) chr);
+}
+
+static inline int block_char_bit(const wchar_t chr) {
+	return (int) (((uint64_t) chr * UINT64_C(11400714819323198485)) >> 58);
+}
+
+static inline int block_bigram_bit(const wchar_t chr_1, const wchar_t chr_2) {
+	const uint64_t hash = ((uint64_t) (uint32_t) chr_1 << 32 | (uint32_t) chr_2) * UINT64_C(11400714819323198485);
+
+	return (int) (hash >> (64 - 10));
+}
+
+/******************************************************************************
+ * The function initializes an empty s_blocks struct.
+ *****************************************************************************/
+
+void s_blocks_init(s_blocks *blocks) {
+
+	blocks->no_blocks = 0;
+	blocks->no_columns = 0;
+	blocks->summaries = NULL;
+}
+
+/******************************************************************************
+ * The function creates the summaries of the blocks for the rows of the table,
+ * which is done once after loading the table.
+ *****************************************************************************/
+
+void s_blocks_create(s_blocks *blocks, wchar_t ***rows, const int no_rows, const int no_columns) {
+	s_block_summary *summary;
+	wchar_t prev, chr;
+	int bit;
+
+	blocks->no_blocks = s_blocks_count(no_rows);
+	blocks->no_columns = no_columns;
+
+	if (blocks->no_blocks == 0) {
+		blocks->summaries = NULL;
+		return;
+	}
+
+	const size_t size = sizeof(s_block_summary) * blocks->no_blocks * no_columns;
+
+	blocks->summaries = xmalloc(size);
+	memset(blocks->summaries, 0, size);
+
+	for (int row = 0; row < no_rows; row++) {
+		for (int column = 0; column < no_columns; column++) {
+
+			summary = &blocks->summaries[s_blocks_of_row(row) * no_columns + column];
+			prev = W_STR_TERM;
+
+			for (const wchar_t *ptr = rows[row][column]; *ptr != W_STR_TERM; ptr++) {
+				chr = block_fold(*ptr);
+
+				summary->chars |= UINT64_C(1) << block_char_bit(chr);
+
+				if (prev != W_STR_TERM) {
+					bit = block_bigram_bit(prev, chr);
+					summary->bigrams[bit >> 6] |= UINT64_C(1) << (bit & 63);
+				}
+
+				prev = chr;
+			}
+		}
+	}
+
+	log_debug("Blocks: %d columns: %d", blocks->no_blocks, no_columns);
+}
+
+/******************************************************************************
+ * The function frees the summaries.
+ *****************************************************************************/
+
+void s_blocks_free(s_blocks *blocks) {
+
+	free(blocks->summaries);
+
+	s_blocks_init(blocks);
+}
+
+/******************************************************************************
+ * The function checks whether a field of a column of a block may contain the
+ * string. If it returns false, no field contains the string, independent of
+ * the case. If there are no summaries, the function returns true.
+ *****************************************************************************/
+
+bool s_blocks_may_contain(const s_blocks *blocks, const int block, const int column, const wchar_t *str) {
+	wchar_t prev, chr;
+	int bit;
+
+	if (block >= blocks->no_blocks) {
+		return true;
+	}
+
+	const s_block_summary *summary = &blocks->summaries[block * blocks->no_columns + column];
+
+	prev = W_STR_TERM;
+
+	for (const wchar_t *ptr = str; *ptr != W_STR_TERM; ptr++) {
+		chr = block_fold(*ptr);
+
+		if ((summary->chars & (UINT64_C(1) << block_char_bit(chr))) == 0) {
+			return false;
+		}
+
+		if (prev != W_STR_TERM) {
+			bit = block_bigram_bit(prev, chr);
+
+			if ((summary->bigrams[bit >> 6] & (UINT64_C(1) << (bit & 63))) == 0) {
+				return false;
+			}
+		}
+
+		prev = chr;
+	}
+
+	return true;
+}
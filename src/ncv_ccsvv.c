@@ -32,6 +32,7 @@
 
 #include "ncv_ui_loop.h"
 #include "ncv_parser.h"
+#include "ncv_validate.h"
 #include "ncv_ncurses.h"
 #include "ncv_common.h"
 
@@ -127,6 +128,33 @@ void process_csv_file(const s_cfg_parser *cfg_parser, s_table *table) {
 	}
 }
 
+/******************************************************************************
+ * The function validates the csv file, without showing it. The errors and a
+ * summary are written to stdout. The program exits with EXIT_SUCCESS if the
+ * file is valid and EXIT_FAILURE otherwise.
+ *****************************************************************************/
+
+static void validate_csv_file(const s_cfg_parser *cfg_parser) {
+	FILE *file = stdin;
+	s_validate_result result;
+
+	if (cfg_parser->filename != NULL && (file = fopen(cfg_parser->filename, "r")) == NULL) {
+		log_exit("Unable to open file %s due to: %s", cfg_parser->filename, strerror(errno));
+	}
+
+	validate_file(file, cfg_parser, stdout, &result);
+
+	if (file != stdin && fclose(file) != 0) {
+		log_exit("Unable to close the file due to: %s", strerror(errno));
+	}
+
+	const long no_errors = s_validate_no_errors(&result);
+
+	printf("%s: rows: %ld errors: %ld\n", cfg_parser->filename != NULL ? cfg_parser->filename : "<STDIN>", result.no_rows, no_errors);
+
+	exit(no_errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
 /******************************************************************************
  * The function writes the program usage. It is called with an error flag.
  * Depending on the flag the stream (stdout / stderr) is selected. The function
@@ -190,6 +218,19 @@ static void print_usage(const bool has_error, const char *msg) {
 	fprintf(stream, "           as  a  header for the table (-s) or not (-n). If none of the flags\n");
 	fprintf(stream, "           is given ccsvv tries to detect whether a header is present or not.\n");
 	fprintf(stream, "\n");
+	fprintf(stream, "    -r [rows], --sample [rows]\n");
+	fprintf(stream, "           Shows a uniform random sample with the given number of rows and the\n");
+	fprintf(stream, "           first row, which may be the header. The csv data is read as a stream\n");
+	fprintf(stream, "           and only the rows of the sample are stored, so huge files can be\n");
+	fprintf(stream, "           viewed. The first column contains the number of the row in the data.\n");
+	fprintf(stream, "\n");
+	fprintf(stream, "    -V, --validate\n");
+	fprintf(stream, "           Validates  the csv data without showing it. The data is read as a\n");
+	fprintf(stream, "           stream and each error is written with its byte offset: rows with a\n");
+	fprintf(stream, "           different number of columns than the first row, missing quotes,\n");
+	fprintf(stream, "           chars after a closing quote and encoding errors. The exit status\n");
+	fprintf(stream, "           is 0 if the data is valid.\n");
+	fprintf(stream, "\n");
 	fprintf(stream, "    -t, --trim\n");
 	fprintf(stream, "           Switch off trimming of csv fields.\n");
 	fprintf(stream, "\n");
@@ -201,17 +242,48 @@ static void print_usage(const bool has_error, const char *msg) {
 	fprintf(stream, "\n");
 	fprintf(stream, "    ^H     Shows a help dialog.\n");
 	fprintf(stream, "\n");
-	fprintf(stream, "    ^F, /  Shows a filter / search dialog.\n");
+	fprintf(stream, "    ^F, /  Shows a filter / search dialog. The filter / search can be\n");
+	fprintf(stream, "           restricted to a set of columns, with a comma separated list of\n");
+	fprintf(stream, "           column numbers or ranges, like: 2,5-7. If the regex checkbox is\n");
+	fprintf(stream, "           checked, the string is a regular expression, which supports:\n");
+	fprintf(stream, "           . [a-z] [^a-z] \\d \\w \\s ^ $ ( ) | * + ? {n,m}\n");
+	fprintf(stream, "           If the fuzzy checkbox is checked, fields match that contain the\n");
+	fprintf(stream, "           string with a few errors (1 for 4 - 7 chars, 2 for 8 - 11, else 3).\n");
+	fprintf(stream, "           If the multi checkbox is checked, the string is a list of patterns,\n");
+	fprintf(stream, "           like: id1|id2|id3 or a file with one pattern per line: @ids.txt\n");
+	fprintf(stream, "           The footer shows the number of matches of each pattern.\n");
+	fprintf(stream, "           If the expr checkbox is checked, the string is a boolean expression\n");
+	fprintf(stream, "           with column predicates, like: status=FAIL AND latency>500 AND NOT\n");
+	fprintf(stream, "           host~test. The operators are: = != ~ (contains) !~ < <= > >= AND\n");
+	fprintf(stream, "           OR NOT ( ) and a column is a 1-based number or a header name.\n");
+	fprintf(stream, "           A numeric range is: latency BETWEEN 500 AND 1000. Dates are\n");
+	fprintf(stream, "           compared with ISO dates: created>=2026-10-16.\n");
+	fprintf(stream, "           If the live checkbox is checked, the table is filtered while typing\n");
+	fprintf(stream, "           and the number of matches is shown in the dialog.\n");
 	fprintf(stream, "\n");
 	fprintf(stream, "    ^X     Deletes the filter / search string in the dialog.\n");
 	fprintf(stream, "\n");
-	fprintf(stream, "    ESC    Deletes the filter / search string and resets the table.\n");
+	fprintf(stream, "    ESC    Deletes the filter / search string and resets the table. While a\n");
+	fprintf(stream, "           filter / search or a sorting is in progress, it is cancelled.\n");
 	fprintf(stream, "\n");
 	fprintf(stream, "    ^N, ^P Searches for the next (^N) / previous (^P) field that contains the\n");
 	fprintf(stream, "           filter / search string.\n");
 	fprintf(stream, "\n");
 	fprintf(stream, "    ^S, ^R Sorts  the  table  with  the  current  column  in ascending (^S) /\n");
 	fprintf(stream, "           descending (^R) order.\n");
+	fprintf(stream, "\n");
+	fprintf(stream, "    >, <   Adds the current column as the next sort key in ascending (>) /\n");
+	fprintf(stream, "           descending (<) order. Rows with equal values are sorted by the\n");
+	fprintf(stream, "           next key. Adding a key again with the same order removes it.\n");
+	fprintf(stream, "\n");
+	fprintf(stream, "    ^T     Toggles the sorting of the current column between numeric (if\n");
+	fprintf(stream, "           all values are numbers or dates), text, the collation of the\n");
+	fprintf(stream, "           locale (LC_COLLATE) and natural (host2 before host10, v1.9\n");
+	fprintf(stream, "           before v1.10).\n");
+	fprintf(stream, "\n");
+	fprintf(stream, "    &, |, ! Combines the rows of the current filter with the rows of the\n");
+	fprintf(stream, "           previous filter (& both, | one of them) or shows the rows that\n");
+	fprintf(stream, "           do not match (!).\n");
 
 	exit(status);
 }
@@ -223,12 +295,14 @@ static void print_usage(const bool has_error, const char *msg) {
 
 int main(const int argc, char *const argv[]) {
 	int c;
+	long sample;
+	char *end;
 	bool monochrom = false;
 
 	//
 	// Create a default parser configuration.
 	//
-	s_cfg_parser cfg_parser = (s_cfg_parser ) { .filename = NULL, .delim = W_DELIM, .do_trim = true, .strict = false };
+	s_cfg_parser cfg_parser = (s_cfg_parser ) { .filename = NULL, .delim = W_DELIM, .do_trim = true, .strict = false, .sample = 0 };
 
 	//
 	// Import the locale from the environment to allow proper wchar_t's.
@@ -239,6 +313,8 @@ int main(const int argc, char *const argv[]) {
 
 	bool detect_header = true;
 
+	bool do_validate = false;
+
 	int option_index = 0;
 
 	const struct option long_options[] =
@@ -250,6 +326,8 @@ int main(const int argc, char *const argv[]) {
 	          {"monochrom",   no_argument,       0, 'm'},
 			  {"no-header",   no_argument,       0, 'n'},
 			  {"show-header", no_argument,       0, 's'},
+			  {"sample",      required_argument, 0, 'r'},
+			  {"validate",    no_argument,       0, 'V'},
 	          {"trim",        no_argument,       0, 't'},
 	          {0, 0, 0, 0}
 	        };
@@ -257,7 +335,7 @@ int main(const int argc, char *const argv[]) {
 			//
 			// Parse the command line options.
 			//
-	while ((c = getopt_long(argc, argv, "cd:hmnst", long_options, &option_index)) != -1) {
+	while ((c = getopt_long(argc, argv, "cd:hmnr:stV", long_options, &option_index)) != -1) {
 		switch (c) {
 
 		case 'c':
@@ -301,6 +379,21 @@ int main(const int argc, char *const argv[]) {
 			detect_header = false;
 			break;
 
+		case 'r':
+
+			//
+			// Ensure that the number of rows is a positive number.
+			//
+			errno = 0;
+			sample = strtol(optarg, &end, 10);
+
+			if (errno != 0 || *end != '\0' || sample <= 0 || sample > SAMPLE_MAX_ROWS) {
+				print_usage(true, "The number of rows of the sample is not valid!");
+			}
+
+			cfg_parser.sample = (int) sample;
+			break;
+
 		case 's':
 			table.show_header = true;
 			detect_header = false;
@@ -310,6 +403,10 @@ int main(const int argc, char *const argv[]) {
 			cfg_parser.do_trim = false;
 			break;
 
+		case 'V':
+			do_validate = true;
+			break;
+
 		default:
 			print_usage(true, "Unknown option found!");
 		}
@@ -337,6 +434,13 @@ int main(const int argc, char *const argv[]) {
 		log_exit_str("Unable to register signal function for signal: SIGUSR1");
 	}
 
+	//
+	// The validation does not return.
+	//
+	if (do_validate) {
+		validate_csv_file(&cfg_parser);
+	}
+
 	//
 	// Process the csv file
 	//
@@ -349,6 +453,15 @@ int main(const int argc, char *const argv[]) {
 		table.show_header = s_table_has_header(&table);
 	}
 
+	//
+	// The first column of a sample has the numbers of the rows. If the first
+	// row is the header, the number is replaced by a label.
+	//
+	if (cfg_parser.sample > 0 && table.show_header && table.__no_rows > 0) {
+		free(table.__fields[0][0]);
+		s_table_copy(&table, 0, 0, L"Row");
+	}
+
 #ifdef DEBUG
 	s_table_dump(&table);
 #endif
@@ -47,6 +47,22 @@ void* xmalloc(const size_t size) {
 	return ptr;
 }
 
+/******************************************************************************
+ * The function reallocates memory and terminates the program in case of an
+ * error.
+ *****************************************************************************/
+
+void* xrealloc(void *ptr, const size_t size) {
+
+	void *result = realloc(ptr, size);
+
+	if (result == NULL) {
+		log_exit("Unable to reallocate: %zu bytes of memory!", size);
+	}
+
+	return result;
+}
+
 /******************************************************************************
  * The function reads a wchar_t from a stream. It converts the different line
  * endings (windows: \r\n mac: \r) to a standard (unix: \n). It also does error
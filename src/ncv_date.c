@@ -0,0 +1,360 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_date.h"
+#include "ncv_common.h"
+
+#include <wctype.h>
+
+/******************************************************************************
+ * The names of the months, which can be abbreviated to the first three chars.
+ *****************************************************************************/
+
+static const wchar_t *month_names[12] = { L"january", L"february", L"march", L"april", L"may", L"june", L"july", L"august", L"september",
+		L"october", L"november", L"december" };
+
+#define MONTH_ABBR_LEN 3
+
+/******************************************************************************
+ * The formats, that are tried to detect the format of a column. Ambiguous
+ * numerical dates are day first, unless the sample contains a day that is
+ * greater than 12 at the second position.
+ *****************************************************************************/
+
+static const s_date_fmt date_fmts[] = {
+
+{ E_DATE_YMD, L'-' }, { E_DATE_YMD, L'/' }, { E_DATE_DMY, L'.' }, { E_DATE_DMY, L'/' }, { E_DATE_MDY, L'/' },
+
+{ E_DATE_DMY, L'-' }, { E_DATE_MDY, L'-' }, { E_DATE_MON_D_Y, L' ' }, { E_DATE_D_MON_Y, L' ' }, { E_DATE_D_MON_Y, L'-' } };
+
+#define NO_DATE_FMTS ((int) (sizeof(date_fmts) / sizeof(date_fmts[0])))
+
+#define is_digit(c) ((c) >= L'0' && (c) <= L'9')
+
+/******************************************************************************
+ * The function computes the number of days since 1970-01-01 for a date of the
+ * proleptic gregorian calendar. (See: Howard Hinnant, days_from_civil)
+ *****************************************************************************/
+
+static int64_t days_from_civil(int year, const int month, const int day) {
+
+	year -= month <= 2;
+
+	const int era = (year >= 0 ? year : year - 399) / 400;
+	const int yoe = year - era * 400;
+	const int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return (int64_t) era * 146097 + doe - 719468;
+}
+
+/******************************************************************************
+ * The function returns the number of days of a month.
+ *****************************************************************************/
+
+static int days_of_month(const int year, const int month) {
+	static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) {
+		return 29;
+	}
+
+	return days[month - 1];
+}
+
+/******************************************************************************
+ * The function computes the seconds since 1970-01-01 00:00:00 for a date and
+ * a time. The time zone is ignored.
+ *****************************************************************************/
+
+int64_t s_date_epoch(const int year, const int month, const int day, const int hour, const int min, const int sec) {
+	return days_from_civil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+/******************************************************************************
+ * The function parses an unsigned integer with a minimum and a maximum
+ * number of digits. The integer is not allowed to be followed by a digit.
+ *****************************************************************************/
+
+static bool parse_int(const wchar_t **ptr, const int min_len, const int max_len, int *value) {
+	int len;
+
+	*value = 0;
+
+	for (len = 0; len < max_len && is_digit(**ptr); len++, (*ptr)++) {
+		*value = 10 * *value + (**ptr - L'0');
+	}
+
+	return len >= min_len && !is_digit(**ptr);
+}
+
+/******************************************************************************
+ * The function parses the name of a month, which is case insensitive. It is
+ * the full name or the first three chars, which can be followed by a dot.
+ *****************************************************************************/
+
+static bool parse_month(const wchar_t **ptr, int *month) {
+	const wchar_t *end;
+	size_t len;
+
+	for (int i = 0; i < 12; i++) {
+
+		if (wcsncasecmp(*ptr, month_names[i], MONTH_ABBR_LEN) != 0) {
+			continue;
+		}
+
+		end = *ptr + MONTH_ABBR_LEN;
+
+		for (len = MONTH_ABBR_LEN; iswalpha((wint_t) *end); len++, end++) {
+			if ((wchar_t) towlower((wint_t) *end) != month_names[i][len]) {
+				return false;
+			}
+		}
+
+		if (len == MONTH_ABBR_LEN) {
+			if (*end == L'.') {
+				end++;
+			}
+
+		} else if (month_names[i][len] != W_STR_TERM) {
+			return false;
+		}
+
+		*ptr = end;
+		*month = i + 1;
+
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function skips a separator, if it is the next char.
+ *****************************************************************************/
+
+static bool parse_sep(const wchar_t **ptr, const wchar_t sep) {
+
+	if (**ptr != sep) {
+		return false;
+	}
+
+	(*ptr)++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses the optional time after a date: HH:MM, HH:MM:SS or
+ * HH:MM:SS.fff where the fraction of the seconds is ignored. The time is
+ * separated with a space or a 'T'.
+ *****************************************************************************/
+
+static bool parse_time(const wchar_t **ptr, int *hour, int *min, int *sec) {
+
+	if ((**ptr != L' ' && **ptr != L'T') || !is_digit((*ptr)[1])) {
+		return true;
+	}
+
+	(*ptr)++;
+
+	if (!parse_int(ptr, 1, 2, hour) || !parse_sep(ptr, L':') || !parse_int(ptr, 2, 2, min)) {
+		return false;
+	}
+
+	if (parse_sep(ptr, L':')) {
+
+		if (!parse_int(ptr, 2, 2, sec)) {
+			return false;
+		}
+
+		if (parse_sep(ptr, L'.')) {
+			while (is_digit(**ptr)) {
+				(*ptr)++;
+			}
+		}
+	}
+
+	return *hour <= 23 && *min <= 59 && *sec <= 60;
+}
+
+/******************************************************************************
+ * The function parses a date with an optional time with a given format and
+ * computes the seconds since 1970-01-01. Leading and trailing white spaces
+ * are ignored. The function returns false if the string is not a valid date
+ * with that format.
+ *****************************************************************************/
+
+bool s_date_parse(const s_date_fmt *fmt, const wchar_t *str, int64_t *epoch) {
+	int year, month, day;
+	int hour = 0, min = 0, sec = 0;
+	bool result;
+
+	const wchar_t *ptr = str;
+
+	while (iswspace((wint_t) *ptr)) {
+		ptr++;
+	}
+
+	switch (fmt->order) {
+
+	case E_DATE_YMD:
+		result = parse_int(&ptr, 4, 4, &year) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 1, 2, &month) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 1, 2, &day);
+		break;
+
+	case E_DATE_DMY:
+		result = parse_int(&ptr, 1, 2, &day) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 1, 2, &month) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 4, 4, &year);
+		break;
+
+	case E_DATE_MDY:
+		result = parse_int(&ptr, 1, 2, &month) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 1, 2, &day) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 4, 4, &year);
+		break;
+
+	case E_DATE_MON_D_Y:
+		result = parse_month(&ptr, &month) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 1, 2, &day);
+
+		//
+		// The day can be followed by a comma: Oct 16, 2026
+		//
+		if (result) {
+			parse_sep(&ptr, L',');
+			result = parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 4, 4, &year);
+		}
+		break;
+
+	case E_DATE_D_MON_Y:
+		result = parse_int(&ptr, 1, 2, &day) && parse_sep(&ptr, fmt->sep) && parse_month(&ptr, &month) && parse_sep(&ptr, fmt->sep) && parse_int(&ptr, 4, 4, &year);
+		break;
+
+	default:
+		log_exit("Unknown date order: %d", fmt->order);
+	}
+
+	if (!result || !parse_time(&ptr, &hour, &min, &sec)) {
+		return false;
+	}
+
+	while (iswspace((wint_t) *ptr)) {
+		ptr++;
+	}
+
+	if (*ptr != W_STR_TERM || month < 1 || month > 12 || day < 1 || day > days_of_month(year, month)) {
+		return false;
+	}
+
+	*epoch = s_date_epoch(year, month, day, hour, min, sec);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses a date in the ISO format: 2026-10-16 or
+ * 2026-10-16 14:03:59.
+ *****************************************************************************/
+
+bool s_date_parse_iso(const wchar_t *str, int64_t *epoch) {
+	return s_date_parse(&date_fmts[0], str, epoch);
+}
+
+/******************************************************************************
+ * The function removes the formats from the candidates, that do not parse the
+ * string.
+ *****************************************************************************/
+
+static unsigned int narrow_candidates(unsigned int candidates, const wchar_t *str) {
+	int64_t epoch;
+
+	for (int i = 0; i < NO_DATE_FMTS; i++) {
+		if (((candidates >> i) & 1) && !s_date_parse(&date_fmts[i], str, &epoch)) {
+			candidates &= ~(1u << i);
+		}
+	}
+
+	return candidates;
+}
+
+/******************************************************************************
+ * The function detects the date format of a column with a sample of at most
+ * DATE_SAMPLE rows, which are spread over the rows from first to last
+ * (exclusive). Empty fields are ignored. The format is the first format, that
+ * parses all fields of the sample. The bits of all formats, that parse the
+ * sample, are returned as candidates, so the format can be narrowed with a
+ * field that is not part of the sample. The function returns false if there
+ * is no such format or if all fields are empty.
+ *****************************************************************************/
+
+bool s_date_detect(wchar_t ***rows, const int first, const int last, const int col, unsigned int *candidates, s_date_fmt *fmt) {
+	bool has_values = false;
+
+	//
+	// The bits of the formats, that parsed all fields so far.
+	//
+	*candidates = (1u << NO_DATE_FMTS) - 1;
+
+	const int step = last - first > DATE_SAMPLE ? (last - first) / DATE_SAMPLE : 1;
+
+	for (int row = first; row < last && *candidates != 0; row += step) {
+
+		if (wcs_is_empty(rows[row][col])) {
+			continue;
+		}
+
+		has_values = true;
+
+		*candidates = narrow_candidates(*candidates, rows[row][col]);
+	}
+
+	if (!has_values || *candidates == 0) {
+		return false;
+	}
+
+	*fmt = date_fmts[__builtin_ctz(*candidates)];
+
+	log_debug("Column: %d date order: %d separator: '%lc'", col, fmt->order, (wint_t) fmt->sep);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function narrows the candidates of s_date_detect() with a field, that
+ * was not parsed with the current format. The format is the first of the
+ * remaining candidates. A day first date, like 01/02/2026, is ambiguous, so
+ * a later field like 10/13/2026 can switch the format to month first. The
+ * function returns false if no candidate is left.
+ *****************************************************************************/
+
+bool s_date_narrow(unsigned int *candidates, const wchar_t *str, s_date_fmt *fmt) {
+
+	*candidates = narrow_candidates(*candidates, str);
+
+	if (*candidates == 0) {
+		return false;
+	}
+
+	*fmt = date_fmts[__builtin_ctz(*candidates)];
+
+	log_debug("Narrowed date order: %d separator: '%lc'", fmt->order, (wint_t) fmt->sep);
+
+	return true;
+}
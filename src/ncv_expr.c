@@ -0,0 +1,1009 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_expr.h"
+#include "ncv_common.h"
+
+#include <math.h>
+#include <wctype.h>
+
+/******************************************************************************
+ * The maximum nesting of parenthesis and NOT operators.
+ *****************************************************************************/
+
+#define EXPR_MAX_DEPTH 32
+
+/******************************************************************************
+ * The relative costs of the predicates. A predicate that is not restricted to
+ * a column has to check each column, so its costs are multiplied by the number
+ * of columns.
+ *****************************************************************************/
+
+#define COST_EQ 1
+
+#define COST_CONTAINS 2
+
+#define COST_NUM 4
+
+/******************************************************************************
+ * The definitions of the nodes of the predicate tree. A not equals predicate
+ * (!=) is compiled to a NOT node with an equals predicate, the same is true
+ * for: !~
+ *****************************************************************************/
+
+enum e_expr_type {
+	EXPR_AND, EXPR_OR, EXPR_NOT, EXPR_PRED
+};
+
+enum e_expr_op {
+	EXPR_EQ, EXPR_CONTAINS, EXPR_LT, EXPR_LE, EXPR_GT, EXPR_GE, EXPR_BETWEEN
+};
+
+typedef struct s_expr_node {
+
+	enum e_expr_type type;
+
+	//
+	// The operator, the 0-based column and the value of a predicate. A
+	// column of -1 means that any column can match. A numeric comparison is
+	// a range of values, which is stored in the ranges array of the
+	// expression.
+	//
+	enum e_expr_op op;
+
+	int column;
+
+	wchar_t *value;
+
+	int range;
+
+	//
+	// A predicate is positive, if it is not negated by a NOT. The fields
+	// that match a positive predicate are highlighted.
+	//
+	bool is_positive;
+
+	//
+	// The estimated costs of the evaluation of the node.
+	//
+	int cost;
+
+	//
+	// The children of an AND, OR or NOT node, which are stored in the
+	// children array of the expression.
+	//
+	int first;
+
+	int count;
+
+} s_expr_node;
+
+/******************************************************************************
+ * The definition of the compiled expression.
+ *****************************************************************************/
+
+struct s_expr {
+
+	bool case_insensitive;
+
+	int no_columns;
+
+	s_expr_node *nodes;
+
+	int no_nodes;
+
+	int *children;
+
+	int no_children;
+
+	s_num_range *ranges;
+
+	int no_ranges;
+
+	int root;
+};
+
+/******************************************************************************
+ * The parser is a recursive descent parser with the following grammar:
+ *
+ * or      := and ( OR and )*
+ * and     := not ( [AND] not )*
+ * not     := NOT not | primary
+ * primary := '(' or ')' | value [ op value | BETWEEN value AND value ]
+ *****************************************************************************/
+
+typedef struct s_expr_parser {
+
+	//
+	// The current position in the expression string.
+	//
+	const wchar_t *ptr;
+
+	s_expr *expr;
+
+	//
+	// The header row of the table, which is used to resolve column names.
+	// It is NULL if the table has no header.
+	//
+	wchar_t **header;
+
+	int depth;
+
+	bool error;
+
+} s_expr_parser;
+
+/******************************************************************************
+ * The function adds a node to the expression and returns its index.
+ *****************************************************************************/
+
+static int node_create(s_expr *expr, const enum e_expr_type type) {
+
+	expr->nodes = xrealloc(expr->nodes, sizeof(s_expr_node) * (expr->no_nodes + 1));
+
+	s_expr_node *node = &expr->nodes[expr->no_nodes];
+
+	node->type = type;
+	node->op = EXPR_EQ;
+	node->column = -1;
+	node->value = NULL;
+	node->range = -1;
+	node->is_positive = false;
+	node->cost = 0;
+	node->first = 0;
+	node->count = 0;
+
+	return expr->no_nodes++;
+}
+
+/******************************************************************************
+ * The function adds an AND, OR or NOT node with the given children. The
+ * children are ordered by their costs, so cheap children are evaluated first.
+ * This is possible, because the evaluation has no side effects.
+ *****************************************************************************/
+
+static int node_create_list(s_expr *expr, const enum e_expr_type type, int *list, const int count) {
+	int tmp, j;
+
+	//
+	// Insertion sort, which is stable and the lists are short.
+	//
+	for (int i = 1; i < count; i++) {
+		tmp = list[i];
+
+		for (j = i; j > 0 && expr->nodes[list[j - 1]].cost > expr->nodes[tmp].cost; j--) {
+			list[j] = list[j - 1];
+		}
+
+		list[j] = tmp;
+	}
+
+	const int idx = node_create(expr, type);
+
+	expr->children = xrealloc(expr->children, sizeof(int) * (expr->no_children + count));
+
+	expr->nodes[idx].first = expr->no_children;
+	expr->nodes[idx].count = count;
+
+	for (int i = 0; i < count; i++) {
+		expr->children[expr->no_children++] = list[i];
+		expr->nodes[idx].cost += expr->nodes[list[i]].cost;
+	}
+
+	return idx;
+}
+
+/******************************************************************************
+ * The function skips the white spaces of the expression.
+ *****************************************************************************/
+
+static void skip_spaces(s_expr_parser *parser) {
+
+	while (iswspace((wint_t) *parser->ptr)) {
+		parser->ptr++;
+	}
+}
+
+/******************************************************************************
+ * The function checks whether a char ends an unquoted value.
+ *****************************************************************************/
+
+static inline bool is_value_end(const wchar_t chr) {
+	return chr == W_STR_TERM || iswspace((wint_t) chr) || wcschr(L"()=!~<>", chr) != NULL;
+}
+
+/******************************************************************************
+ * The function checks whether the parser is at the given keyword. The keyword
+ * is case insensitive and has to be followed by the end of a value. If the
+ * keyword is found, it is skipped.
+ *****************************************************************************/
+
+static bool parse_keyword(s_expr_parser *parser, const wchar_t *keyword) {
+
+	skip_spaces(parser);
+
+	const size_t len = wcslen(keyword);
+
+	if (wcsncasecmp(parser->ptr, keyword, len) != 0 || !is_value_end(parser->ptr[len])) {
+		return false;
+	}
+
+	parser->ptr += len;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses a value, which is a quoted string or a sequence of chars
+ * up to a white space, a parenthesis or an operator. The function returns an
+ * allocated string or NULL on an error.
+ *****************************************************************************/
+
+static wchar_t* parse_value(s_expr_parser *parser) {
+	const wchar_t *start;
+	size_t len;
+
+	skip_spaces(parser);
+
+	if (*parser->ptr == W_QUOTE) {
+		start = ++parser->ptr;
+
+		while (*parser->ptr != W_QUOTE) {
+
+			if (*parser->ptr == W_STR_TERM) {
+				log_debug_str("Missing closing quote!");
+				return NULL;
+			}
+
+			parser->ptr++;
+		}
+
+		len = parser->ptr++ - start;
+
+	} else {
+		start = parser->ptr;
+
+		while (!is_value_end(*parser->ptr)) {
+			parser->ptr++;
+		}
+
+		len = parser->ptr - start;
+
+		if (len == 0) {
+			log_debug("Missing value: %ls", start);
+			return NULL;
+		}
+	}
+
+	wchar_t *value = xmalloc(sizeof(wchar_t) * (len + 1));
+	wmemcpy(value, start, len);
+	value[len] = W_STR_TERM;
+
+	return value;
+}
+
+/******************************************************************************
+ * The function parses an operator. It returns false if there is no operator.
+ * The negated flag is set for the operators: != !~
+ *****************************************************************************/
+
+static bool parse_op(s_expr_parser *parser, enum e_expr_op *op, bool *negated) {
+
+	skip_spaces(parser);
+
+	*negated = false;
+
+	switch (*parser->ptr) {
+
+	case L'=':
+		*op = EXPR_EQ;
+		break;
+
+	case L'~':
+		*op = EXPR_CONTAINS;
+		break;
+
+	case L'!':
+		*negated = true;
+
+		if (parser->ptr[1] == L'=') {
+			*op = EXPR_EQ;
+
+		} else if (parser->ptr[1] == L'~') {
+			*op = EXPR_CONTAINS;
+
+		} else {
+			return false;
+		}
+
+		parser->ptr++;
+		break;
+
+	case L'<':
+	case L'>':
+		if (parser->ptr[1] == L'=') {
+			*op = *parser->ptr == L'<' ? EXPR_LE : EXPR_GE;
+			parser->ptr++;
+
+		} else {
+			*op = *parser->ptr == L'<' ? EXPR_LT : EXPR_GT;
+		}
+		break;
+
+	default:
+		return false;
+	}
+
+	parser->ptr++;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function converts a string to a number. The whole string has to be a
+ * number, surrounding white spaces are allowed. A date in the ISO format is
+ * converted to the seconds since 1970-01-01, which are the values of a date
+ * column.
+ *****************************************************************************/
+
+static bool parse_num(const wchar_t *str, double *num) {
+	const wchar_t *end;
+	int64_t epoch;
+
+	if (s_date_parse_iso(str, &epoch)) {
+		*num = (double) epoch;
+		return true;
+	}
+
+	//
+	// Use the same parser as the column values, so both are equal.
+	//
+	if (!s_num_parse(str, num, &end)) {
+		return false;
+	}
+
+	while (iswspace((wint_t) *end)) {
+		end++;
+	}
+
+	return *end == W_STR_TERM;
+}
+
+/******************************************************************************
+ * The function resolves a column, which is a 1-based column number or the
+ * name of a header column. It returns the 0-based column index or -1 if the
+ * column is unknown.
+ *****************************************************************************/
+
+static int parse_column(const s_expr_parser *parser, const wchar_t *name) {
+	wchar_t *end;
+
+	const long num = wcstol(name, &end, 10);
+
+	if (end != name && *end == W_STR_TERM) {
+		return (num >= 1 && num <= parser->expr->no_columns) ? (int) num - 1 : -1;
+	}
+
+	if (parser->header != NULL) {
+
+		for (int i = 0; i < parser->expr->no_columns; i++) {
+
+			if (wcscasecmp(parser->header[i], name) == 0) {
+				return i;
+			}
+		}
+	}
+
+	return -1;
+}
+
+/******************************************************************************
+ * The function adds a range for a numeric comparison of a column to the
+ * expression and returns its index.
+ *****************************************************************************/
+
+static int range_create(s_expr *expr, const int column, const enum e_expr_op op, const double min, const double max) {
+
+	expr->ranges = xrealloc(expr->ranges, sizeof(s_num_range) * (expr->no_ranges + 1));
+
+	s_num_range *range = &expr->ranges[expr->no_ranges];
+
+	switch (op) {
+
+	case EXPR_LT:
+		s_num_range_init(range, column, -INFINITY, true, min, false);
+		break;
+
+	case EXPR_LE:
+		s_num_range_init(range, column, -INFINITY, true, min, true);
+		break;
+
+	case EXPR_GT:
+		s_num_range_init(range, column, min, false, INFINITY, true);
+		break;
+
+	case EXPR_GE:
+		s_num_range_init(range, column, min, true, INFINITY, true);
+		break;
+
+	default:
+		s_num_range_init(range, column, min, true, max, true);
+		break;
+	}
+
+	return expr->no_ranges++;
+}
+
+/******************************************************************************
+ * The function parses the numeric values of a comparison or a between
+ * predicate and creates the range of the predicate.
+ *****************************************************************************/
+
+static bool parse_range(s_expr_parser *parser, s_expr_node *node) {
+	double min, max = 0;
+
+	if (!parse_num(node->value, &min)) {
+		log_debug("Not a number: %ls", node->value);
+		return false;
+	}
+
+	if (node->op == EXPR_BETWEEN) {
+
+		if (!parse_keyword(parser, L"AND")) {
+			log_debug("Missing AND: %ls", parser->ptr);
+			return false;
+		}
+
+		wchar_t *value = parse_value(parser);
+
+		const bool result = value != NULL && parse_num(value, &max);
+
+		free(value);
+
+		if (!result) {
+			log_debug("Not a number: %ls", parser->ptr);
+			return false;
+		}
+	}
+
+	node->range = range_create(parser->expr, node->column, node->op, min, max);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses a predicate, which is a value or a column, an operator
+ * and a value.
+ *****************************************************************************/
+
+static int parse_predicate(s_expr_parser *parser) {
+	enum e_expr_op op = EXPR_BETWEEN;
+	bool negated = false;
+
+	wchar_t *value = parse_value(parser);
+
+	if (value == NULL) {
+		parser->error = true;
+		return -1;
+	}
+
+	const int idx = node_create(parser->expr, EXPR_PRED);
+	s_expr_node *node = &parser->expr->nodes[idx];
+
+	//
+	// A value without an operator is searched in all columns.
+	//
+	if (!parse_keyword(parser, L"BETWEEN") && !parse_op(parser, &op, &negated)) {
+		node->op = EXPR_CONTAINS;
+		node->value = value;
+		node->cost = COST_CONTAINS * parser->expr->no_columns;
+
+		return idx;
+	}
+
+	node->op = op;
+	node->column = parse_column(parser, value);
+
+	if (node->column < 0) {
+		log_debug("Unknown column: %ls", value);
+		free(value);
+		parser->error = true;
+		return -1;
+	}
+
+	free(value);
+
+	node->value = parse_value(parser);
+
+	if (node->value == NULL) {
+		parser->error = true;
+		return -1;
+	}
+
+	//
+	// The values of a comparison have to be numbers.
+	//
+	if (op == EXPR_EQ) {
+		node->cost = COST_EQ;
+
+	} else if (op == EXPR_CONTAINS) {
+		node->cost = COST_CONTAINS;
+
+	} else if (parse_range(parser, node)) {
+		node->cost = COST_NUM;
+
+	} else {
+		parser->error = true;
+		return -1;
+	}
+
+	if (!negated) {
+		return idx;
+	}
+
+	int list[] = { idx };
+
+	return node_create_list(parser->expr, EXPR_NOT, list, 1);
+}
+
+static int parse_or(s_expr_parser *parser);
+
+/******************************************************************************
+ * The function parses a NOT, an expression in parenthesis or a predicate.
+ *****************************************************************************/
+
+static int parse_not(s_expr_parser *parser) {
+	int idx;
+
+	if (++parser->depth > EXPR_MAX_DEPTH) {
+		log_debug_str("Expression is too deep!");
+		parser->error = true;
+		return -1;
+	}
+
+	if (parse_keyword(parser, L"NOT")) {
+
+		int list[] = { parse_not(parser) };
+
+		idx = parser->error ? -1 : node_create_list(parser->expr, EXPR_NOT, list, 1);
+
+	} else if (*parser->ptr == L'(') {
+		parser->ptr++;
+
+		idx = parse_or(parser);
+
+		skip_spaces(parser);
+
+		if (*parser->ptr == L')') {
+			parser->ptr++;
+
+		} else if (!parser->error) {
+			log_debug("Missing closing parenthesis: %ls", parser->ptr);
+			parser->error = true;
+		}
+
+	} else if (parse_keyword(parser, L"AND") || parse_keyword(parser, L"OR")) {
+		log_debug("Unexpected operator: %ls", parser->ptr);
+		parser->error = true;
+		idx = -1;
+
+	} else {
+		idx = parse_predicate(parser);
+	}
+
+	parser->depth--;
+
+	return idx;
+}
+
+/******************************************************************************
+ * The function parses a list of operands, which are combined with AND or OR.
+ * If the list has only one operand, no node is created. For AND lists, the
+ * keyword is optional.
+ *****************************************************************************/
+
+static int parse_list(s_expr_parser *parser, const enum e_expr_type type) {
+	int size = 4;
+	int count = 0;
+	int idx;
+
+	int *list = xmalloc(sizeof(int) * size);
+
+	while (true) {
+		idx = type == EXPR_OR ? parse_list(parser, EXPR_AND) : parse_not(parser);
+
+		if (parser->error) {
+			break;
+		}
+
+		if (count == size) {
+			size *= 2;
+			list = xrealloc(list, sizeof(int) * size);
+		}
+
+		list[count++] = idx;
+
+		//
+		// Check if the list is finished.
+		//
+		if (type == EXPR_OR) {
+
+			if (!parse_keyword(parser, L"OR")) {
+				break;
+			}
+
+		} else {
+			skip_spaces(parser);
+
+			const wchar_t *ptr = parser->ptr;
+
+			if (*ptr == W_STR_TERM || *ptr == L')' || parse_keyword(parser, L"OR")) {
+				parser->ptr = ptr;
+				break;
+			}
+
+			parse_keyword(parser, L"AND");
+		}
+	}
+
+	if (!parser->error && count > 1) {
+		idx = node_create_list(parser->expr, type, list, count);
+	}
+
+	free(list);
+
+	return parser->error ? -1 : idx;
+}
+
+static int parse_or(s_expr_parser *parser) {
+	return parse_list(parser, EXPR_OR);
+}
+
+/******************************************************************************
+ * The function marks the predicates that are not negated.
+ *****************************************************************************/
+
+static void mark_positive(s_expr *expr, const int idx, const bool is_positive) {
+	s_expr_node *node = &expr->nodes[idx];
+
+	if (node->type == EXPR_PRED) {
+		node->is_positive = is_positive;
+		return;
+	}
+
+	for (int i = 0; i < node->count; i++) {
+		mark_positive(expr, expr->children[node->first + i], node->type == EXPR_NOT ? !is_positive : is_positive);
+	}
+}
+
+/******************************************************************************
+ * The function compiles an expression. The header is used to resolve column
+ * names and can be NULL. If the expression is not valid, the function returns
+ * NULL.
+ *****************************************************************************/
+
+s_expr* s_expr_create(const wchar_t *str, const bool case_insensitive, wchar_t **header, const int no_columns) {
+
+	s_expr *expr = xmalloc(sizeof(s_expr));
+
+	expr->case_insensitive = case_insensitive;
+	expr->no_columns = no_columns;
+	expr->nodes = NULL;
+	expr->no_nodes = 0;
+	expr->children = NULL;
+	expr->no_children = 0;
+	expr->ranges = NULL;
+	expr->no_ranges = 0;
+
+	s_expr_parser parser;
+	parser.ptr = str;
+	parser.expr = expr;
+	parser.header = header;
+	parser.depth = 0;
+	parser.error = false;
+
+	expr->root = parse_or(&parser);
+
+	//
+	// A closing parenthesis without an opening one stops the parsing.
+	//
+	skip_spaces(&parser);
+
+	if (!parser.error && *parser.ptr != W_STR_TERM) {
+		log_debug("Unexpected: %ls", parser.ptr);
+		parser.error = true;
+	}
+
+	if (parser.error) {
+		log_debug("Unable to compile: %ls", str);
+		s_expr_free(expr);
+		return NULL;
+	}
+
+	mark_positive(expr, expr->root, true);
+
+	log_debug("Expression: %ls nodes: %d costs: %d", str, expr->no_nodes, expr->nodes[expr->root].cost);
+
+	return expr;
+}
+
+/******************************************************************************
+ * The function frees the compiled expression.
+ *****************************************************************************/
+
+void s_expr_free(s_expr *expr) {
+
+	for (int i = 0; i < expr->no_nodes; i++) {
+		free(expr->nodes[i].value);
+	}
+
+	for (int i = 0; i < expr->no_ranges; i++) {
+		s_num_range_free(&expr->ranges[i]);
+	}
+
+	free(expr->nodes);
+	free(expr->children);
+	free(expr->ranges);
+	free(expr);
+}
+
+/******************************************************************************
+ * The function checks whether a field matches a predicate. For a numeric
+ * comparison the bitmap of the range is used, if it was applied to the parsed
+ * column and the index of the row is known (not negative). Otherwise the field
+ * is parsed.
+ *****************************************************************************/
+
+static bool pred_matches(const s_expr *expr, const s_expr_node *node, const wchar_t *str, const int row_idx) {
+	const wchar_t *suffix;
+	int64_t epoch;
+	bool is_bool;
+	double num;
+
+	switch (node->op) {
+
+	case EXPR_EQ:
+		return (expr->case_insensitive ? wcscasecmp(str, node->value) : wcscmp(str, node->value)) == 0;
+
+	case EXPR_CONTAINS:
+		return (expr->case_insensitive ? wcs_casestr(str, node->value) : wcsstr(str, node->value)) != NULL;
+
+	default:
+		break;
+	}
+
+	const s_num_range *range = &expr->ranges[node->range];
+
+	if (row_idx >= 0 && range->bitmap != NULL) {
+		return s_num_bit(range->bitmap, row_idx);
+	}
+
+	if (range->is_date) {
+		return s_date_parse(&range->date_fmt, str, &epoch) && s_num_range_matches(range, (double) epoch);
+	}
+
+	return s_num_parse_field(str, s_num_decimal_point(), &num, &suffix, &is_bool) && s_num_range_matches(range, num);
+}
+
+/******************************************************************************
+ * The function evaluates a node of the predicate tree for a row. AND and OR
+ * nodes stop with the first operand that decides the result.
+ *****************************************************************************/
+
+static bool node_eval(const s_expr *expr, const int idx, wchar_t **row, const int row_idx) {
+	const s_expr_node *node = &expr->nodes[idx];
+
+	switch (node->type) {
+
+	case EXPR_PRED:
+
+		if (node->column >= 0) {
+			return pred_matches(expr, node, row[node->column], row_idx);
+		}
+
+		for (int column = 0; column < expr->no_columns; column++) {
+
+			if (pred_matches(expr, node, row[column], row_idx)) {
+				return true;
+			}
+		}
+
+		return false;
+
+	case EXPR_NOT:
+		return !node_eval(expr, expr->children[node->first], row, row_idx);
+
+	case EXPR_AND:
+
+		for (int i = 0; i < node->count; i++) {
+
+			if (!node_eval(expr, expr->children[node->first + i], row, row_idx)) {
+				return false;
+			}
+		}
+
+		return true;
+
+	case EXPR_OR:
+
+		for (int i = 0; i < node->count; i++) {
+
+			if (node_eval(expr, expr->children[node->first + i], row, row_idx)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function evaluates the expression for a row of the table. The index is
+ * the index of the row in the unfiltered table, which is used to access the
+ * bitmaps of the ranges. If it is negative, the fields are parsed.
+ *****************************************************************************/
+
+bool s_expr_eval(const s_expr *expr, wchar_t **row, const int row_idx) {
+	return node_eval(expr, expr->root, row, row_idx);
+}
+
+/******************************************************************************
+ * The function checks whether a node may match a row of a block. If it
+ * returns false, no row of the block matches. A negated node may match
+ * always, because the summaries only show what is missing in a block.
+ *****************************************************************************/
+
+static bool node_may_match_block(const s_expr *expr, const int idx, const s_blocks *blocks, const int block) {
+	const s_expr_node *node = &expr->nodes[idx];
+
+	switch (node->type) {
+
+	case EXPR_PRED:
+
+		if (node->range >= 0) {
+			const s_num_range *range = &expr->ranges[node->range];
+			return range->blocks == NULL || s_num_bit(range->blocks, block);
+		}
+
+		if (node->column >= 0) {
+			return s_blocks_may_contain(blocks, block, node->column, node->value);
+		}
+
+		for (int column = 0; column < expr->no_columns; column++) {
+
+			if (s_blocks_may_contain(blocks, block, column, node->value)) {
+				return true;
+			}
+		}
+
+		return false;
+
+	case EXPR_NOT:
+		return true;
+
+	case EXPR_AND:
+
+		for (int i = 0; i < node->count; i++) {
+
+			if (!node_may_match_block(expr, expr->children[node->first + i], blocks, block)) {
+				return false;
+			}
+		}
+
+		return true;
+
+	case EXPR_OR:
+
+		for (int i = 0; i < node->count; i++) {
+
+			if (node_may_match_block(expr, expr->children[node->first + i], blocks, block)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function checks with the summaries of a block of rows, whether the
+ * expression may match a row of the block.
+ *****************************************************************************/
+
+bool s_expr_may_match_block(const s_expr *expr, const s_blocks *blocks, const int block) {
+	return node_may_match_block(expr, expr->root, blocks, block);
+}
+
+/******************************************************************************
+ * The function returns the ranges of the numeric comparisons. Their bitmaps
+ * can be created with the parsed columns of the table.
+ *****************************************************************************/
+
+s_num_range* s_expr_get_ranges(s_expr *expr, int *no_ranges) {
+
+	*no_ranges = expr->no_ranges;
+
+	return expr->ranges;
+}
+
+/******************************************************************************
+ * The function checks whether a field of a column matches a positive
+ * predicate. These are the fields that are highlighted and that are part of
+ * the match index.
+ *****************************************************************************/
+
+bool s_expr_field_matches(const s_expr *expr, const int column, const wchar_t *str) {
+
+	for (int i = 0; i < expr->no_nodes; i++) {
+		const s_expr_node *node = &expr->nodes[i];
+
+		if (node->type == EXPR_PRED && node->is_positive && (node->column < 0 || node->column == column) && pred_matches(expr, node, str, -1)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function searches the next match of a positive predicate of the column
+ * in a string, starting at the offset. For contains predicates this is the
+ * value. For the other predicates this is the whole string, so it only
+ * matches at offset 0. If there are several matches, the first and longest
+ * is returned. If there is no match, the function returns NULL.
+ *****************************************************************************/
+
+wchar_t* s_expr_search(const s_expr *expr, const int column, const wchar_t *str, const size_t offset, size_t *len) {
+	wchar_t *result = NULL;
+	wchar_t *ptr;
+	size_t ptr_len;
+
+	for (int i = 0; i < expr->no_nodes; i++) {
+		const s_expr_node *node = &expr->nodes[i];
+
+		if (node->type != EXPR_PRED || !node->is_positive || (node->column >= 0 && node->column != column)) {
+			continue;
+		}
+
+		if (node->op == EXPR_CONTAINS) {
+			ptr = expr->case_insensitive ? wcs_casestr(str + offset, node->value) : wcsstr(str + offset, node->value);
+			ptr_len = wcslen(node->value);
+
+		} else {
+			ptr = (offset == 0 && pred_matches(expr, node, str, -1)) ? (wchar_t*) str : NULL;
+			ptr_len = wcslen(str);
+		}
+
+		if (ptr != NULL && (result == NULL || ptr < result || (ptr == result && ptr_len > *len))) {
+			result = ptr;
+			*len = ptr_len;
+		}
+	}
+
+	return result;
+}
@@ -201,13 +201,12 @@ void intersection(const s_buffer *visible, const s_buffer *print, s_buffer *resu
 }
 
 /******************************************************************************
- * The function is called with a line of a field, the visible part of the field
- * and a filter struct. It prints the visible part of the line, where the
- * filter string is highlighted. So the function searches multiple times
- * through the line until the filter string is not found any more.
+ * The function prints a part of a line of a field, with a given attribute.
+ * Only the visible part of it is printed. The function returns the updated
+ * column position in the window.
  *****************************************************************************/
 
-static void print_line(WINDOW *win, const int win_y, int win_x, wchar_t *field_line, s_buffer *visible, const s_filter *filter, const s_attr *attr_cur) {
+static int print_part(WINDOW *win, const int win_y, int win_x, wchar_t *ptr, const int len, const s_buffer *visible, const chtype attr) {
 
 	//
 	// The part of the line that should be printed.
@@ -219,107 +218,76 @@ static void print_line(WINDOW *win, const int win_y, int win_x, wchar_t *field_l
 	//
 	s_buffer result;
 
-	wchar_t *cur = field_line;
-	wchar_t *ptr;
-
-	size_t filter_len = s_filter_len(filter);
+	s_buffer_set(&print, ptr, len);
+	intersection(visible, &print, &result);
 
-	while (*cur != W_STR_TERM) {
+	//
+	// Ensure that the string to print is visible
+	//
+	if (result.ptr != NULL) {
+		wattrset(win, attr);
+		mvwaddnwstr(win, win_y, win_x, result.ptr, result.len);
 
 		//
-		// Search the filter string from the current position.
+		// Update the column position in the window.
 		//
-		ptr = s_filter_search_str(filter, cur);
+		win_x += result.len;
+	}
 
-		//
-		// If the search string was not found. Print the rest of the line.
-		//
-		if (ptr == NULL) {
-
-			//
-			// Set the print to the current position and the rest of the
-			// buffer. And compute the visible part of it.
-			//
-			s_buffer_set(&print, cur, visible->len - (cur - visible->ptr));
-			intersection(visible, &print, &result);
-
-			//
-			// Ensure that the string to print is visible
-			//
-			if (result.ptr != NULL) {
-				mvwaddnwstr(win, win_y, win_x, result.ptr, result.len);
-			}
+	return win_x;
+}
 
-			break;
-		}
+/******************************************************************************
+ * The function is called with a line of a field, the visible part of the field
+ * and the cached spans of the field, that match the filter. It prints the
+ * visible part of the line, where the spans of the line are highlighted. The
+ * spans are ordered, so the index of the next span is updated.
+ *****************************************************************************/
 
-		//
-		// If the line does not start with the search string, print the
-		// substring from the current position up to the search string.
-		//
-		if (ptr > cur) {
-
-			//
-			// Set the print to the current position and the beginning of the
-			// search found. And compute the visible part of it.
-			//
-			s_buffer_set(&print, cur, ptr - cur);
-			intersection(visible, &print, &result);
-
-			//
-			// Ensure that the string to print is visible
-			//
-			if (result.ptr != NULL) {
-				mvwaddnwstr(win, win_y, win_x, result.ptr, result.len);
-
-				//
-				// Update the column position in the window.
-				//
-				win_x += result.len;
-			}
-		}
+static void print_line(WINDOW *win, const int win_y, int win_x, wchar_t *field_line, s_buffer *visible, const int line_no, const s_spans_entry *spans, int *span_idx, const s_attr *attr_cur) {
+	const s_span *span;
 
-		//
-		// Set the print to the search result. And compute the visible part of
-		// it.
-		//
-		s_buffer_set(&print, ptr, filter_len);
-		intersection(visible, &print, &result);
+	wchar_t *cur = field_line;
 
-		//
-		// Ensure that the string to print is visible
-		//
-		if (result.ptr != NULL) {
-
-			//
-			// Set the highlighted attribute print the string and reset the
-			// attribute again.
-			//
-			wattrset(win, attr_cur->highlight);
-			mvwaddnwstr(win, win_y, win_x, result.ptr, result.len);
-			wattrset(win, (attr_cur->normal));
-
-			//
-			// Update the column position in the window.
-			//
-			win_x += result.len;
-		}
+	//
+	// Skip the spans of the lines that are not visible.
+	//
+	while (*span_idx < spans->count && spans->spans[*span_idx].line < line_no) {
+		(*span_idx)++;
+	}
+
+	for (; *span_idx < spans->count && spans->spans[*span_idx].line == line_no; (*span_idx)++) {
+		span = &spans->spans[*span_idx];
 
 		//
-		// Update the current position to the end of the found search string.
+		// Print the substring from the current position up to the span and
+		// the highlighted span.
 		//
-		cur = ptr + filter_len;
+		win_x = print_part(win, win_y, win_x, cur, field_line + span->start - cur, visible, attr_cur->normal);
+		win_x = print_part(win, win_y, win_x, field_line + span->start, span->len, visible, attr_cur->highlight);
+
+		cur = field_line + span->start + span->len;
 	}
+
+	//
+	// Print the rest of the line and reset the attribute.
+	//
+	print_part(win, win_y, win_x, cur, visible->len - (cur - visible->ptr), visible, attr_cur->normal);
+	wattrset(win, attr_cur->normal);
 }
 
 /******************************************************************************
  * The function prints the content of a field. The field can be truncated, so
- * maybe parts of the field content are not printed. The field may contain a
- * filter string, which will be highlighted.
+ * maybe parts of the field content are not printed. The field may contain
+ * matches of the filter, which will be highlighted.
  *
  * The function call has the field part parameter, which define the visible
  * part of the field.
  *
+ * The spans parameter contains the cached matches of the filter. It is NULL if
+ * the filter is not active or the field is not searched by the filter, so
+ * nothing is highlighted.
+ *
  * The win_row_col parameter contains the x, y coordinates of the field in the
  * window.
  *
@@ -327,9 +295,10 @@ static void print_line(WINDOW *win, const int win_y, int win_x, wchar_t *field_l
  * truncated width of the column.
  *****************************************************************************/
 
-void print_field_content(WINDOW *win, wchar_t *field_content, const s_field_part *row_field_part, const s_field_part *col_field_part, const s_field *win_row_col, const int width, const s_filter *filter, const s_attr *attr_cur) {
+void print_field_content(WINDOW *win, wchar_t *field_content, const s_field_part *row_field_part, const s_field_part *col_field_part, const s_field *win_row_col, const int width, const s_spans_entry *spans, const s_attr *attr_cur) {
 	int row;
 	bool end = false;
+	int span_idx = 0;
 
 	log_debug("Win row: %d win col: %d field: '%ls'", win_row_col->row, win_row_col->col, field_content);
 
@@ -371,8 +340,8 @@ void print_field_content(WINDOW *win, wchar_t *field_content, const s_field_part
 		if (field_line_no >= row_field_part->start) {
 			row = win_row_col->row + field_line_no - row_field_part->start;
 
-			if (s_filter_is_active(filter)) {
-				print_line(win, row, win_row_col->col, buffer, &buf, filter, attr_cur);
+			if (spans != NULL) {
+				print_line(win, row, win_row_col->col, buffer, &buf, field_line_no, spans, &span_idx, attr_cur);
 			} else {
 				mvwaddnwstr(win, row, win_row_col->col, buf.ptr, buf.len);
 			}
@@ -23,9 +23,14 @@
  */
 
 #include "ncv_filter.h"
+#include "ncv_bitmap.h"
 #include "ncv_common.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <wctype.h>
 
 /******************************************************************************
  * The function sets the values of a s_filter. The function returns true to
@@ -35,16 +40,393 @@
 bool s_filter_set(s_filter *filter, const bool is_active, const wchar_t *str, const bool case_insensitive, const bool is_search) {
 
 	wcsncpy(filter->str, str, FILTER_STR_LEN);
+
+	//
+	// The filter is not restricted to columns by default.
+	//
+	filter->cols_str[0] = W_STR_TERM;
+	filter->is_restricted = false;
+
 	filter->is_active = is_active;
 	filter->case_insensitive = case_insensitive;
 	filter->is_search = is_search;
 
+	//
+	// The filter string is a plain string by default.
+	//
+	filter->is_regex = false;
+	filter->is_fuzzy = false;
+	filter->is_multi = false;
+	filter->is_expr = false;
+
 	//
 	// The filter changed
 	//
 	return true;
 }
 
+/******************************************************************************
+ * The function initializes a s_filter. The compiled regex, expression, fuzzy
+ * pattern, pattern automaton and the columns are not set, which is important,
+ * because s_filter_prepare() and s_filter_free() free them.
+ *****************************************************************************/
+
+void s_filter_init(s_filter *filter) {
+
+	s_filter_set(filter, SF_IS_INACTIVE, L"", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+
+	filter->regex = NULL;
+	filter->expr = NULL;
+	filter->fuzzy = NULL;
+	filter->aho = NULL;
+
+	filter->col_bits = NULL;
+	filter->columns = NULL;
+	filter->no_columns = 0;
+}
+
+/******************************************************************************
+ * The function frees the compiled regex, expression, fuzzy pattern, the
+ * pattern automaton and the columns of the filter, if present.
+ *****************************************************************************/
+
+void s_filter_free(s_filter *filter) {
+
+	if (filter->regex != NULL) {
+		s_regex_free(filter->regex);
+		filter->regex = NULL;
+	}
+
+	if (filter->expr != NULL) {
+		s_expr_free(filter->expr);
+		filter->expr = NULL;
+	}
+
+	if (filter->fuzzy != NULL) {
+		s_fuzzy_free(filter->fuzzy);
+		filter->fuzzy = NULL;
+	}
+
+	if (filter->aho != NULL) {
+		s_aho_free(filter->aho);
+		filter->aho = NULL;
+	}
+
+	free(filter->col_bits);
+	filter->col_bits = NULL;
+
+	free(filter->columns);
+	filter->columns = NULL;
+	filter->no_columns = 0;
+}
+
+/******************************************************************************
+ * The function adds a pattern to a dynamic array of patterns. Empty patterns
+ * are ignored.
+ *****************************************************************************/
+
+static void add_pattern(wchar_t ***patterns, int *no_patterns, const wchar_t *pattern) {
+
+	if (pattern[0] == W_STR_TERM) {
+		return;
+	}
+
+	*patterns = xrealloc(*patterns, sizeof(wchar_t*) * (*no_patterns + 1));
+
+	(*patterns)[*no_patterns] = xmalloc(sizeof(wchar_t) * (wcslen(pattern) + 1));
+	wcscpy((*patterns)[*no_patterns], pattern);
+
+	(*no_patterns)++;
+}
+
+/******************************************************************************
+ * The function reads the patterns from a file with one pattern per line. It
+ * returns false if the file cannot be read or if a line is longer than
+ * FILTER_MULTI_LINE_LEN, which would be split into several patterns.
+ *****************************************************************************/
+
+static bool read_patterns(const wchar_t *filename, wchar_t ***patterns, int *no_patterns) {
+	char name[FILTER_STR_LEN * MB_LEN_MAX + 1];
+	wchar_t line[FILTER_MULTI_LINE_LEN + 1];
+
+	if (wcstombs(name, filename, sizeof(name)) == (size_t) -1) {
+		log_debug("Unable to convert filename: %ls", filename);
+		return false;
+	}
+
+	FILE *file = fopen(name, "r");
+	if (file == NULL) {
+		log_debug("Unable to open file: %s", name);
+		return false;
+	}
+
+	bool result = true;
+	wint_t chr;
+
+	while (fgetws(line, FILTER_MULTI_LINE_LEN + 1, file) != NULL) {
+		const size_t len = wcslen(line);
+
+		//
+		// A full buffer without a newline is only valid if the line ends
+		// there.
+		//
+		if (len == FILTER_MULTI_LINE_LEN && line[len - 1] != L'\n' && (chr = fgetwc(file)) != WEOF && chr != L'\n') {
+			log_debug("Line of file: %s is too long: %ls", name, line);
+			result = false;
+			break;
+		}
+
+		line[wcscspn(line, L"\r\n")] = W_STR_TERM;
+		add_pattern(patterns, no_patterns, line);
+	}
+
+	fclose(file);
+
+	if (!result) {
+		for (int i = 0; i < *no_patterns; i++) {
+			free((*patterns)[i]);
+		}
+
+		free(*patterns);
+		*patterns = NULL;
+		*no_patterns = 0;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * The function creates the automaton of a multi pattern filter. The patterns
+ * are separated by: | or are read from a file, if the filter string starts
+ * with: @. The function returns NULL if there are no patterns.
+ *****************************************************************************/
+
+static s_aho* create_aho(const s_filter *filter) {
+	wchar_t buf[FILTER_STR_LEN + 1];
+	wchar_t delim[] = { FILTER_MULTI_DELIM, W_STR_TERM };
+	wchar_t *state, *token;
+
+	wchar_t **patterns = NULL;
+	int no_patterns = 0;
+
+	if (filter->str[0] == FILTER_MULTI_FILE) {
+
+		if (!read_patterns(filter->str + 1, &patterns, &no_patterns)) {
+			return NULL;
+		}
+
+	} else {
+		wcsncpy(buf, filter->str, FILTER_STR_LEN + 1);
+
+		for (token = wcstok(buf, delim, &state); token != NULL; token = wcstok(NULL, delim, &state)) {
+			add_pattern(&patterns, &no_patterns, token);
+		}
+	}
+
+	s_aho *aho = no_patterns > 0 ? s_aho_create(patterns, no_patterns, filter->case_insensitive) : NULL;
+
+	for (int i = 0; i < no_patterns; i++) {
+		free(patterns[i]);
+	}
+
+	free(patterns);
+
+	return aho;
+}
+
+/******************************************************************************
+ * The function parses a column definition string, which is a comma separated
+ * list of 1-based column numbers or ranges, like: "2,5-7". The column numbers
+ * have to be between 1 and max_column. If a bitmap is given, the bits of the
+ * 0-based columns are set. The flag is set if the string contains a column.
+ * The function returns false if the string is not valid.
+ *****************************************************************************/
+
+static bool parse_columns(const wchar_t *cols_str, const long max_column, uint64_t *bits, bool *has_columns) {
+	const wchar_t *ptr = cols_str;
+	wchar_t *end;
+	long from, to;
+
+	*has_columns = false;
+
+	while (true) {
+
+		//
+		// Skip spaces and check for the end of the string.
+		//
+		for (; iswspace(*ptr); ptr++);
+
+		if (*ptr == W_STR_TERM) {
+			break;
+		}
+
+		//
+		// Read the first column number of a single column or a range.
+		//
+		errno = 0;
+		from = wcstol(ptr, &end, 10);
+		if (end == ptr || errno == ERANGE || from < 1 || from > max_column) {
+			log_debug("Invalid column: %ls", ptr);
+			return false;
+		}
+
+		for (ptr = end; iswspace(*ptr); ptr++);
+
+		//
+		// Read the second column number of a range.
+		//
+		if (*ptr == L'-') {
+			ptr++;
+
+			errno = 0;
+			to = wcstol(ptr, &end, 10);
+			if (end == ptr || errno == ERANGE || to < from || to > max_column) {
+				log_debug("Invalid range: %ls", ptr);
+				return false;
+			}
+
+			for (ptr = end; iswspace(*ptr); ptr++);
+
+		} else {
+			to = from;
+		}
+
+		//
+		// The columns are 0-based internally.
+		//
+		if (bits != NULL) {
+			for (long column = from - 1; column < to; column++) {
+				s_bits_set(bits, column);
+			}
+		}
+
+		*has_columns = true;
+
+		//
+		// The next element has to be separated by a comma.
+		//
+		if (*ptr == L',') {
+			ptr++;
+
+		} else if (*ptr != W_STR_TERM) {
+			log_debug("Invalid separator: %ls", ptr);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function creates the bitmap and the ordered array of the columns of a
+ * restricted filter for a table with no_columns. It returns false if a column
+ * is not part of the table.
+ *****************************************************************************/
+
+static bool create_columns(s_filter *filter, const int no_columns) {
+	bool has_columns;
+
+	const int words = s_bits_words(no_columns);
+
+	filter->col_bits = xmalloc(sizeof(uint64_t) * (words > 0 ? words : 1));
+	memset(filter->col_bits, 0, sizeof(uint64_t) * (words > 0 ? words : 1));
+
+	if (!parse_columns(filter->cols_str, no_columns, filter->col_bits, &has_columns)) {
+		s_filter_free(filter);
+		return false;
+	}
+
+	filter->no_columns = 0;
+
+	for (int word = 0; word < words; word++) {
+		filter->no_columns += __builtin_popcountll(filter->col_bits[word]);
+	}
+
+	filter->columns = xmalloc(sizeof(int) * filter->no_columns);
+
+	for (int column = 0, idx = 0; column < no_columns; column++) {
+		if (s_bits_get(filter->col_bits, column)) {
+			filter->columns[idx++] = column;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function has to be called before the filter is used for searching and
+ * after it has changed. For an active regex, expression, fuzzy or multi
+ * pattern filter, the filter string is compiled. The header row is used to
+ * resolve the column names of an expression and can be NULL. The columns of
+ * a restricted filter are created for a table with no_columns. The function
+ * returns false if the filter string or the columns are not valid.
+ *****************************************************************************/
+
+bool s_filter_prepare(s_filter *filter, wchar_t **header, const int no_columns) {
+
+	s_filter_free(filter);
+
+	if (!filter->is_active) {
+		return true;
+	}
+
+	if (s_filter_is_restricted(filter) && !create_columns(filter, no_columns)) {
+		return false;
+	}
+
+	if (filter->is_expr) {
+		filter->expr = s_expr_create(filter->str, filter->case_insensitive, header, no_columns);
+		return filter->expr != NULL;
+	}
+
+	if (filter->is_regex) {
+		filter->regex = s_regex_create(filter->str, filter->case_insensitive);
+		return filter->regex != NULL;
+	}
+
+	if (filter->is_fuzzy) {
+		filter->fuzzy = s_fuzzy_create(filter->str, filter->case_insensitive);
+		return filter->fuzzy != NULL;
+	}
+
+	if (filter->is_multi) {
+		filter->aho = create_aho(filter);
+		return filter->aho != NULL;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function checks whether the filter was prepared, which means that an
+ * active filter, that requires a compiled form, has it.
+ *****************************************************************************/
+
+bool s_filter_is_prepared(const s_filter *filter) {
+
+	if (!filter->is_active) {
+		return true;
+	}
+
+	if (s_filter_is_restricted(filter) && filter->col_bits == NULL) {
+		return false;
+	}
+
+	if (filter->is_expr) {
+		return filter->expr != NULL;
+	}
+
+	if (filter->is_regex) {
+		return filter->regex != NULL;
+	}
+
+	if (filter->is_fuzzy) {
+		return filter->fuzzy != NULL;
+	}
+
+	return !filter->is_multi || filter->aho != NULL;
+}
+
 /******************************************************************************
  * The function sets the filter status to inactive. It returns true if the
  * status changed.
@@ -80,6 +462,18 @@ bool s_filter_update(s_filter *to_filter, const s_filter *from_filter) {
 		result = true;
 	}
 
+	//
+	// column restriction (the columns are created from the string)
+	//
+	if (wcscmp(to_filter->cols_str, from_filter->cols_str) != 0) {
+
+		log_debug("Filter columns changed from: %ls to: %ls", to_filter->cols_str, from_filter->cols_str);
+		wcsncpy(to_filter->cols_str, from_filter->cols_str, FILTER_COLS_LEN);
+
+		to_filter->is_restricted = from_filter->is_restricted;
+		result = true;
+	}
+
 	//
 	// case_insensitive flag
 	//
@@ -90,6 +484,46 @@ bool s_filter_update(s_filter *to_filter, const s_filter *from_filter) {
 		result = true;
 	}
 
+	//
+	// is_regex flag
+	//
+	if (to_filter->is_regex != from_filter->is_regex) {
+
+		log_debug("Regex flag changed from: %d to: %d", to_filter->is_regex, from_filter->is_regex);
+		to_filter->is_regex = from_filter->is_regex;
+		result = true;
+	}
+
+	//
+	// is_fuzzy flag
+	//
+	if (to_filter->is_fuzzy != from_filter->is_fuzzy) {
+
+		log_debug("Fuzzy flag changed from: %d to: %d", to_filter->is_fuzzy, from_filter->is_fuzzy);
+		to_filter->is_fuzzy = from_filter->is_fuzzy;
+		result = true;
+	}
+
+	//
+	// is_multi flag
+	//
+	if (to_filter->is_multi != from_filter->is_multi) {
+
+		log_debug("Multi flag changed from: %d to: %d", to_filter->is_multi, from_filter->is_multi);
+		to_filter->is_multi = from_filter->is_multi;
+		result = true;
+	}
+
+	//
+	// is_expr flag
+	//
+	if (to_filter->is_expr != from_filter->is_expr) {
+
+		log_debug("Expression flag changed from: %d to: %d", to_filter->is_expr, from_filter->is_expr);
+		to_filter->is_expr = from_filter->is_expr;
+		result = true;
+	}
+
 	//
 	// is_search flag
 	//
@@ -113,6 +547,132 @@ bool s_filter_update(s_filter *to_filter, const s_filter *from_filter) {
 	return result;
 }
 
+/******************************************************************************
+ * The function checks whether the new filter is a refinement of the old
+ * filter, which means that each row that matches the new filter also matches
+ * the old filter. In this case the rows of a table, that is filtered with the
+ * old filter, can be filtered with the new filter, instead of all rows of the
+ * table. This is the case for active plain filters with the same options,
+ * where the new filter string contains the old filter string, which is
+ * typically the case, if the user is typing the filter string.
+ *****************************************************************************/
+
+bool s_filter_is_refinement(const s_filter *old_filter, const s_filter *new_filter) {
+
+	//
+	// Both filters have to be active plain filters. For expressions with NOT
+	// or OR, a longer string does not define a subset.
+	//
+	if (!old_filter->is_active || !new_filter->is_active || old_filter->is_search || new_filter->is_search || old_filter->is_regex || new_filter->is_regex || old_filter->is_expr || new_filter->is_expr
+			|| old_filter->is_fuzzy || new_filter->is_fuzzy || old_filter->is_multi || new_filter->is_multi) {
+		return false;
+	}
+
+	//
+	// The options have to be the same.
+	//
+	if (old_filter->case_insensitive != new_filter->case_insensitive || wcscmp(old_filter->cols_str, new_filter->cols_str) != 0) {
+		return false;
+	}
+
+	return wcsstr(new_filter->str, old_filter->str) != NULL;
+}
+
+/******************************************************************************
+ * The function creates the key of a filter for the cache of the results. The
+ * key contains the flags, that define the matching rows, the columns and the
+ * filter string. A plain, fuzzy or multi pattern string of a case insensitive
+ * filter is folded to lower case, so "Abc" and "aBC" have the same key. The
+ * function returns false, if the filter cannot be cached, which is the case
+ * for patterns that are read from a file, because the file can change.
+ *****************************************************************************/
+
+bool s_filter_cache_key(const s_filter *filter, wchar_t *key, const size_t size) {
+
+	if (filter->is_multi && filter->str[0] == FILTER_MULTI_FILE) {
+		return false;
+	}
+
+	const int len = swprintf(key, size, L"%d%d%d%d%d|%ls|%ls", filter->case_insensitive, filter->is_regex, filter->is_fuzzy, filter->is_multi, filter->is_expr, filter->cols_str, filter->str);
+
+	if (len < 0) {
+		return false;
+	}
+
+	if (filter->case_insensitive && !filter->is_regex && !filter->is_expr) {
+
+		for (wchar_t *ptr = key + len - wcslen(filter->str); *ptr != W_STR_TERM; ptr++) {
+			*ptr = (wchar_t) towlower((wint_t) *ptr);
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses a column definition string and restricts the filter to
+ * the columns. The string is a comma separated list of 1-based column numbers
+ * or ranges, like: "2,5-7". An empty string removes the restriction. If the
+ * string is not valid, the function returns false and the filter is
+ * unchanged. The columns are checked against the table and created by
+ * s_filter_prepare().
+ *****************************************************************************/
+
+bool s_filter_set_columns(s_filter *filter, const wchar_t *cols_str) {
+	bool has_columns;
+
+	if (wcslen(cols_str) > FILTER_COLS_LEN) {
+		log_debug("Column string too long: %ls", cols_str);
+		return false;
+	}
+
+	if (!parse_columns(cols_str, INT_MAX, NULL, &has_columns)) {
+		return false;
+	}
+
+	wcsncpy(filter->cols_str, cols_str, FILTER_COLS_LEN);
+	filter->cols_str[FILTER_COLS_LEN] = W_STR_TERM;
+
+	filter->is_restricted = has_columns;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function checks whether a column is searched by the filter. This is the
+ * case if the filter is not restricted or the column is part of the column
+ * set. The filter has to be prepared with s_filter_prepare().
+ *****************************************************************************/
+
+bool s_filter_has_column(const s_filter *filter, const int column) {
+	return !s_filter_is_restricted(filter) || s_bits_get(filter->col_bits, column);
+}
+
+/******************************************************************************
+ * The function returns the number of columns of a table with no_columns, that
+ * are searched by the filter. Together with s_filter_get_column() it is used
+ * to iterate over the searched columns in ascending order:
+ *
+ * for (idx = 0; idx < s_filter_num_columns(f, n); idx++)
+ *     column = s_filter_get_column(f, idx);
+ *
+ * The columns of a restricted filter are columns of the table, which is
+ * checked by s_filter_prepare().
+ *****************************************************************************/
+
+int s_filter_num_columns(const s_filter *filter, const int no_columns) {
+	return s_filter_is_restricted(filter) ? filter->no_columns : no_columns;
+}
+
+/******************************************************************************
+ * The function returns the column with the given index of the searched
+ * columns. (See: s_filter_num_columns())
+ *****************************************************************************/
+
+int s_filter_get_column(const s_filter *filter, const int idx) {
+	return s_filter_is_restricted(filter) ? filter->columns[idx] : idx;
+}
+
 /******************************************************************************
  * The function searches for the next occurrence of the filter string in a
  * given string. If the filter string was not found, the function returns NULL.
@@ -127,6 +687,133 @@ wchar_t* s_filter_search_str(const s_filter *filter, const wchar_t *str) {
 	}
 }
 
+/******************************************************************************
+ * The function checks whether a string of a column matches the filter. For a
+ * regex filter the lazy DFA of the compiled regex is used, which stops on the
+ * first match. The DFA caches its states, which does not change the filter
+ * logically, so the filter is const. For an expression filter, the string
+ * matches if it matches a predicate of the column, that is not negated. The
+ * filter has to be prepared with s_filter_prepare().
+ *****************************************************************************/
+
+bool s_filter_matches(const s_filter *filter, const int column, const wchar_t *str) {
+
+	if (filter->is_expr) {
+		return s_expr_field_matches(filter->expr, column, str);
+	}
+
+	if (filter->is_regex) {
+		return s_regex_matches(filter->regex, str);
+	}
+
+	if (filter->is_fuzzy) {
+		return s_fuzzy_matches(filter->fuzzy, str);
+	}
+
+	if (filter->is_multi) {
+		return s_aho_matches(filter->aho, str);
+	}
+
+	return s_filter_search_str(filter, str) != NULL;
+}
+
+/******************************************************************************
+ * The function checks whether a row matches the filter. An expression is
+ * evaluated for the whole row, with the index of the row in the unfiltered
+ * table. Otherwise a field of a searched column has to match.
+ *****************************************************************************/
+
+bool s_filter_matches_row(const s_filter *filter, wchar_t **row, const int row_idx, const int no_columns) {
+
+	if (filter->is_expr) {
+		return s_expr_eval(filter->expr, row, row_idx);
+	}
+
+	const int num_columns = s_filter_num_columns(filter, no_columns);
+
+	for (int idx = 0; idx < num_columns; idx++) {
+		const int column = s_filter_get_column(filter, idx);
+
+		if (s_filter_matches(filter, column, row[column])) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function checks with the summaries of a block of rows, whether a row of
+ * the block may match the filter. A plain filter string has to be contained
+ * in a searched column, for a multi pattern filter one of the patterns. For
+ * regex and fuzzy filters, there is no check.
+ *****************************************************************************/
+
+bool s_filter_may_match_block(const s_filter *filter, const s_blocks *blocks, const int block, const int no_columns) {
+
+	if (filter->is_expr) {
+		return s_expr_may_match_block(filter->expr, blocks, block);
+	}
+
+	if (filter->is_regex || filter->is_fuzzy) {
+		return true;
+	}
+
+	const int num_columns = s_filter_num_columns(filter, no_columns);
+
+	for (int idx = 0; idx < num_columns; idx++) {
+		const int column = s_filter_get_column(filter, idx);
+
+		if (!filter->is_multi) {
+
+			if (s_blocks_may_contain(blocks, block, column, filter->str)) {
+				return true;
+			}
+
+			continue;
+		}
+
+		for (int i = 0; i < s_aho_no_patterns(filter->aho); i++) {
+
+			if (s_blocks_may_contain(blocks, block, column, s_aho_pattern(filter->aho, i))) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function searches for the next match of the filter in a given string of
+ * a column, starting at the offset. It returns a pointer to the start of the
+ * match and sets the length of the match, which can be 0 for a regex filter.
+ * If there is no match, the function returns NULL.
+ *****************************************************************************/
+
+wchar_t* s_filter_search_match(const s_filter *filter, const int column, const wchar_t *str, const size_t offset, size_t *len) {
+
+	if (filter->is_expr) {
+		return s_expr_search(filter->expr, column, str, offset, len);
+	}
+
+	if (filter->is_regex) {
+		return s_regex_search(filter->regex, str, offset, len);
+	}
+
+	if (filter->is_fuzzy) {
+		return s_fuzzy_search(filter->fuzzy, str, offset, len);
+	}
+
+	if (filter->is_multi) {
+		return s_aho_search(filter->aho, str, offset, len);
+	}
+
+	*len = s_filter_len(filter);
+
+	return s_filter_search_str(filter, str + offset);
+}
+
 /******************************************************************************
  * The function print the filter structure.
  *
@@ -138,11 +825,11 @@ wchar_t* s_filter_search_str(const s_filter *filter, const wchar_t *str) {
 
 void s_filter_print(const s_filter *filter) {
 
-	log_debug("Is active: '%s' case insensitive: '%s' is search: '%s' has changed: '%s' filter: '%ls'",
+	log_debug("Is active: '%s' case insensitive: '%s' is search: '%s' is regex: '%s' is fuzzy: '%s' is multi: '%s' is expr: '%s' has changed: '%s' filter: '%ls' columns: '%ls'",
 
-	bool_2_str(filter->is_active), bool_2_str(filter->case_insensitive), bool_2_str(filter->is_search), bool_2_str(filter->has_changed),
+	bool_2_str(filter->is_active), bool_2_str(filter->case_insensitive), bool_2_str(filter->is_search), bool_2_str(filter->is_regex), bool_2_str(filter->is_fuzzy), bool_2_str(filter->is_multi), bool_2_str(filter->is_expr), bool_2_str(filter->has_changed),
 
-	filter->str);
+	filter->str, filter->cols_str);
 }
 
 #endif
@@ -0,0 +1,353 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_fuzzy.h"
+#include "ncv_common.h"
+
+#include <stdint.h>
+#include <wctype.h>
+
+/******************************************************************************
+ * The maximum number of errors for long patterns.
+ *****************************************************************************/
+
+#define FUZZY_MAX_ERRORS 3
+
+/******************************************************************************
+ * The number of chars, that have a direct entry in the table of the bit
+ * masks.
+ *****************************************************************************/
+
+#define FUZZY_ASCII 128
+
+/******************************************************************************
+ * The definition of the compiled pattern. For each char of the pattern there
+ * is a bit mask with the positions of the char in the pattern. ASCII chars
+ * have a table, the masks of the other chars are searched in a small array.
+ *****************************************************************************/
+
+struct s_fuzzy {
+
+	bool case_insensitive;
+
+	//
+	// The (case folded) pattern and its length.
+	//
+	wchar_t pattern[FUZZY_MAX_LEN + 1];
+
+	int len;
+
+	int max_errors;
+
+	uint64_t ascii[FUZZY_ASCII];
+
+	wchar_t chars[FUZZY_MAX_LEN];
+
+	uint64_t masks[FUZZY_MAX_LEN];
+
+	int no_chars;
+};
+
+/******************************************************************************
+ * The function folds a char, if the search is case insensitive.
+ *****************************************************************************/
+
+static inline wchar_t fuzzy_fold(const s_fuzzy *fuzzy, const wchar_t chr) {
+	return fuzzy->case_insensitive ? (wchar_t) towlower((wint_t) chr) : chr;
+}
+
+/******************************************************************************
+ * The function returns the bit mask with the positions of a (folded) char in
+ * the pattern.
+ *****************************************************************************/
+
+static inline uint64_t fuzzy_mask(const s_fuzzy *fuzzy, const wchar_t chr) {
+
+	if ((unsigned) chr < FUZZY_ASCII) {
+		return fuzzy->ascii[chr];
+	}
+
+	for (int i = 0; i < fuzzy->no_chars; i++) {
+		if (fuzzy->chars[i] == chr) {
+			return fuzzy->masks[i];
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************
+ * The function compiles a pattern. It returns NULL if the pattern is empty or
+ * too long.
+ *****************************************************************************/
+
+s_fuzzy* s_fuzzy_create(const wchar_t *pattern, const bool case_insensitive) {
+	int i;
+
+	const size_t len = wcslen(pattern);
+
+	if (len == 0 || len > FUZZY_MAX_LEN) {
+		log_debug("Invalid pattern length: %zu", len);
+		return NULL;
+	}
+
+	s_fuzzy *fuzzy = xmalloc(sizeof(s_fuzzy));
+
+	fuzzy->case_insensitive = case_insensitive;
+	fuzzy->len = (int) len;
+
+	fuzzy->max_errors = fuzzy->len / 4;
+
+	if (fuzzy->max_errors > FUZZY_MAX_ERRORS) {
+		fuzzy->max_errors = FUZZY_MAX_ERRORS;
+	}
+
+	for (i = 0; i < FUZZY_ASCII; i++) {
+		fuzzy->ascii[i] = 0;
+	}
+
+	fuzzy->no_chars = 0;
+
+	for (int pos = 0; pos < fuzzy->len; pos++) {
+		const wchar_t chr = fuzzy_fold(fuzzy, pattern[pos]);
+
+		fuzzy->pattern[pos] = chr;
+
+		if ((unsigned) chr < FUZZY_ASCII) {
+			fuzzy->ascii[chr] |= UINT64_C(1) << pos;
+			continue;
+		}
+
+		for (i = 0; i < fuzzy->no_chars && fuzzy->chars[i] != chr; i++);
+
+		if (i == fuzzy->no_chars) {
+			fuzzy->chars[i] = chr;
+			fuzzy->masks[i] = 0;
+			fuzzy->no_chars++;
+		}
+
+		fuzzy->masks[i] |= UINT64_C(1) << pos;
+	}
+
+	fuzzy->pattern[fuzzy->len] = W_STR_TERM;
+
+	log_debug("Pattern: %ls max errors: %d", fuzzy->pattern, fuzzy->max_errors);
+
+	return fuzzy;
+}
+
+/******************************************************************************
+ * The function frees the compiled pattern.
+ *****************************************************************************/
+
+void s_fuzzy_free(s_fuzzy *fuzzy) {
+	free(fuzzy);
+}
+
+/******************************************************************************
+ * The function returns the maximum number of errors of a match.
+ *****************************************************************************/
+
+int s_fuzzy_max_errors(const s_fuzzy *fuzzy) {
+	return fuzzy->max_errors;
+}
+
+/******************************************************************************
+ * The struct contains the state of the algorithm of Myers. The vertical delta
+ * vectors Pv and Mv encode the column of the dynamic programming matrix and
+ * the score is the edit distance of the pattern to the best substring ending
+ * at the current char.
+ *****************************************************************************/
+
+typedef struct s_myers {
+
+	uint64_t pv;
+
+	uint64_t mv;
+
+	uint64_t high_bit;
+
+	int score;
+
+} s_myers;
+
+static inline void myers_init(s_myers *myers, const int len) {
+
+	myers->pv = len == 64 ? UINT64_MAX : (UINT64_C(1) << len) - 1;
+	myers->mv = 0;
+	myers->high_bit = UINT64_C(1) << (len - 1);
+	myers->score = len;
+}
+
+/******************************************************************************
+ * The function processes a char of the string and returns the new score. The
+ * substring can start anywhere, so there is no carry into the first row.
+ *****************************************************************************/
+
+static inline int myers_step(s_myers *myers, const uint64_t eq) {
+
+	const uint64_t xv = eq | myers->mv;
+	const uint64_t xh = (((eq & myers->pv) + myers->pv) ^ myers->pv) | eq;
+
+	uint64_t ph = myers->mv | ~(xh | myers->pv);
+	uint64_t mh = myers->pv & xh;
+
+	if (ph & myers->high_bit) {
+		myers->score++;
+
+	} else if (mh & myers->high_bit) {
+		myers->score--;
+	}
+
+	ph <<= 1;
+	mh <<= 1;
+
+	myers->pv = mh | ~(xv | ph);
+	myers->mv = ph & xv;
+
+	return myers->score;
+}
+
+/******************************************************************************
+ * The function checks whether a string contains an approximate match of the
+ * pattern. It stops with the first match.
+ *****************************************************************************/
+
+bool s_fuzzy_matches(const s_fuzzy *fuzzy, const wchar_t *str) {
+	s_myers myers;
+
+	myers_init(&myers, fuzzy->len);
+
+	for (const wchar_t *ptr = str; *ptr != W_STR_TERM; ptr++) {
+
+		if (myers_step(&myers, fuzzy_mask(fuzzy, fuzzy_fold(fuzzy, *ptr))) <= fuzzy->max_errors) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function computes the start of a match, which ends at the given char
+ * and has the given number of errors. This is done with the dynamic
+ * programming matrix of the reversed pattern and the reversed string, which
+ * is small, because the match is not longer than the pattern plus the errors.
+ * The shortest match is returned.
+ *****************************************************************************/
+
+static const wchar_t* fuzzy_match_start(const s_fuzzy *fuzzy, const wchar_t *start, const wchar_t *end, const int errors) {
+	int row[FUZZY_MAX_LEN + 1];
+	int diag, tmp;
+
+	const int max_width = fuzzy->len + fuzzy->max_errors;
+	const int width = (end - start + 1) < max_width ? (int) (end - start + 1) : max_width;
+
+	const wchar_t *result = end;
+	int best = fuzzy->len + 1;
+
+	//
+	// The row contains the distances of the reversed pattern to the
+	// substrings ending at the end, column by column.
+	//
+	for (int i = 0; i <= fuzzy->len; i++) {
+		row[i] = i;
+	}
+
+	for (int j = 1; j <= width; j++) {
+		const wchar_t chr = fuzzy_fold(fuzzy, *(end - j + 1));
+
+		diag = row[0];
+		row[0] = j;
+
+		for (int i = 1; i <= fuzzy->len; i++) {
+			tmp = row[i];
+
+			row[i] = diag + (fuzzy->pattern[fuzzy->len - i] == chr ? 0 : 1);
+
+			if (row[i - 1] + 1 < row[i]) {
+				row[i] = row[i - 1] + 1;
+			}
+
+			if (tmp + 1 < row[i]) {
+				row[i] = tmp + 1;
+			}
+
+			diag = tmp;
+		}
+
+		if (row[fuzzy->len] < best) {
+			best = row[fuzzy->len];
+			result = end - j + 1;
+
+			if (best <= errors) {
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * The function searches the next approximate match of the pattern in the
+ * string, starting at the offset. From the first char where a match ends,
+ * the search continues as long as there are matches, to find the end with
+ * the fewest errors. The function returns a pointer to the start of the match
+ * and sets the length of the match. If there is no match, the function
+ * returns NULL.
+ *****************************************************************************/
+
+wchar_t* s_fuzzy_search(const s_fuzzy *fuzzy, const wchar_t *str, const size_t offset, size_t *len) {
+	s_myers myers;
+	int score;
+
+	const wchar_t *best_end = NULL;
+	int best_score = fuzzy->max_errors + 1;
+
+	myers_init(&myers, fuzzy->len);
+
+	for (const wchar_t *ptr = str + offset; *ptr != W_STR_TERM; ptr++) {
+
+		score = myers_step(&myers, fuzzy_mask(fuzzy, fuzzy_fold(fuzzy, *ptr)));
+
+		if (score < best_score) {
+			best_score = score;
+			best_end = ptr;
+
+		} else if (best_end != NULL && score > fuzzy->max_errors) {
+			break;
+		}
+	}
+
+	if (best_end == NULL) {
+		return NULL;
+	}
+
+	const wchar_t *start = fuzzy_match_start(fuzzy, str + offset, best_end, best_score);
+
+	*len = best_end - start + 1;
+
+	return (wchar_t*) start;
+}
@@ -0,0 +1,339 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_job.h"
+#include "ncv_common.h"
+
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+/******************************************************************************
+ * The function is the main function of the background thread. It does the
+ * filtering and sorting on the copy of the table and signals the end.
+ *****************************************************************************/
+
+static void* s_job_run(void *ptr) {
+	s_job *job = (s_job*) ptr;
+
+	if (job->count_only) {
+		s_table_count_matches(&job->table);
+		job->result = NULL;
+
+	} else if (job->is_combine) {
+		job->result = s_table_combine_filter(&job->table, &job->cursor, job->combine);
+
+	} else if (job->refine) {
+		job->result = s_table_refine_filter(&job->table, &job->cursor);
+
+	} else {
+		job->result = s_table_update_filter_sort(&job->table, &job->cursor, job->filter_changed, job->sort_changed);
+	}
+
+	pthread_mutex_lock(&job->mutex);
+	job->is_done = true;
+	pthread_cond_signal(&job->cond);
+	pthread_mutex_unlock(&job->mutex);
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function creates the thread of a job, after the job was initialized.
+ *****************************************************************************/
+
+static void s_job_create_thread(s_job *job) {
+
+	job->result = NULL;
+	job->is_done = false;
+
+	atomic_init(&job->progress.cancelled, false);
+	atomic_init(&job->progress.phase, E_PHASE_FILTER);
+	atomic_init(&job->progress.done, 0);
+	atomic_init(&job->progress.total, 0);
+	atomic_init(&job->progress.found, 0);
+
+	if (pthread_mutex_init(&job->mutex, NULL) != 0 || pthread_cond_init(&job->cond, NULL) != 0) {
+		log_exit_str("Unable to init mutex or condition!");
+	}
+
+	if (pthread_create(&job->thread, NULL, s_job_run, job) != 0) {
+		log_exit_str("Unable to create thread!");
+	}
+}
+
+/******************************************************************************
+ * The function copies the table for a job. The copy shares the field data,
+ * but has its own row pointers, row heights, match index and filter.
+ *****************************************************************************/
+
+static void s_job_copy_table(s_job *job, const s_table *table, const s_filter *filter, const s_sort *sort) {
+
+	//
+	// The copy of the table shares the field data, which is not changed by
+	// filtering and sorting.
+	//
+	job->table = *table;
+
+	job->table.fields = xmalloc(sizeof(wchar_t**) * table->__no_rows);
+	memcpy(job->table.fields, table->fields, sizeof(wchar_t**) * table->__no_rows);
+
+	job->table.height = xmalloc(sizeof(int) * table->__no_rows);
+	memcpy(job->table.height, table->height, sizeof(int) * table->__no_rows);
+
+	job->table.matches = NULL;
+	job->table.matches_size = 0;
+
+	//
+	// The filter gets its own compiled regex, expression, fuzzy pattern,
+	// pattern automaton and columns, which are created by the thread.
+	//
+	job->table.filter = *filter;
+	job->table.filter.regex = NULL;
+	job->table.filter.expr = NULL;
+	job->table.filter.fuzzy = NULL;
+	job->table.filter.aho = NULL;
+	job->table.filter.col_bits = NULL;
+	job->table.filter.columns = NULL;
+	job->table.filter.no_columns = 0;
+
+	job->table.sort = *sort;
+
+	job->table.progress = &job->progress;
+}
+
+/******************************************************************************
+ * The function starts a job, which applies a filter and a sorting to the
+ * table. The filter and the sorting are copied, so the table and its filter
+ * and sort structs are unchanged until the job is finished.
+ *****************************************************************************/
+
+void s_job_start(s_job *job, const s_table *table, const s_cursor *cursor, const s_filter *filter, const s_sort *sort, const bool filter_changed, const bool sort_changed) {
+
+	s_job_copy_table(job, table, filter, sort);
+
+	job->cursor = *cursor;
+	job->filter_changed = filter_changed;
+	job->sort_changed = sort_changed;
+
+	//
+	// If only the filter string is extended (typing), the current view is
+	// filtered, instead of the whole table. A combined view is not a result
+	// of the current filter, so it cannot be refined.
+	//
+	job->refine = filter_changed && !sort_changed && !s_table_is_combined(table) && s_filter_is_refinement(&table->filter, filter);
+	job->count_only = false;
+	job->is_combine = false;
+
+	s_job_create_thread(job);
+}
+
+/******************************************************************************
+ * The function starts a job, which indexes all matches of a search, after the
+ * indexing of the table stopped with the first matches. The rows of the table
+ * are not changed by the job.
+ *****************************************************************************/
+
+void s_job_start_count(s_job *job, const s_table *table, const s_cursor *cursor) {
+
+	s_job_copy_table(job, table, &table->filter, &table->sort);
+
+	job->cursor = *cursor;
+	job->filter_changed = false;
+	job->sort_changed = false;
+	job->refine = false;
+	job->count_only = true;
+	job->is_combine = false;
+
+	s_job_create_thread(job);
+}
+
+/******************************************************************************
+ * The function starts a job, which combines the view of the filter with the
+ * rows of the previous filter. The copy of the table gets an empty combined
+ * bitmap, so the bitmap of the table is unchanged until the job is finished.
+ *****************************************************************************/
+
+void s_job_start_combine(s_job *job, const s_table *table, const s_cursor *cursor, const enum e_combine combine) {
+
+	s_job_copy_table(job, table, &table->filter, &table->sort);
+
+	s_bitmap_init(&job->table.combined);
+
+	job->cursor = *cursor;
+	job->filter_changed = false;
+	job->sort_changed = false;
+	job->refine = false;
+	job->count_only = false;
+	job->is_combine = true;
+	job->combine = combine;
+
+	s_job_create_thread(job);
+}
+
+/******************************************************************************
+ * The function waits for the end of the job, at most the given number of
+ * milliseconds. It returns true if the job is done.
+ *****************************************************************************/
+
+bool s_job_wait(s_job *job, const int timeout_ms) {
+	struct timespec abstime;
+	int result = 0;
+
+	clock_gettime(CLOCK_REALTIME, &abstime);
+
+	abstime.tv_nsec += (long) timeout_ms * 1000000L;
+	abstime.tv_sec += abstime.tv_nsec / 1000000000L;
+	abstime.tv_nsec %= 1000000000L;
+
+	pthread_mutex_lock(&job->mutex);
+
+	while (!job->is_done && result != ETIMEDOUT) {
+		result = pthread_cond_timedwait(&job->cond, &job->mutex, &abstime);
+	}
+
+	const bool is_done = job->is_done;
+
+	pthread_mutex_unlock(&job->mutex);
+
+	return is_done;
+}
+
+/******************************************************************************
+ * The function sets the cancel flag of the job. The background thread checks
+ * the flag and stops as soon as possible. The job has to be finished with
+ * s_job_finish().
+ *****************************************************************************/
+
+void s_job_cancel(s_job *job) {
+	log_debug_str("Cancel job.");
+	atomic_store(&job->progress.cancelled, true);
+}
+
+/******************************************************************************
+ * The function waits for the end of the thread. If the job was not cancelled,
+ * the result is published to the table, by swapping the row pointers, the row
+ * heights and the match index. The filter and the sort structs are copied to
+ * the table. The function returns the message of the job. The resources of
+ * the job are freed.
+ *****************************************************************************/
+
+wchar_t* s_job_finish(s_job *job, s_table *table, s_cursor *cursor) {
+	void *tmp;
+
+	if (pthread_join(job->thread, NULL) != 0) {
+		log_exit_str("Unable to join thread!");
+	}
+
+	pthread_mutex_destroy(&job->mutex);
+	pthread_cond_destroy(&job->cond);
+
+	if (atomic_load(&job->progress.cancelled)) {
+		log_debug_str("Job was cancelled.");
+
+		s_filter_free(&job->table.filter);
+		job->result = L"Cancelled!";
+
+	} else if (job->is_combine && job->result != NULL) {
+
+		//
+		// The combination failed, so the table is unchanged.
+		//
+		s_filter_free(&job->table.filter);
+
+	} else if (job->count_only) {
+
+		//
+		// The table gets the complete match index and the filter with the
+		// counts of the patterns of a multi pattern filter.
+		//
+		s_filter_free(&table->filter);
+		table->filter = job->table.filter;
+
+		tmp = table->matches;
+		table->matches = job->table.matches;
+		job->table.matches = tmp;
+
+		table->matches_size = job->table.matches_size;
+		table->is_counting = false;
+
+	} else {
+
+		//
+		// The table gets the filter with the compiled regex, expression, fuzzy
+		// pattern or pattern automaton of the job.
+		//
+		s_filter_free(&table->filter);
+		table->filter = job->table.filter;
+		table->sort = job->table.sort;
+
+		//
+		// Swap the arrays, so the old arrays are freed with the job.
+		//
+		tmp = table->fields;
+		table->fields = job->table.fields;
+		job->table.fields = tmp;
+
+		tmp = table->height;
+		table->height = job->table.height;
+		job->table.height = tmp;
+
+		tmp = table->matches;
+		table->matches = job->table.matches;
+		job->table.matches = tmp;
+
+		table->matches_size = job->table.matches_size;
+		table->no_rows = job->table.no_rows;
+		table->view = job->table.view;
+		table->is_counting = job->table.is_counting;
+
+		//
+		// A combined view is replaced by the result of a new filter.
+		//
+		if (job->filter_changed) {
+			s_bitmap_free(&table->combined);
+		}
+
+		//
+		// The table gets the bitmap of the combined view of the job.
+		//
+		if (job->is_combine) {
+			s_bitmap_free(&table->combined);
+			table->combined = job->table.combined;
+			s_bitmap_init(&job->table.combined);
+		}
+
+		s_cursor_pos(cursor, job->cursor.row, job->cursor.col);
+	}
+
+	free(job->table.fields);
+	free(job->table.height);
+	free(job->table.matches);
+
+	if (job->is_combine) {
+		s_bitmap_free(&job->table.combined);
+	}
+
+	return job->result;
+}
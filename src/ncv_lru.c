@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_lru.h"
+#include "ncv_common.h"
+
+/******************************************************************************
+ * The function initializes an empty cache.
+ *****************************************************************************/
+
+void s_lru_init(s_lru *lru) {
+
+	lru->no_entries = 0;
+	lru->clock = 0;
+}
+
+/******************************************************************************
+ * The function frees the keys and the bitmaps of the entries.
+ *****************************************************************************/
+
+void s_lru_free(s_lru *lru) {
+
+	for (int i = 0; i < lru->no_entries; i++) {
+		free(lru->entries[i].key);
+		s_bitmap_free(&lru->entries[i].bitmap);
+	}
+
+	s_lru_init(lru);
+}
+
+/******************************************************************************
+ * The function returns the bitmap of the entry with the key, which is marked
+ * as used, or NULL if there is no such entry.
+ *****************************************************************************/
+
+const s_bitmap* s_lru_get(s_lru *lru, const wchar_t *key) {
+
+	for (int i = 0; i < lru->no_entries; i++) {
+
+		if (wcscmp(lru->entries[i].key, key) == 0) {
+			lru->entries[i].used = ++lru->clock;
+
+			log_debug("Found: %ls", key);
+			return &lru->entries[i].bitmap;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function adds a bitmap with a key to the cache. The cache takes the
+ * ownership of the bitmap, which is empty afterwards. An entry with the same
+ * key or the least recently used entry of a full cache is replaced.
+ *****************************************************************************/
+
+void s_lru_put(s_lru *lru, const wchar_t *key, s_bitmap *bitmap) {
+	s_lru_entry *entry = NULL;
+
+	for (int i = 0; i < lru->no_entries; i++) {
+
+		if (wcscmp(lru->entries[i].key, key) == 0) {
+			entry = &lru->entries[i];
+			break;
+		}
+
+		if (lru->no_entries == LRU_SIZE && (entry == NULL || lru->entries[i].used < entry->used)) {
+			entry = &lru->entries[i];
+		}
+	}
+
+	if (entry == NULL) {
+		entry = &lru->entries[lru->no_entries++];
+
+	} else {
+		log_debug("Replace: %ls", entry->key);
+
+		free(entry->key);
+		s_bitmap_free(&entry->bitmap);
+	}
+
+	entry->key = xmalloc(sizeof(wchar_t) * (wcslen(key) + 1));
+	wcscpy(entry->key, key);
+
+	entry->bitmap = *bitmap;
+	s_bitmap_init(bitmap);
+
+	entry->used = ++lru->clock;
+}
+
+/******************************************************************************
+ * The function returns the bitmap of the most recently used entry, that has
+ * not the given key, or NULL if there is no such entry.
+ *****************************************************************************/
+
+const s_bitmap* s_lru_get_other(const s_lru *lru, const wchar_t *key) {
+	const s_lru_entry *entry = NULL;
+
+	for (int i = 0; i < lru->no_entries; i++) {
+
+		if (wcscmp(lru->entries[i].key, key) != 0 && (entry == NULL || lru->entries[i].used > entry->used)) {
+			entry = &lru->entries[i];
+		}
+	}
+
+	return entry == NULL ? NULL : &entry->bitmap;
+}
@@ -0,0 +1,685 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_num.h"
+#include "ncv_common.h"
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <locale.h>
+
+/******************************************************************************
+ * The function initializes a s_num_column, which is not parsed.
+ *****************************************************************************/
+
+void s_num_column_init(s_num_column *column) {
+
+	column->is_parsed = false;
+
+	column->values = NULL;
+	column->suffixes = NULL;
+	column->type = E_NUM_TYPE_STR;
+	column->suffix = NULL;
+	column->first_has_type = false;
+	column->date_fmt = (s_date_fmt ) { E_DATE_YMD, L'-' };
+	column->valid = NULL;
+	column->empty = NULL;
+
+	column->block_min = NULL;
+	column->block_max = NULL;
+}
+
+/******************************************************************************
+ * The function frees the parsed values of the column.
+ *****************************************************************************/
+
+void s_num_column_free(s_num_column *column) {
+
+	free(column->values);
+	free(column->suffixes);
+	free(column->valid);
+	free(column->empty);
+
+	free(column->block_min);
+	free(column->block_max);
+
+	s_num_column_init(column);
+}
+
+/******************************************************************************
+ * The powers of 10, that are exact double values.
+ *****************************************************************************/
+
+#define NUM_MAX_POW 22
+
+static const double pow_10[NUM_MAX_POW + 1] = {
+
+1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+
+1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/******************************************************************************
+ * The maximum number of digits of the mantissa, which fit into an uint64_t,
+ * and the maximum mantissa, that is an exact double value.
+ *****************************************************************************/
+
+#define NUM_MAX_DIGITS 19
+
+#define NUM_MAX_MANTISSA (UINT64_C(1) << 53)
+
+#define is_digit(c) ((c) >= L'0' && (c) <= L'9')
+
+/******************************************************************************
+ * The function returns the decimal point of the current locale, which is used
+ * by wcstod. If the decimal point is not a single char, the function returns
+ * W_STR_TERM.
+ *****************************************************************************/
+
+wchar_t s_num_decimal_point() {
+
+	const char *point = localeconv()->decimal_point;
+
+	if (point[0] == '\0' || point[1] != '\0') {
+		return W_STR_TERM;
+	}
+
+	const wint_t chr = btowc((unsigned char) point[0]);
+
+	return chr == WEOF ? W_STR_TERM : (wchar_t) chr;
+}
+
+/******************************************************************************
+ * The function converts the common forms of numbers, which are integers and
+ * decimals with the decimal point of the locale, like: "-12", "3.25" or
+ * "1000,00 Euro". The mantissa is an integer with at most 2^53 and the
+ * exponent is the number of decimals. Both are exact double values, so the
+ * result of the multiplication or division is correctly rounded (Clinger's
+ * fast path) and identical to the result of wcstod. The function returns
+ * false if the string has an other form.
+ *****************************************************************************/
+
+static bool num_parse_fast(const wchar_t *str, const wchar_t decimal, double *value, const wchar_t **suffix) {
+	uint64_t mantissa = 0;
+	int no_digits = 0;
+	int exponent = 0;
+	bool has_digits = false;
+
+	const wchar_t *ptr = str;
+
+	const bool is_neg = *ptr == L'-';
+
+	if (*ptr == L'-' || *ptr == L'+') {
+		ptr++;
+	}
+
+	//
+	// The integer part. Leading zeros are not counted as digits.
+	//
+	for (; is_digit(*ptr); ptr++) {
+		has_digits = true;
+
+		if (mantissa > 0 || *ptr != L'0') {
+			if (++no_digits > NUM_MAX_DIGITS) {
+				return false;
+			}
+			mantissa = 10 * mantissa + (uint64_t) (*ptr - L'0');
+		}
+	}
+
+	//
+	// The fractional part
+	//
+	if (*ptr == decimal && decimal != W_STR_TERM) {
+
+		for (ptr++; is_digit(*ptr); ptr++) {
+			has_digits = true;
+			exponent++;
+
+			if (mantissa > 0 || *ptr != L'0') {
+				if (++no_digits > NUM_MAX_DIGITS) {
+					return false;
+				}
+				mantissa = 10 * mantissa + (uint64_t) (*ptr - L'0');
+			}
+		}
+	}
+
+	//
+	// Exponents, hex numbers, infinity and nan are left to wcstod.
+	//
+	if (!has_digits || *ptr == L'e' || *ptr == L'E' || *ptr == L'x' || *ptr == L'X') {
+		return false;
+	}
+
+	if (mantissa > NUM_MAX_MANTISSA || exponent > NUM_MAX_POW) {
+		return false;
+	}
+
+	*value = (double) mantissa / pow_10[exponent];
+
+	if (is_neg) {
+		*value = -*value;
+	}
+
+	*suffix = ptr;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function converts a string to a double value with the decimal point of
+ * the locale. The common forms are converted by a fast parser and the others
+ * by wcstod. The string can have a non numerical suffix, which is returned.
+ * The function returns false if the string does not start with a number or
+ * if the conversion failed, for example with an overflow.
+ *****************************************************************************/
+
+bool s_num_parse_dec(const wchar_t *str, const wchar_t decimal, double *value, const wchar_t **suffix) {
+	wchar_t *tailptr;
+
+	if (num_parse_fast(str, decimal, value, suffix)) {
+		return true;
+	}
+
+	//
+	// Set errno to 0 to be able to detect errors and to the conversion.
+	//
+	errno = 0;
+	*value = wcstod(str, &tailptr);
+
+	if (errno != 0) {
+		log_debug("Unable to convert: '%ls' - %s", str, strerror(errno));
+		return false;
+	}
+
+	//
+	// If the tail pointer is equal to the string, no conversion was possible.
+	//
+	if (tailptr == str) {
+		return false;
+	}
+
+	*suffix = tailptr;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function converts a string to a double value. The string can have a non
+ * numerical suffix, which is returned. The function returns false if the
+ * string does not start with a number or if the conversion failed, for
+ * example with an overflow.
+ *****************************************************************************/
+
+bool s_num_parse(const wchar_t *str, double *value, const wchar_t **suffix) {
+	return s_num_parse_dec(str, s_num_decimal_point(), value, suffix);
+}
+
+/******************************************************************************
+ * The function converts a field of a column to a double value. A field is a
+ * number or a boolean, which is 1 for true and 0 for false. The suffix of a
+ * boolean is the end of the string.
+ *****************************************************************************/
+
+bool s_num_parse_field(const wchar_t *str, const wchar_t decimal, double *value, const wchar_t **suffix, bool *is_bool) {
+
+	*is_bool = false;
+
+	if (s_num_parse_dec(str, decimal, value, suffix)) {
+		return true;
+	}
+
+	if (wcscasecmp(str, L"true") == 0) {
+		*value = 1;
+
+	} else if (wcscasecmp(str, L"false") == 0) {
+		*value = 0;
+
+	} else {
+		return false;
+	}
+
+	*suffix = str + wcslen(str);
+	*is_bool = true;
+
+	return true;
+}
+
+/******************************************************************************
+ * The function initializes the inference of the type of a column.
+ *****************************************************************************/
+
+void s_num_infer_init(s_num_infer *infer) {
+
+	infer->no_values = 0;
+	infer->no_nums = 0;
+	infer->no_ints = 0;
+	infer->no_bools = 0;
+
+	infer->suffix = NULL;
+	infer->same_suffix = true;
+}
+
+/******************************************************************************
+ * The function compares two suffixes. Most columns have no suffix, so the
+ * first char decides in most cases.
+ *****************************************************************************/
+
+static bool suffix_equals(const wchar_t *suffix1, const wchar_t *suffix2) {
+	return *suffix1 == *suffix2 && (*suffix1 == W_STR_TERM || wcscmp(suffix1, suffix2) == 0);
+}
+
+/******************************************************************************
+ * The function adds a value of the column, that is not empty, to the
+ * inference. If the value is not a number or a boolean, the suffix is NULL.
+ *****************************************************************************/
+
+void s_num_infer_add(s_num_infer *infer, const double value, const wchar_t *suffix, const bool is_bool) {
+
+	infer->no_values++;
+
+	if (suffix == NULL) {
+		return;
+	}
+
+	if (is_bool) {
+		infer->no_bools++;
+		return;
+	}
+
+	infer->no_nums++;
+
+	if (value == trunc(value)) {
+		infer->no_ints++;
+	}
+
+	if (infer->suffix == NULL) {
+		infer->suffix = suffix;
+
+	} else if (infer->same_suffix && !suffix_equals(infer->suffix, suffix)) {
+		infer->same_suffix = false;
+	}
+}
+
+/******************************************************************************
+ * The function returns the type of a column. A column without values is a
+ * string column.
+ *****************************************************************************/
+
+enum e_num_type s_num_infer_type(const s_num_infer *infer) {
+
+	if (infer->no_values == 0) {
+		return E_NUM_TYPE_STR;
+	}
+
+	if (infer->no_bools == infer->no_values) {
+		return E_NUM_TYPE_BOOL;
+	}
+
+	if (infer->no_nums == infer->no_values && infer->same_suffix) {
+		return infer->no_ints == infer->no_nums ? E_NUM_TYPE_INT : E_NUM_TYPE_FLOAT;
+	}
+
+	return E_NUM_TYPE_STR;
+}
+
+/******************************************************************************
+ * The function checks whether a string, that is not part of the inference,
+ * has the type of the column. Empty strings match every type.
+ *****************************************************************************/
+
+bool s_num_infer_matches(const s_num_infer *infer, const wchar_t *str, const wchar_t decimal) {
+	const wchar_t *suffix;
+	double value;
+	bool is_bool;
+
+	if (wcs_is_empty(str)) {
+		return true;
+	}
+
+	const enum e_num_type type = s_num_infer_type(infer);
+
+	if (type == E_NUM_TYPE_STR) {
+		return true;
+	}
+
+	if (!s_num_parse_field(str, decimal, &value, &suffix, &is_bool)) {
+		return false;
+	}
+
+	if (type == E_NUM_TYPE_BOOL) {
+		return is_bool;
+	}
+
+	return !is_bool && suffix_equals(infer->suffix, suffix) && (type == E_NUM_TYPE_FLOAT || value == trunc(value));
+}
+
+/******************************************************************************
+ * The function converts a field of a date column to the seconds since
+ * 1970-01-01, which are exact double values. The suffix of a date is the end
+ * of the string.
+ *****************************************************************************/
+
+static bool parse_date_field(const s_date_fmt *fmt, const wchar_t *str, double *value, const wchar_t **suffix) {
+	int64_t epoch;
+
+	if (!s_date_parse(fmt, str, &epoch)) {
+		return false;
+	}
+
+	*value = (double) epoch;
+	*suffix = str + wcslen(str);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses the rows of a column into the allocated arrays of the
+ * column and collects the characteristics for the inference of the type. If
+ * a date format is given, the fields are parsed as dates, otherwise as
+ * numbers. The function returns false if the parsing was cancelled.
+ *****************************************************************************/
+
+static bool parse_rows(s_num_column *column, s_num_infer *infer, wchar_t ***rows, const int no_rows, const int col, const s_date_fmt *date_fmt, s_progress *progress) {
+	const wchar_t *suffix;
+	bool is_bool = false;
+	bool is_valid;
+
+	const int words = s_num_bitmap_words(no_rows);
+	const int no_blocks = s_blocks_count(no_rows);
+
+	memset(column->valid, 0, sizeof(uint64_t) * words);
+	memset(column->empty, 0, sizeof(uint64_t) * words);
+
+	for (int block = 0; block < no_blocks; block++) {
+		column->block_min[block] = INFINITY;
+		column->block_max[block] = -INFINITY;
+	}
+
+	s_num_infer_init(infer);
+
+	//
+	// The decimal point of the locale is used by the fast parser.
+	//
+	const wchar_t decimal = s_num_decimal_point();
+
+	double *values = column->values;
+
+	for (int row = 0; row < no_rows; row++) {
+
+		//
+		// On cancel, the partial result is thrown away.
+		//
+		if (s_progress_is_cancelled(progress)) {
+			return false;
+		}
+
+		values[row] = NAN;
+		column->suffixes[row] = NULL;
+
+		if (wcs_is_empty(rows[row][col])) {
+			column->empty[row >> 6] |= UINT64_C(1) << (row & 63);
+			continue;
+		}
+
+		if (date_fmt != NULL) {
+			is_valid = parse_date_field(date_fmt, rows[row][col], &values[row], &suffix);
+		} else {
+			is_valid = s_num_parse_field(rows[row][col], decimal, &values[row], &suffix, &is_bool);
+		}
+
+		if (!is_valid) {
+
+			//
+			// A failed conversion can return a value.
+			//
+			values[row] = NAN;
+
+			if (row > 0) {
+				s_num_infer_add(infer, NAN, NULL, false);
+			}
+
+			continue;
+		}
+
+		column->valid[row >> 6] |= UINT64_C(1) << (row & 63);
+		column->suffixes[row] = suffix;
+
+		//
+		// The first row can be a header, so it is not part of the inference.
+		//
+		if (row > 0) {
+			s_num_infer_add(infer, values[row], suffix, is_bool);
+		}
+
+		if (values[row] < column->block_min[s_blocks_of_row(row)]) {
+			column->block_min[s_blocks_of_row(row)] = values[row];
+		}
+
+		if (values[row] > column->block_max[s_blocks_of_row(row)]) {
+			column->block_max[s_blocks_of_row(row)] = values[row];
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function parses the values of a column of the table. The rows are the
+ * unfiltered rows, so the values can be accessed with the index of the row.
+ * The parsing can be cancelled, in which case the function returns false and
+ * the column is unchanged.
+ *
+ * The date format of the column is detected with a sample. If all fields are
+ * dates with that format, the values are the seconds since 1970-01-01. If a
+ * field, that is not part of the sample, is not a date with that format, the
+ * format is narrowed to the formats of the sample, that parse the field, and
+ * the column is parsed again. If no format is left, the column is parsed
+ * again as numbers.
+ *****************************************************************************/
+
+bool s_num_column_parse(s_num_column *column, wchar_t ***rows, const int no_rows, const int col, s_progress *progress) {
+	unsigned int candidates;
+	s_date_fmt date_fmt;
+	s_num_infer infer;
+
+	if (column->is_parsed) {
+		return true;
+	}
+
+	const int words = s_num_bitmap_words(no_rows);
+	const int no_blocks = s_blocks_count(no_rows);
+
+	column->values = xmalloc(sizeof(double) * no_rows);
+	column->suffixes = xmalloc(sizeof(wchar_t*) * no_rows);
+
+	column->valid = xmalloc(sizeof(uint64_t) * words);
+	column->empty = xmalloc(sizeof(uint64_t) * words);
+
+	column->block_min = xmalloc(sizeof(double) * no_blocks);
+	column->block_max = xmalloc(sizeof(double) * no_blocks);
+
+	//
+	// The sample does not contain the first row, which can be a header.
+	//
+	bool is_date = no_rows > 1 && s_date_detect(rows, 1, no_rows, col, &candidates, &date_fmt);
+
+	while (is_date) {
+
+		if (!parse_rows(column, &infer, rows, no_rows, col, &date_fmt, progress)) {
+			s_num_column_free(column);
+			return false;
+		}
+
+		if (infer.no_nums == infer.no_values) {
+			break;
+		}
+
+		//
+		// Narrow the format with the first field after the first row, that
+		// is not a date with the format. Each pass removes at least the
+		// current format from the candidates.
+		//
+		int row = 1;
+
+		while (s_num_bit(column->valid, row) || s_num_bit(column->empty, row)) {
+			row++;
+		}
+
+		is_date = s_date_narrow(&candidates, rows[row][col], &date_fmt);
+
+		log_debug("Column: %d row: %d is not a date, narrowed: %d", col, row, is_date);
+	}
+
+	if (!is_date && !parse_rows(column, &infer, rows, no_rows, col, NULL, progress)) {
+		s_num_column_free(column);
+		return false;
+	}
+
+	if (is_date) {
+		column->type = E_NUM_TYPE_DATE;
+		column->date_fmt = date_fmt;
+		column->first_has_type = no_rows > 0 && (s_num_bit(column->empty, 0) || s_num_bit(column->valid, 0));
+
+	} else {
+		column->type = s_num_infer_type(&infer);
+		column->first_has_type = no_rows > 0 && s_num_infer_matches(&infer, rows[0][col], s_num_decimal_point());
+	}
+
+	column->suffix = infer.suffix;
+	column->is_parsed = true;
+
+	log_debug("Parsed column: %d rows: %d type: %d", col, no_rows, column->type);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function initializes a range of values of a column. The bitmap is not
+ * created.
+ *****************************************************************************/
+
+void s_num_range_init(s_num_range *range, const int column, const double min, const bool min_incl, const double max, const bool max_incl) {
+
+	range->column = column;
+
+	range->min = min;
+	range->min_incl = min_incl;
+
+	range->max = max;
+	range->max_incl = max_incl;
+
+	range->is_date = false;
+	range->date_fmt = (s_date_fmt ) { E_DATE_YMD, L'-' };
+
+	range->bitmap = NULL;
+	range->blocks = NULL;
+}
+
+/******************************************************************************
+ * The function frees the bitmap of the range.
+ *****************************************************************************/
+
+void s_num_range_free(s_num_range *range) {
+
+	free(range->bitmap);
+	range->bitmap = NULL;
+
+	free(range->blocks);
+	range->blocks = NULL;
+}
+
+/******************************************************************************
+ * The function checks whether a value is in the range.
+ *****************************************************************************/
+
+bool s_num_range_matches(const s_num_range *range, const double value) {
+
+	if (range->min_incl ? value < range->min : value <= range->min) {
+		return false;
+	}
+
+	return range->max_incl ? value <= range->max : value < range->max;
+}
+
+/******************************************************************************
+ * The function creates the bitmap of the rows with a value in the range and
+ * the bitmap of the blocks with such rows. Blocks with a minimum and maximum
+ * outside of the range are skipped. The bounds are converted to inclusive
+ * bounds, so the inner loop is branch free and can be vectorized by the
+ * compiler. Invalid values are NaN, which do not match any comparison.
+ *****************************************************************************/
+
+void s_num_range_apply(s_num_range *range, const s_num_column *column, const int no_rows) {
+	uint64_t bits;
+	uint64_t any;
+	int end;
+
+	const double lo = range->min_incl ? range->min : nextafter(range->min, INFINITY);
+	const double hi = range->max_incl ? range->max : nextafter(range->max, -INFINITY);
+
+	const double *values = column->values;
+
+	const int words = s_num_bitmap_words(no_rows);
+	const int no_blocks = s_blocks_count(no_rows);
+
+	s_num_range_free(range);
+
+	range->is_date = column->type == E_NUM_TYPE_DATE;
+	range->date_fmt = column->date_fmt;
+
+	range->bitmap = xmalloc(sizeof(uint64_t) * words);
+	memset(range->bitmap, 0, sizeof(uint64_t) * words);
+
+	range->blocks = xmalloc(sizeof(uint64_t) * s_num_bitmap_words(no_blocks));
+	memset(range->blocks, 0, sizeof(uint64_t) * s_num_bitmap_words(no_blocks));
+
+	for (int block = 0; block < no_blocks; block++) {
+
+		if (column->block_max[block] < lo || column->block_min[block] > hi) {
+			continue;
+		}
+
+		const int block_end = (block + 1) * BLOCK_ROWS < no_rows ? (block + 1) * BLOCK_ROWS : no_rows;
+		any = 0;
+
+		for (int start = block * BLOCK_ROWS; start < block_end; start += 64) {
+			end = block_end - start < 64 ? block_end - start : 64;
+			bits = 0;
+
+			for (int i = 0; i < end; i++) {
+				bits |= (uint64_t) ((values[start + i] >= lo) & (values[start + i] <= hi)) << i;
+			}
+
+			range->bitmap[start >> 6] = bits;
+			any |= bits;
+		}
+
+		if (any != 0) {
+			range->blocks[block >> 6] |= UINT64_C(1) << (block & 63);
+		}
+	}
+}
@@ -25,10 +25,13 @@
 #include "ncv_wbuf.h"
 #include "ncv_parser.h"
 #include "ncv_table.h"
+#include "ncv_sample.h"
 #include "ncv_common.h"
 
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <unistd.h>
 
 #define MAX_FIELD_SIZE 4096
 
@@ -71,8 +74,45 @@ typedef struct s_csv_parser {
 	wchar_t field[MAX_FIELD_SIZE];
 	int field_idx;
 
+	//
+	// If the csv file is sampled, the fields are added to the sample instead
+	// of the table.
+	//
+	s_sample *sample;
+
 } s_csv_parser;
 
+/******************************************************************************
+ * The struct is the source of the chars of the csv file. It is either a
+ * s_wbuf with the content of the file or the file itself, which is read as a
+ * stream.
+ *****************************************************************************/
+
+typedef struct s_csv_reader {
+
+	s_wbuf *wbuf;
+
+	s_wbuf_pos pos;
+
+	FILE *file;
+
+} s_csv_reader;
+
+/******************************************************************************
+ * The function reads the next char from the reader. It returns false at the
+ * end of the data.
+ *****************************************************************************/
+
+static bool csv_reader_next(s_csv_reader *reader, wchar_t *wchr) {
+
+	if (reader->file != NULL) {
+		*wchr = read_wchar(reader->file);
+		return !feof(reader->file);
+	}
+
+	return s_wbuf_next(reader->wbuf, &reader->pos, wchr);
+}
+
 /******************************************************************************
  * The marco resets the parser field
  *****************************************************************************/
@@ -136,6 +176,8 @@ static void s_csv_parser_init(s_csv_parser *csv_parser, const bool do_count) {
 	csv_parser->current_row = 0;
 	csv_parser->current_column = 0;
 
+	csv_parser->sample = NULL;
+
 	//
 	// In the do_count phase, the number of rows and columns is computed, so we
 	// have to ensure that the data is not overwritten in the second phase.
@@ -309,10 +351,27 @@ static void add_missing_fields(s_csv_parser *csv_parser, const s_cfg_parser *cfg
 
 static void process_column_end(s_csv_parser *csv_parser, const s_cfg_parser *cfg_parser, const bool is_row_end, s_table *table) {
 
+	//
+	// On sampling, the field is added to the sample, if the row is kept. The
+	// strict mode checks the number of columns of all rows.
+	//
+	if (csv_parser->sample != NULL) {
+
+		if (cfg_parser->strict) {
+			update_no_rows_cols_strict(csv_parser, is_row_end);
+		}
+
+		if (csv_parser->current_column == 0) {
+			s_sample_start_row(csv_parser->sample);
+		}
+
+		s_sample_add_field(csv_parser->sample, parser_field_get_str(csv_parser, cfg_parser));
+	}
+
 	//
 	// In the "do_count" phase, we try to determine no_rows and no_columns.
 	//
-	if (csv_parser->do_count) {
+	else if (csv_parser->do_count) {
 
 		if (cfg_parser->strict) {
 			update_no_rows_cols_strict(csv_parser, is_row_end);
@@ -351,12 +410,13 @@ static void process_column_end(s_csv_parser *csv_parser, const s_cfg_parser *cfg
 }
 
 /******************************************************************************
- * The function parses a s_wbuf. It is called twice. The first time it counts
- * the columns and rows. And the second time it copies the csv fields to the
- * table structure.
+ * The function parses the chars of a reader. For a s_wbuf it is called twice.
+ * The first time it counts the columns and rows. And the second time it
+ * copies the csv fields to the table structure. On sampling, the file is
+ * parsed once.
  *****************************************************************************/
 
-static void parse_csv_wbuf(s_wbuf *wbuf, const s_cfg_parser *cfg_parser, s_csv_parser *csv_parser, s_table *table) {
+static void parse_csv(s_csv_reader *reader, const s_cfg_parser *cfg_parser, s_csv_parser *csv_parser, s_table *table) {
 
 	//
 	// The two parameters hold the current and the last char read from the
@@ -364,17 +424,11 @@ static void parse_csv_wbuf(s_wbuf *wbuf, const s_cfg_parser *cfg_parser, s_csv_p
 	//
 	wchar_t wchar_last, wchar_cur = W_STR_TERM;
 
-	//
-	// Provide a s_wbuf position and initialize it.
-	//
-	s_wbuf_pos cur_pos;
-	s_wbuf_pos_init(&cur_pos);
-
 	while (true) {
 
 		wchar_last = wchar_cur;
 
-		if (!s_wbuf_next(wbuf, &cur_pos, &wchar_cur)) {
+		if (!csv_reader_next(reader, &wchar_cur)) {
 
 			//
 			// If we finished processing and it is still escaped, then a
@@ -441,7 +495,7 @@ static void parse_csv_wbuf(s_wbuf *wbuf, const s_cfg_parser *cfg_parser, s_csv_p
 				//
 				// Found quote followed by EOF
 				//
-				if (!s_wbuf_next(wbuf, &cur_pos, &wchar_cur)) {
+				if (!csv_reader_next(reader, &wchar_cur)) {
 					process_column_end(csv_parser, cfg_parser, true, table);
 					break;
 
@@ -477,6 +531,102 @@ static void parse_csv_wbuf(s_wbuf *wbuf, const s_cfg_parser *cfg_parser, s_csv_p
 	}
 }
 
+/******************************************************************************
+ * The function returns the number of fields of a row of the sample. In the non
+ * strict mode, empty fields at the end of the row are ignored.
+ *****************************************************************************/
+
+static int sample_row_no_fields(const s_sample_row *row, const s_cfg_parser *cfg_parser) {
+	int no_fields = row->no_fields;
+
+	if (!cfg_parser->strict) {
+
+		while (no_fields > 0 && wcs_is_empty(row->fields[no_fields - 1])) {
+			no_fields--;
+		}
+	}
+
+	return no_fields;
+}
+
+/******************************************************************************
+ * The function copies a row of the sample to the table. The first column is
+ * the number of the row in the csv file. Missing fields are added.
+ *****************************************************************************/
+
+static void sample_row_copy(s_table *table, const int row, const s_sample_row *sample_row) {
+	wchar_t number[32];
+
+	swprintf(number, 32, L"%ld", sample_row->number);
+	s_table_copy(table, row, 0, number);
+
+	for (int column = 1; column < table->no_columns; column++) {
+		s_table_copy(table, row, column, column - 1 < sample_row->no_fields ? sample_row->fields[column - 1] : L"");
+	}
+}
+
+/******************************************************************************
+ * The function reads the csv file as a stream and creates a table with a
+ * uniform random sample of the rows. The first row, which may be the header,
+ * is always part of the table. The rows are in the order of the csv file and
+ * the first column of the table is the number of the row in the csv file. The
+ * file is not copied to memory, only the rows of the sample are stored.
+ *****************************************************************************/
+
+static void parser_sample_file(FILE *file, const s_cfg_parser *cfg_parser, s_table *table) {
+	s_csv_parser csv_parser;
+	s_sample sample;
+
+	s_csv_reader reader = { .wbuf = NULL, .file = file };
+
+	s_sample_init(&sample, cfg_parser->sample, (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32));
+
+	//
+	// Parse the csv file and add the fields to the sample.
+	//
+	s_csv_parser_init(&csv_parser, true);
+	csv_parser.sample = &sample;
+	parse_csv(&reader, cfg_parser, &csv_parser, table);
+
+	s_sample_sort(&sample);
+
+	log_debug("Rows read: %ld sampled: %d", sample.no_read, sample.no_rows);
+
+	//
+	// The number of columns is the maximum of the rows of the sample.
+	//
+	int no_columns = sample_row_no_fields(&sample.first, cfg_parser);
+
+	for (int row = 0; row < sample.no_rows; row++) {
+		const int no_fields = sample_row_no_fields(&sample.rows[row], cfg_parser);
+
+		if (no_fields > no_columns) {
+			no_columns = no_fields;
+		}
+	}
+
+	//
+	// A file without data results in an empty table.
+	//
+	const int no_rows = no_columns > 0 ? sample.no_rows + 1 : 0;
+
+	s_table_init(table, no_rows, no_columns > 0 ? no_columns + 1 : 0);
+
+	if (no_rows > 0) {
+		sample_row_copy(table, 0, &sample.first);
+
+		for (int row = 0; row < sample.no_rows; row++) {
+			sample_row_copy(table, row + 1, &sample.rows[row]);
+		}
+	}
+
+	s_sample_free(&sample);
+
+	s_table_reset_rows(table);
+
+	s_blocks_create(&table->blocks, table->__fields, table->__no_rows, table->no_columns);
+}
+
 /******************************************************************************
  * The function parses the csv file twice. The fist time it determines the
  * number of rows and columns. Then the table structure allocates fields
@@ -486,6 +636,11 @@ static void parse_csv_wbuf(s_wbuf *wbuf, const s_cfg_parser *cfg_parser, s_csv_p
 
 void parser_process_file(FILE *file, const s_cfg_parser *cfg_parser, s_table *table) {
 
+	if (cfg_parser->sample > 0) {
+		parser_sample_file(file, cfg_parser, table);
+		return;
+	}
+
 	//
 	// Create a s_wbuf with the content of the file
 	//
@@ -494,11 +649,14 @@ void parser_process_file(FILE *file, const s_cfg_parser *cfg_parser, s_table *ta
 
 	s_csv_parser csv_parser;
 
+	s_csv_reader reader = { .wbuf = wbuf, .file = NULL };
+
 	//
 	// Parse the csv file to get the number of columns and rows.
 	//
 	s_csv_parser_init(&csv_parser, true);
-	parse_csv_wbuf(wbuf, cfg_parser, &csv_parser, table);
+	s_wbuf_pos_init(&reader.pos);
+	parse_csv(&reader, cfg_parser, &csv_parser, table);
 
 	log_debug("No rows: %d no columns: %d", csv_parser.no_rows, csv_parser.no_columns);
 
@@ -511,13 +669,19 @@ void parser_process_file(FILE *file, const s_cfg_parser *cfg_parser, s_table *ta
 	// Parse the csv file again to copy the fields to the table structure.
 	//
 	s_csv_parser_init(&csv_parser, false);
-	parse_csv_wbuf(wbuf, cfg_parser, &csv_parser, table);
+	s_wbuf_pos_init(&reader.pos);
+	parse_csv(&reader, cfg_parser, &csv_parser, table);
 
 	//
 	// Init the table rows and heights
 	//
 	s_table_reset_rows(table);
 
+	//
+	// Create the summaries of the blocks of rows for the filtering.
+	//
+	s_blocks_create(&table->blocks, table->__fields, table->__no_rows, table->no_columns);
+
 	//
 	// Free the allocated s_wbuf
 	//
@@ -0,0 +1,304 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_psort.h"
+#include "ncv_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/******************************************************************************
+ * The s_psort_task struct is the argument of a thread of the parallel sort. A
+ * thread either sorts a run of elements in place or merges the part of two
+ * adjacent sorted runs, that is given by the diagonals of the merge path.
+ *****************************************************************************/
+
+typedef struct s_psort_task {
+
+	//
+	// The flag indicates that the task is a merge.
+	//
+	bool is_merge;
+
+	//
+	// The run to sort or the two runs to merge and the destination of the
+	// merge.
+	//
+	char *src_1;
+
+	size_t len_1;
+
+	char *src_2;
+
+	size_t len_2;
+
+	char *dst;
+
+	//
+	// The part of the merged runs, that is done by the task.
+	//
+	size_t diag_start;
+
+	size_t diag_end;
+
+	//
+	// The element size, the comparison and its argument.
+	//
+	size_t size;
+
+	psort_cmp cmp;
+
+	void *arg;
+
+} s_psort_task;
+
+/******************************************************************************
+ * The function returns the number of threads for a parallel sort, which is
+ * the number of online processors.
+ *****************************************************************************/
+
+int psort_threads() {
+
+	const long no_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (no_cpus < 1) {
+		return 1;
+	}
+
+	return no_cpus > PSORT_MAX_THREADS ? PSORT_MAX_THREADS : (int) no_cpus;
+}
+
+/******************************************************************************
+ * The function computes the number of elements of the first run, that are
+ * part of the first diag elements of the merged runs. This is the point of
+ * the merge path on the diagonal. On equal elements, the element of the
+ * first run comes first, so the merge is stable.
+ *****************************************************************************/
+
+static size_t psort_co_rank(const s_psort_task *task, const size_t diag) {
+
+	size_t lo = diag > task->len_2 ? diag - task->len_2 : 0;
+	size_t hi = diag < task->len_1 ? diag : task->len_1;
+	size_t mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+
+		//
+		// If the element of the first run comes before the element of the
+		// second run, more elements of the first run are part of the diag.
+		//
+		if (task->cmp(task->src_1 + mid * task->size, task->src_2 + (diag - mid - 1) * task->size, task->arg) <= 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/******************************************************************************
+ * The function merges the part of the two runs between the two diagonals.
+ *****************************************************************************/
+
+static void psort_merge(const s_psort_task *task) {
+
+	size_t idx_1 = psort_co_rank(task, task->diag_start);
+	size_t idx_2 = task->diag_start - idx_1;
+
+	const size_t end_1 = psort_co_rank(task, task->diag_end);
+	const size_t end_2 = task->diag_end - end_1;
+
+	char *dst = task->dst + task->diag_start * task->size;
+
+	while (idx_1 < end_1 && idx_2 < end_2) {
+
+		if (task->cmp(task->src_1 + idx_1 * task->size, task->src_2 + idx_2 * task->size, task->arg) <= 0) {
+			memcpy(dst, task->src_1 + idx_1++ * task->size, task->size);
+		} else {
+			memcpy(dst, task->src_2 + idx_2++ * task->size, task->size);
+		}
+
+		dst += task->size;
+	}
+
+	memcpy(dst, task->src_1 + idx_1 * task->size, (end_1 - idx_1) * task->size);
+	dst += (end_1 - idx_1) * task->size;
+
+	memcpy(dst, task->src_2 + idx_2 * task->size, (end_2 - idx_2) * task->size);
+}
+
+/******************************************************************************
+ * The function is the start function of a thread, which sorts or merges.
+ *****************************************************************************/
+
+static void* psort_run(void *ptr) {
+
+	const s_psort_task *task = (const s_psort_task*) ptr;
+
+	if (task->is_merge) {
+		psort_merge(task);
+	} else {
+		qsort_r(task->src_1, task->len_1, task->size, task->cmp, task->arg);
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function runs the tasks. The first task is done by the calling thread
+ * and the others by new threads. The function returns, after all tasks are
+ * finished.
+ *****************************************************************************/
+
+static void psort_run_tasks(s_psort_task *tasks, const int no_tasks) {
+
+	pthread_t threads[no_tasks];
+
+	for (int i = 1; i < no_tasks; i++) {
+		if (pthread_create(&threads[i], NULL, psort_run, &tasks[i]) != 0) {
+			log_exit_str("Unable to create thread!");
+		}
+	}
+
+	psort_run(&tasks[0]);
+
+	for (int i = 1; i < no_tasks; i++) {
+		if (pthread_join(threads[i], NULL) != 0) {
+			log_exit_str("Unable to join thread!");
+		}
+	}
+}
+
+/******************************************************************************
+ * The function sorts an array like qsort_r with several threads. The array is
+ * split into runs, which are sorted in parallel with qsort_r. Then pairs of
+ * adjacent runs are merged, until one run is left. A merge of two runs is
+ * split at the diagonals of the merge path, so all threads are busy, even if
+ * only two runs are left.
+ *
+ * The merge is stable, so if the comparison is a total order (there are no
+ * equal elements), the result is identical to the result of qsort_r. If the
+ * cmp function returns 0 for all elements, the sort finishes fast.
+ *****************************************************************************/
+
+void psort_r(void *base, const size_t nmemb, const size_t size, psort_cmp cmp, void *arg, const int no_threads) {
+
+	//
+	// Compute the number of runs, each with a minimum size.
+	//
+	int no_runs = no_threads;
+
+	if ((size_t) no_runs > nmemb / PSORT_MIN_RUN) {
+		no_runs = (int) (nmemb / PSORT_MIN_RUN);
+	}
+
+	if (no_runs <= 1) {
+		qsort_r(base, nmemb, size, cmp, arg);
+		return;
+	}
+
+	log_debug("Elements: %zu runs: %d", nmemb, no_runs);
+
+	//
+	// The bounds of the runs, which are sorted in parallel.
+	//
+	size_t bounds[no_runs + 1];
+
+	s_psort_task tasks[no_threads + no_runs];
+
+	for (int i = 0; i <= no_runs; i++) {
+		bounds[i] = nmemb * i / no_runs;
+	}
+
+	for (int i = 0; i < no_runs; i++) {
+		tasks[i] = (s_psort_task ) { .is_merge = false, .src_1 = (char*) base + bounds[i] * size, .len_1 = bounds[i + 1] - bounds[i], .size = size, .cmp = cmp, .arg = arg };
+	}
+
+	psort_run_tasks(tasks, no_runs);
+
+	//
+	// Merge the pairs of adjacent runs from the source to the destination and
+	// swap the buffers, until one run is left.
+	//
+	char *src = base;
+	char *dst = xmalloc(nmemb * size);
+	char *tmp = dst;
+
+	for (int width = 1; width < no_runs; width *= 2) {
+		int no_tasks = 0;
+
+		const int no_pairs = (no_runs + 2 * width - 1) / (2 * width);
+
+		//
+		// Each merge is split into parts, so the threads are used, even if
+		// there are only few pairs.
+		//
+		const int no_parts = no_threads / no_pairs > 1 ? no_threads / no_pairs : 1;
+
+		for (int run = 0; run < no_runs; run += 2 * width) {
+
+			const size_t start = bounds[run];
+			const size_t mid = bounds[run + width < no_runs ? run + width : no_runs];
+			const size_t end = bounds[run + 2 * width < no_runs ? run + 2 * width : no_runs];
+
+			for (int part = 0; part < no_parts; part++) {
+				tasks[no_tasks++] = (s_psort_task ) {
+
+					.is_merge = true,
+
+					.src_1 = src + start * size, .len_1 = mid - start,
+
+					.src_2 = src + mid * size, .len_2 = end - mid,
+
+					.dst = dst + start * size,
+
+					.diag_start = (end - start) * part / no_parts,
+
+					.diag_end = (end - start) * (part + 1) / no_parts,
+
+					.size = size, .cmp = cmp, .arg = arg };
+			}
+		}
+
+		psort_run_tasks(tasks, no_tasks);
+
+		char *swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	//
+	// If the result is in the temporary buffer, it is copied to the array.
+	//
+	if (src != base) {
+		memcpy(base, src, nmemb * size);
+	}
+
+	free(tmp);
+}
@@ -0,0 +1,1396 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_regex.h"
+#include "ncv_common.h"
+
+#include <string.h>
+#include <wctype.h>
+
+/******************************************************************************
+ * The limits of the regular expressions. The program size limits the memory
+ * and the time (which is linear with the program size and the string length).
+ * The number of cached DFA states limits the memory of the DFA. If the cache
+ * is full, it is flushed.
+ *****************************************************************************/
+
+#define REGEX_MAX_INST 2048
+
+#define REGEX_MAX_REPEAT 100
+
+#define REGEX_MAX_RANGES 32
+
+#define REGEX_MAX_DEPTH 32
+
+#define REGEX_MAX_DSTATES 512
+
+#define REGEX_HASH_SIZE 1024
+
+//
+// The DFA caches transitions for ASCII chars. Transitions for other chars are
+// computed each time.
+//
+#define REGEX_ASCII 128
+
+/******************************************************************************
+ * The flags for the predefined char classes: \d \w \s
+ *****************************************************************************/
+
+#define CLASS_DIGIT 1
+
+#define CLASS_WORD 2
+
+#define CLASS_SPACE 4
+
+/******************************************************************************
+ * The struct defines a char class like: [^a-z\d]
+ *****************************************************************************/
+
+typedef struct s_class {
+
+	//
+	// The flag for negated classes: [^...]
+	//
+	bool negated;
+
+	//
+	// The predefined classes that are part of the class.
+	//
+	int flags;
+
+	//
+	// The ranges of the class. A single char is a range from == to.
+	//
+	int no_ranges;
+
+	wchar_t from[REGEX_MAX_RANGES];
+
+	wchar_t to[REGEX_MAX_RANGES];
+
+} s_class;
+
+/******************************************************************************
+ * The definitions of the nodes of the syntax tree, which is the result of the
+ * parsing. The syntax tree is compiled to a program.
+ *****************************************************************************/
+
+enum e_node_type {
+	NODE_EMPTY, NODE_CHAR, NODE_ANY, NODE_CLASS, NODE_BOL, NODE_EOL, NODE_CAT, NODE_ALT, NODE_REPEAT
+};
+
+typedef struct s_node {
+
+	enum e_node_type type;
+
+	//
+	// The char of a NODE_CHAR or the index of the class of a NODE_CLASS.
+	//
+	wchar_t chr;
+
+	int cls;
+
+	//
+	// The bounds of a NODE_REPEAT. An unbounded max is -1.
+	//
+	int min;
+
+	int max;
+
+	//
+	// The children of the node. A NODE_REPEAT has only a left child.
+	//
+	struct s_node *left;
+
+	struct s_node *right;
+
+} s_node;
+
+/******************************************************************************
+ * The definitions of the program instructions.
+ *
+ * OP_CHAR, OP_ANY, OP_CLASS consume a char and continue with the next
+ * instruction. OP_SPLIT continues with x and y, OP_JMP continues with x.
+ * OP_BOL and OP_EOL are assertions for the start / end of the string.
+ *****************************************************************************/
+
+enum e_op {
+	OP_CHAR, OP_ANY, OP_CLASS, OP_SPLIT, OP_JMP, OP_BOL, OP_EOL, OP_MATCH
+};
+
+typedef struct s_inst {
+
+	enum e_op op;
+
+	wchar_t chr;
+
+	int cls;
+
+	int x;
+
+	int y;
+
+} s_inst;
+
+/******************************************************************************
+ * A DFA state is a sorted set of program counters. The transitions for ASCII
+ * chars are cached. An unknown transition is -1.
+ *****************************************************************************/
+
+typedef struct s_dstate {
+
+	int *pcs;
+
+	int no_pcs;
+
+	unsigned int hash;
+
+	//
+	// The flag is true if the set contains OP_MATCH.
+	//
+	bool is_match;
+
+	//
+	// The index of the next state in the hash bucket or -1.
+	//
+	int chain;
+
+	int next[REGEX_ASCII];
+
+} s_dstate;
+
+/******************************************************************************
+ * The compiled regular expression with the program and the DFA cache.
+ *****************************************************************************/
+
+struct s_regex {
+
+	bool case_insensitive;
+
+	//
+	// The program and the classes used by the program.
+	//
+	s_inst *prog;
+
+	int no_prog;
+
+	s_class *classes;
+
+	int no_classes;
+
+	//
+	// The DFA cache.
+	//
+	s_dstate *dstates;
+
+	int no_dstates;
+
+	int buckets[REGEX_HASH_SIZE];
+
+	//
+	// The index of the start state at the start of a string or -1.
+	//
+	int start;
+
+	//
+	// Work buffers for the computation of DFA states.
+	//
+	int *stack;
+
+	int *set;
+
+	unsigned int *marks;
+
+	unsigned int gen;
+};
+
+/******************************************************************************
+ * The struct contains the state of the parser.
+ *****************************************************************************/
+
+typedef struct s_parser {
+
+	//
+	// The current position in the pattern.
+	//
+	const wchar_t *ptr;
+
+	//
+	// The regex, which stores the classes.
+	//
+	s_regex *regex;
+
+	//
+	// The nodes are allocated from a pool, so they can be freed at once.
+	//
+	s_node *pool;
+
+	int pool_size;
+
+	int no_nodes;
+
+	int depth;
+
+	bool error;
+
+} s_parser;
+
+/******************************************************************************
+ * The function creates a node from the pool of the parser. If the pool is
+ * exhausted, the error flag is set and NULL is returned.
+ *****************************************************************************/
+
+static s_node* node_create(s_parser *parser, const enum e_node_type type, s_node *left, s_node *right) {
+
+	if (parser->no_nodes >= parser->pool_size) {
+		log_debug_str("Node pool exhausted!");
+		parser->error = true;
+		return NULL;
+	}
+
+	s_node *node = &parser->pool[parser->no_nodes++];
+
+	node->type = type;
+	node->chr = W_STR_TERM;
+	node->cls = -1;
+	node->min = 0;
+	node->max = 0;
+	node->left = left;
+	node->right = right;
+
+	return node;
+}
+
+/******************************************************************************
+ * The function adds an empty class to the regex and returns its index.
+ *****************************************************************************/
+
+static int class_create(s_regex *regex, const bool negated, const int flags) {
+
+	regex->classes = xrealloc(regex->classes, sizeof(s_class) * (regex->no_classes + 1));
+
+	s_class *cls = &regex->classes[regex->no_classes];
+	cls->negated = negated;
+	cls->flags = flags;
+	cls->no_ranges = 0;
+
+	return regex->no_classes++;
+}
+
+/******************************************************************************
+ * The function checks whether a char is part of a class, ignoring the negated
+ * flag.
+ *****************************************************************************/
+
+static bool class_contains(const s_class *cls, const wchar_t chr) {
+
+	if ((cls->flags & CLASS_DIGIT) && iswdigit(chr)) {
+		return true;
+	}
+
+	if ((cls->flags & CLASS_WORD) && (iswalnum(chr) || chr == L'_')) {
+		return true;
+	}
+
+	if ((cls->flags & CLASS_SPACE) && iswspace(chr)) {
+		return true;
+	}
+
+	for (int i = 0; i < cls->no_ranges; i++) {
+		if (cls->from[i] <= chr && chr <= cls->to[i]) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function checks whether a char matches a class. In the case insensitive
+ * mode, the char is lower case, so the upper case char has to be checked too.
+ *****************************************************************************/
+
+static bool class_matches(const s_regex *regex, const int idx, const wchar_t chr) {
+	const s_class *cls = &regex->classes[idx];
+
+	bool result = class_contains(cls, chr);
+
+	if (!result && regex->case_insensitive) {
+		result = class_contains(cls, (wchar_t) towupper((wint_t) chr));
+	}
+
+	return result != cls->negated;
+}
+
+/******************************************************************************
+ * The function parses an escape sequence. The parser points to the char after
+ * the backslash. The result is either a char or the flag of a predefined
+ * class. The negated flag is set for: \D \W \S
+ *****************************************************************************/
+
+static void parse_escape(s_parser *parser, wchar_t *chr, int *flags, bool *negated) {
+
+	*chr = *parser->ptr;
+	*flags = 0;
+	*negated = false;
+
+	switch (*chr) {
+
+	case W_STR_TERM:
+		log_debug_str("Pattern ends with a backslash!");
+		parser->error = true;
+		return;
+
+	case L'D':
+		*negated = true;
+		/* fall through */
+	case L'd':
+		*flags = CLASS_DIGIT;
+		break;
+
+	case L'W':
+		*negated = true;
+		/* fall through */
+	case L'w':
+		*flags = CLASS_WORD;
+		break;
+
+	case L'S':
+		*negated = true;
+		/* fall through */
+	case L's':
+		*flags = CLASS_SPACE;
+		break;
+
+	case L't':
+		*chr = W_TAB;
+		break;
+
+	case L'n':
+		*chr = W_NEW_LINE;
+		break;
+
+	case L'r':
+		*chr = W_CR;
+		break;
+	}
+
+	parser->ptr++;
+}
+
+/******************************************************************************
+ * The function adds a range to a class. In the case insensitive mode, the
+ * bounds are lower case. If the class is full, the error flag is set.
+ *****************************************************************************/
+
+static void class_add_range(s_parser *parser, s_class *cls, const wchar_t from, const wchar_t to) {
+
+	if (from > to || cls->no_ranges >= REGEX_MAX_RANGES) {
+		log_debug_str("Invalid range or too many ranges!");
+		parser->error = true;
+		return;
+	}
+
+	cls->from[cls->no_ranges] = from;
+	cls->to[cls->no_ranges] = to;
+	cls->no_ranges++;
+}
+
+/******************************************************************************
+ * The function parses a char class. The parser points to the char after the
+ * opening bracket. A closing bracket at the start of the class is a literal.
+ *****************************************************************************/
+
+static s_node* parse_class(s_parser *parser) {
+	wchar_t from, to;
+	int flags;
+	bool negated;
+
+	const bool is_negated = (*parser->ptr == L'^');
+	if (is_negated) {
+		parser->ptr++;
+	}
+
+	const int idx = class_create(parser->regex, is_negated, 0);
+	s_class *cls = &parser->regex->classes[idx];
+
+	for (bool first = true; *parser->ptr != L']' || first; first = false) {
+
+		if (*parser->ptr == W_STR_TERM) {
+			log_debug_str("Missing closing bracket!");
+			parser->error = true;
+			return NULL;
+		}
+
+		//
+		// Read the first char of the range, which can be a predefined class.
+		//
+		if (*parser->ptr == L'\\') {
+			parser->ptr++;
+			parse_escape(parser, &from, &flags, &negated);
+
+			if (negated) {
+				log_debug_str("Negated class inside a class!");
+				parser->error = true;
+			}
+
+			if (parser->error) {
+				return NULL;
+			}
+
+			if (flags != 0) {
+				cls->flags |= flags;
+				continue;
+			}
+
+		} else {
+			from = *parser->ptr++;
+		}
+
+		//
+		// Check for a range: a-z (a '-' at the end is a literal)
+		//
+		to = from;
+
+		if (parser->ptr[0] == L'-' && parser->ptr[1] != L']' && parser->ptr[1] != W_STR_TERM) {
+			parser->ptr++;
+
+			if (*parser->ptr == L'\\') {
+				parser->ptr++;
+				parse_escape(parser, &to, &flags, &negated);
+
+				if (flags != 0) {
+					log_debug_str("Class as a range bound!");
+					parser->error = true;
+				}
+
+			} else {
+				to = *parser->ptr++;
+			}
+		}
+
+		if (parser->regex->case_insensitive) {
+			from = (wchar_t) towlower((wint_t) from);
+			to = (wchar_t) towlower((wint_t) to);
+		}
+
+		class_add_range(parser, cls, from, to);
+
+		if (parser->error) {
+			return NULL;
+		}
+	}
+
+	//
+	// Skip the closing bracket.
+	//
+	parser->ptr++;
+
+	s_node *node = node_create(parser, NODE_CLASS, NULL, NULL);
+	if (node != NULL) {
+		node->cls = idx;
+	}
+
+	return node;
+}
+
+static s_node* parse_alt(s_parser *parser);
+
+/******************************************************************************
+ * The function parses an atom, which is a group, a class, a char or an
+ * assertion.
+ *****************************************************************************/
+
+static s_node* parse_atom(s_parser *parser) {
+	s_node *node;
+	wchar_t chr;
+	int flags;
+	bool negated;
+
+	switch (*parser->ptr) {
+
+	case L'(':
+		parser->ptr++;
+
+		if (++parser->depth > REGEX_MAX_DEPTH) {
+			log_debug_str("Groups are nested too deep!");
+			parser->error = true;
+			return NULL;
+		}
+
+		node = parse_alt(parser);
+
+		if (parser->error) {
+			return NULL;
+		}
+
+		if (*parser->ptr != L')') {
+			log_debug_str("Missing closing parenthesis!");
+			parser->error = true;
+			return NULL;
+		}
+
+		parser->ptr++;
+		parser->depth--;
+		return node;
+
+	case L'[':
+		parser->ptr++;
+		return parse_class(parser);
+
+	case L'.':
+		parser->ptr++;
+		return node_create(parser, NODE_ANY, NULL, NULL);
+
+	case L'^':
+		parser->ptr++;
+		return node_create(parser, NODE_BOL, NULL, NULL);
+
+	case L'$':
+		parser->ptr++;
+		return node_create(parser, NODE_EOL, NULL, NULL);
+
+	case L'*':
+	case L'+':
+	case L'?':
+	case L'{':
+		log_debug("Nothing to repeat: %ls", parser->ptr);
+		parser->error = true;
+		return NULL;
+
+	case L'\\':
+		parser->ptr++;
+		parse_escape(parser, &chr, &flags, &negated);
+
+		if (parser->error) {
+			return NULL;
+		}
+
+		if (flags != 0) {
+			node = node_create(parser, NODE_CLASS, NULL, NULL);
+			if (node != NULL) {
+				node->cls = class_create(parser->regex, negated, flags);
+			}
+			return node;
+		}
+		break;
+
+	default:
+		chr = *parser->ptr++;
+		break;
+	}
+
+	node = node_create(parser, NODE_CHAR, NULL, NULL);
+	if (node != NULL) {
+		node->chr = parser->regex->case_insensitive ? (wchar_t) towlower((wint_t) chr) : chr;
+	}
+
+	return node;
+}
+
+/******************************************************************************
+ * The function parses a number of a bounded repetition: x{n,m}
+ *****************************************************************************/
+
+static int parse_number(s_parser *parser) {
+	int result = 0;
+
+	if (!iswdigit(*parser->ptr)) {
+		parser->error = true;
+		return 0;
+	}
+
+	for (; iswdigit(*parser->ptr); parser->ptr++) {
+		result = result * 10 + (*parser->ptr - L'0');
+
+		if (result > REGEX_MAX_REPEAT) {
+			log_debug("Repetition is larger than: %d", REGEX_MAX_REPEAT);
+			parser->error = true;
+			return 0;
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * The function parses an atom, followed by optional repetitions.
+ *****************************************************************************/
+
+static s_node* parse_repeat(s_parser *parser) {
+	int min, max;
+
+	s_node *node = parse_atom(parser);
+
+	while (!parser->error) {
+
+		switch (*parser->ptr) {
+
+		case L'*':
+			min = 0;
+			max = -1;
+			break;
+
+		case L'+':
+			min = 1;
+			max = -1;
+			break;
+
+		case L'?':
+			min = 0;
+			max = 1;
+			break;
+
+		case L'{':
+			parser->ptr++;
+			min = parse_number(parser);
+			max = min;
+
+			if (*parser->ptr == L',') {
+				parser->ptr++;
+				max = (*parser->ptr == L'}') ? -1 : parse_number(parser);
+			}
+
+			if (parser->error || *parser->ptr != L'}' || (max != -1 && max < min)) {
+				log_debug_str("Invalid repetition!");
+				parser->error = true;
+				return NULL;
+			}
+			break;
+
+		default:
+			return node;
+		}
+
+		parser->ptr++;
+
+		node = node_create(parser, NODE_REPEAT, node, NULL);
+		if (node != NULL) {
+			node->min = min;
+			node->max = max;
+		}
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function parses a concatenation, which ends with a '|', a ')' or the
+ * end of the pattern. An empty concatenation is a NODE_EMPTY.
+ *****************************************************************************/
+
+static s_node* parse_cat(s_parser *parser) {
+	s_node *left = NULL;
+	s_node *node;
+
+	while (*parser->ptr != W_STR_TERM && *parser->ptr != L'|' && *parser->ptr != L')') {
+
+		node = parse_repeat(parser);
+
+		if (parser->error) {
+			return NULL;
+		}
+
+		left = (left == NULL) ? node : node_create(parser, NODE_CAT, left, node);
+	}
+
+	if (left == NULL) {
+		left = node_create(parser, NODE_EMPTY, NULL, NULL);
+	}
+
+	return left;
+}
+
+/******************************************************************************
+ * The function parses alternatives: x|y
+ *****************************************************************************/
+
+static s_node* parse_alt(s_parser *parser) {
+
+	s_node *left = parse_cat(parser);
+
+	while (!parser->error && *parser->ptr == L'|') {
+		parser->ptr++;
+		left = node_create(parser, NODE_ALT, left, parse_cat(parser));
+	}
+
+	return left;
+}
+
+/******************************************************************************
+ * The function adds an instruction to the program and returns its index. If
+ * the program is too large, the function returns -1.
+ *****************************************************************************/
+
+static int emit(s_regex *regex, const enum e_op op) {
+
+	if (regex->no_prog >= REGEX_MAX_INST) {
+		return -1;
+	}
+
+	s_inst *inst = &regex->prog[regex->no_prog];
+	inst->op = op;
+	inst->chr = W_STR_TERM;
+	inst->cls = -1;
+	inst->x = -1;
+	inst->y = -1;
+
+	return regex->no_prog++;
+}
+
+/******************************************************************************
+ * The function compiles a node of the syntax tree to instructions. It returns
+ * false if the program is too large.
+ *****************************************************************************/
+
+static bool compile(s_regex *regex, const s_node *node) {
+	int pc, split, jmp;
+
+	switch (node->type) {
+
+	case NODE_EMPTY:
+		return true;
+
+	case NODE_CHAR:
+		if ((pc = emit(regex, OP_CHAR)) < 0) {
+			return false;
+		}
+		regex->prog[pc].chr = node->chr;
+		return true;
+
+	case NODE_CLASS:
+		if ((pc = emit(regex, OP_CLASS)) < 0) {
+			return false;
+		}
+		regex->prog[pc].cls = node->cls;
+		return true;
+
+	case NODE_ANY:
+		return emit(regex, OP_ANY) >= 0;
+
+	case NODE_BOL:
+		return emit(regex, OP_BOL) >= 0;
+
+	case NODE_EOL:
+		return emit(regex, OP_EOL) >= 0;
+
+	case NODE_CAT:
+		return compile(regex, node->left) && compile(regex, node->right);
+
+	case NODE_ALT:
+
+		//
+		// split L1, L2 | L1: left | jmp L3 | L2: right | L3:
+		//
+		if ((split = emit(regex, OP_SPLIT)) < 0 || !compile(regex, node->left) || (jmp = emit(regex, OP_JMP)) < 0) {
+			return false;
+		}
+
+		regex->prog[split].x = split + 1;
+		regex->prog[split].y = regex->no_prog;
+
+		if (!compile(regex, node->right)) {
+			return false;
+		}
+
+		regex->prog[jmp].x = regex->no_prog;
+		return true;
+
+	case NODE_REPEAT:
+
+		//
+		// The mandatory repetitions.
+		//
+		for (int i = 0; i < node->min; i++) {
+			if (!compile(regex, node->left)) {
+				return false;
+			}
+		}
+
+		//
+		// Unbounded: L1: split L2, L3 | L2: left | jmp L1 | L3:
+		//
+		if (node->max == -1) {
+
+			if ((split = emit(regex, OP_SPLIT)) < 0 || !compile(regex, node->left) || (jmp = emit(regex, OP_JMP)) < 0) {
+				return false;
+			}
+
+			regex->prog[jmp].x = split;
+			regex->prog[split].x = split + 1;
+			regex->prog[split].y = regex->no_prog;
+			return true;
+		}
+
+		//
+		// Bounded: (left(left)?)? with all splits jumping to the end.
+		//
+		{
+			int splits[REGEX_MAX_REPEAT];
+			const int no_splits = node->max - node->min;
+
+			for (int i = 0; i < no_splits; i++) {
+
+				if ((splits[i] = emit(regex, OP_SPLIT)) < 0 || !compile(regex, node->left)) {
+					return false;
+				}
+
+				regex->prog[splits[i]].x = splits[i] + 1;
+			}
+
+			for (int i = 0; i < no_splits; i++) {
+				regex->prog[splits[i]].y = regex->no_prog;
+			}
+		}
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function compiles a pattern to a regex. If the pattern is not valid or
+ * too complex, the function returns NULL.
+ *****************************************************************************/
+
+s_regex* s_regex_create(const wchar_t *pattern, const bool case_insensitive) {
+
+	s_regex *regex = xmalloc(sizeof(s_regex));
+
+	regex->case_insensitive = case_insensitive;
+	regex->classes = NULL;
+	regex->no_classes = 0;
+	regex->prog = xmalloc(sizeof(s_inst) * REGEX_MAX_INST);
+	regex->no_prog = 0;
+	regex->dstates = NULL;
+	regex->stack = NULL;
+	regex->set = NULL;
+	regex->marks = NULL;
+
+	//
+	// Parse the pattern to a syntax tree. Each char creates at most three
+	// nodes (atom, repetition and concatenation).
+	//
+	s_parser parser;
+	parser.ptr = pattern;
+	parser.regex = regex;
+	parser.pool_size = 3 * wcslen(pattern) + 2;
+	parser.pool = xmalloc(sizeof(s_node) * parser.pool_size);
+	parser.no_nodes = 0;
+	parser.depth = 0;
+	parser.error = false;
+
+	s_node *root = parse_alt(&parser);
+
+	//
+	// A closing parenthesis without an opening one stops the parsing.
+	//
+	if (!parser.error && *parser.ptr != W_STR_TERM) {
+		log_debug("Unexpected: %ls", parser.ptr);
+		parser.error = true;
+	}
+
+	//
+	// Compile the syntax tree and add the final match instruction.
+	//
+	const bool success = !parser.error && compile(regex, root) && emit(regex, OP_MATCH) >= 0;
+
+	free(parser.pool);
+
+	if (!success) {
+		log_debug("Unable to compile: %ls", pattern);
+		s_regex_free(regex);
+		return NULL;
+	}
+
+	//
+	// Allocate the DFA cache and the work buffers.
+	//
+	regex->dstates = xmalloc(sizeof(s_dstate) * REGEX_MAX_DSTATES);
+	regex->no_dstates = 0;
+	regex->start = -1;
+
+	for (int i = 0; i < REGEX_HASH_SIZE; i++) {
+		regex->buckets[i] = -1;
+	}
+
+	regex->stack = xmalloc(sizeof(int) * 2 * regex->no_prog);
+	regex->set = xmalloc(sizeof(int) * regex->no_prog);
+	regex->marks = xmalloc(sizeof(unsigned int) * regex->no_prog);
+	regex->gen = 0;
+
+	memset(regex->marks, 0, sizeof(unsigned int) * regex->no_prog);
+
+	log_debug("Pattern: %ls program size: %d classes: %d", pattern, regex->no_prog, regex->no_classes);
+
+	return regex;
+}
+
+/******************************************************************************
+ * The function removes all states from the DFA cache.
+ *****************************************************************************/
+
+static void dfa_flush(s_regex *regex) {
+
+	log_debug("Flushing %d DFA states.", regex->no_dstates);
+
+	for (int i = 0; i < regex->no_dstates; i++) {
+		free(regex->dstates[i].pcs);
+	}
+
+	for (int i = 0; i < REGEX_HASH_SIZE; i++) {
+		regex->buckets[i] = -1;
+	}
+
+	regex->no_dstates = 0;
+	regex->start = -1;
+}
+
+/******************************************************************************
+ * The function frees the regex.
+ *****************************************************************************/
+
+void s_regex_free(s_regex *regex) {
+
+	if (regex->dstates != NULL) {
+		dfa_flush(regex);
+		free(regex->dstates);
+	}
+
+	free(regex->stack);
+	free(regex->set);
+	free(regex->marks);
+	free(regex->classes);
+	free(regex->prog);
+	free(regex);
+}
+
+/******************************************************************************
+ * The function checks whether an instruction consumes a char.
+ *****************************************************************************/
+
+static inline bool inst_consumes(const s_regex *regex, const s_inst *inst, const wchar_t chr) {
+
+	switch (inst->op) {
+
+	case OP_CHAR:
+		return inst->chr == chr;
+
+	case OP_ANY:
+		return chr != W_NEW_LINE;
+
+	case OP_CLASS:
+		return class_matches(regex, inst->cls, chr);
+
+	default:
+		return false;
+	}
+}
+
+/******************************************************************************
+ * The function adds the epsilon closure of a program counter to the work set
+ * of the regex. The assertions are evaluated with the bol / eol flags. If the
+ * eol flag is false, an OP_EOL instruction is added to the set, so that it can
+ * be evaluated at the end of the string.
+ *****************************************************************************/
+
+static void dfa_add(s_regex *regex, const int start_pc, const bool bol, const bool eol, int *no_set) {
+	int pc, no_stack = 0;
+
+	regex->stack[no_stack++] = start_pc;
+
+	while (no_stack > 0) {
+		pc = regex->stack[--no_stack];
+
+		if (regex->marks[pc] == regex->gen) {
+			continue;
+		}
+		regex->marks[pc] = regex->gen;
+
+		const s_inst *inst = &regex->prog[pc];
+
+		switch (inst->op) {
+
+		case OP_JMP:
+			regex->stack[no_stack++] = inst->x;
+			break;
+
+		case OP_SPLIT:
+			regex->stack[no_stack++] = inst->y;
+			regex->stack[no_stack++] = inst->x;
+			break;
+
+		case OP_BOL:
+			if (bol) {
+				regex->stack[no_stack++] = pc + 1;
+			}
+			break;
+
+		case OP_EOL:
+			if (eol) {
+				regex->stack[no_stack++] = pc + 1;
+			} else {
+				regex->set[(*no_set)++] = pc;
+			}
+			break;
+
+		default:
+			regex->set[(*no_set)++] = pc;
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+ * The callback function for sorting the program counters of a set.
+ *****************************************************************************/
+
+static int compare_int(const void *ptr_1, const void *ptr_2) {
+	return *(const int*) ptr_1 - *(const int*) ptr_2;
+}
+
+/******************************************************************************
+ * The function returns the index of the DFA state for the work set. If the
+ * state is not cached, it is created. If the cache is full, it is flushed
+ * before and the flag is set.
+ *****************************************************************************/
+
+static int dfa_state(s_regex *regex, const int no_set, bool *flushed) {
+	unsigned int hash = 0;
+
+	qsort(regex->set, no_set, sizeof(int), compare_int);
+
+	for (int i = 0; i < no_set; i++) {
+		hash = hash * 31 + regex->set[i];
+	}
+
+	//
+	// Search the state in the hash bucket.
+	//
+	for (int idx = regex->buckets[hash % REGEX_HASH_SIZE]; idx >= 0; idx = regex->dstates[idx].chain) {
+		const s_dstate *state = &regex->dstates[idx];
+
+		if (state->hash == hash && state->no_pcs == no_set && memcmp(state->pcs, regex->set, sizeof(int) * no_set) == 0) {
+			return idx;
+		}
+	}
+
+	*flushed = (regex->no_dstates >= REGEX_MAX_DSTATES);
+
+	if (*flushed) {
+		dfa_flush(regex);
+	}
+
+	//
+	// Create the new state.
+	//
+	const int idx = regex->no_dstates++;
+	s_dstate *state = &regex->dstates[idx];
+
+	state->pcs = xmalloc(sizeof(int) * (no_set > 0 ? no_set : 1));
+	memcpy(state->pcs, regex->set, sizeof(int) * no_set);
+	state->no_pcs = no_set;
+	state->hash = hash;
+	state->is_match = false;
+
+	for (int i = 0; i < no_set; i++) {
+		if (regex->prog[regex->set[i]].op == OP_MATCH) {
+			state->is_match = true;
+		}
+	}
+
+	for (int i = 0; i < REGEX_ASCII; i++) {
+		state->next[i] = -1;
+	}
+
+	state->chain = regex->buckets[hash % REGEX_HASH_SIZE];
+	regex->buckets[hash % REGEX_HASH_SIZE] = idx;
+
+	return idx;
+}
+
+/******************************************************************************
+ * The function computes the transition of a DFA state for a char. The search
+ * is not anchored, so the start of the program is added to each state.
+ *****************************************************************************/
+
+static int dfa_step(s_regex *regex, const int from, const wchar_t chr) {
+	int no_set = 0;
+	bool flushed = false;
+
+	regex->gen++;
+
+	const s_dstate *state = &regex->dstates[from];
+
+	for (int i = 0; i < state->no_pcs; i++) {
+		const int pc = state->pcs[i];
+
+		if (inst_consumes(regex, &regex->prog[pc], chr)) {
+			dfa_add(regex, pc + 1, false, false, &no_set);
+		}
+	}
+
+	dfa_add(regex, 0, false, false, &no_set);
+
+	const int idx = dfa_state(regex, no_set, &flushed);
+
+	//
+	// Cache the transition if the from state still exists.
+	//
+	if (!flushed && chr >= 0 && chr < REGEX_ASCII) {
+		regex->dstates[from].next[chr] = idx;
+	}
+
+	return idx;
+}
+
+/******************************************************************************
+ * The function checks whether a DFA state matches at the end of the string,
+ * which means that the pending OP_EOL instructions are evaluated.
+ *****************************************************************************/
+
+static bool dfa_matches_at_end(s_regex *regex, const int idx, const bool bol) {
+	int no_set = 0;
+
+	regex->gen++;
+
+	const s_dstate *state = &regex->dstates[idx];
+
+	for (int i = 0; i < state->no_pcs; i++) {
+		const int pc = state->pcs[i];
+
+		if (regex->prog[pc].op == OP_EOL) {
+			dfa_add(regex, pc, bol, true, &no_set);
+		}
+	}
+
+	for (int i = 0; i < no_set; i++) {
+		if (regex->prog[regex->set[i]].op == OP_MATCH) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/******************************************************************************
+ * The function checks whether the string contains a match of the regex. It
+ * uses the DFA and returns on the first match.
+ *****************************************************************************/
+
+bool s_regex_matches(s_regex *regex, const wchar_t *str) {
+	int next;
+	wchar_t chr;
+
+	//
+	// Get the start state.
+	//
+	if (regex->start < 0) {
+		int no_set = 0;
+		bool flushed = false;
+
+		regex->gen++;
+		dfa_add(regex, 0, true, false, &no_set);
+		regex->start = dfa_state(regex, no_set, &flushed);
+	}
+
+	int cur = regex->start;
+
+	const wchar_t *ptr;
+
+	for (ptr = str; *ptr != W_STR_TERM; ptr++) {
+
+		if (regex->dstates[cur].is_match) {
+			return true;
+		}
+
+		chr = regex->case_insensitive ? (wchar_t) towlower((wint_t) *ptr) : *ptr;
+
+		if (chr >= 0 && chr < REGEX_ASCII && (next = regex->dstates[cur].next[chr]) >= 0) {
+			cur = next;
+
+		} else {
+			cur = dfa_step(regex, cur, chr);
+		}
+	}
+
+	return regex->dstates[cur].is_match || dfa_matches_at_end(regex, cur, ptr == str);
+}
+
+/******************************************************************************
+ * The struct is a thread of the pike vm, which is a program counter and the
+ * start of the match.
+ *****************************************************************************/
+
+typedef struct s_thread {
+
+	int pc;
+
+	int start;
+
+} s_thread;
+
+/******************************************************************************
+ * The function adds a thread with the epsilon closure of the program counter
+ * to a thread list. The order of the list is the priority of the threads.
+ *****************************************************************************/
+
+static void pike_add(const s_regex *regex, s_thread *list, int *no_list, unsigned int *marks, const unsigned int gen, const int pc, const int start, const bool bol, const bool eol) {
+
+	if (marks[pc] == gen) {
+		return;
+	}
+	marks[pc] = gen;
+
+	const s_inst *inst = &regex->prog[pc];
+
+	switch (inst->op) {
+
+	case OP_JMP:
+		pike_add(regex, list, no_list, marks, gen, inst->x, start, bol, eol);
+		break;
+
+	case OP_SPLIT:
+		pike_add(regex, list, no_list, marks, gen, inst->x, start, bol, eol);
+		pike_add(regex, list, no_list, marks, gen, inst->y, start, bol, eol);
+		break;
+
+	case OP_BOL:
+		if (bol) {
+			pike_add(regex, list, no_list, marks, gen, pc + 1, start, bol, eol);
+		}
+		break;
+
+	case OP_EOL:
+		if (eol) {
+			pike_add(regex, list, no_list, marks, gen, pc + 1, start, bol, eol);
+		}
+		break;
+
+	default:
+		list[*no_list].pc = pc;
+		list[*no_list].start = start;
+		(*no_list)++;
+		break;
+	}
+}
+
+/******************************************************************************
+ * The function searches the leftmost longest match of the regex in the
+ * string, starting at the offset. The offset is required for repeated
+ * searches, because ^ only matches at the start of the string. It returns a
+ * pointer to the start of the match and sets the length of the match, which
+ * can be 0. If there is no match, NULL is returned.
+ *
+ * The function simulates the program with a thread for each start position.
+ * Threads of earlier start positions have a higher priority, so each program
+ * counter is processed at most once per char.
+ *****************************************************************************/
+
+wchar_t* s_regex_search(const s_regex *regex, const wchar_t *str, const size_t offset, size_t *len) {
+
+	const int str_len = wcslen(str);
+
+	s_thread list_1[regex->no_prog];
+	s_thread list_2[regex->no_prog];
+
+	s_thread *clist = list_1;
+	s_thread *nlist = list_2;
+	s_thread *tmp;
+
+	int no_clist = 0;
+	int no_nlist;
+
+	unsigned int marks[regex->no_prog];
+	memset(marks, 0, sizeof(marks));
+
+	unsigned int gen_cur = 1;
+	unsigned int gen_next;
+
+	int best_start = -1;
+	int best_end = -1;
+
+	wchar_t chr;
+
+	for (int pos = offset; pos <= str_len; pos++) {
+
+		//
+		// Start a new thread with the lowest priority, as long as there is
+		// no match.
+		//
+		if (best_start < 0) {
+			pike_add(regex, clist, &no_clist, marks, gen_cur, 0, pos, pos == 0, pos == str_len);
+		}
+
+		if (no_clist == 0 && best_start >= 0) {
+			break;
+		}
+
+		chr = pos < str_len ? str[pos] : W_STR_TERM;
+		if (regex->case_insensitive) {
+			chr = (wchar_t) towlower((wint_t) chr);
+		}
+
+		gen_next = gen_cur + 1;
+		no_nlist = 0;
+
+		for (int i = 0; i < no_clist; i++) {
+			const s_thread *thread = &clist[i];
+
+			//
+			// Threads that start after the best match are not interesting.
+			//
+			if (best_start >= 0 && thread->start > best_start) {
+				continue;
+			}
+
+			const s_inst *inst = &regex->prog[thread->pc];
+
+			if (inst->op == OP_MATCH) {
+
+				if (best_start < 0 || thread->start < best_start || (thread->start == best_start && pos > best_end)) {
+					best_start = thread->start;
+					best_end = pos;
+				}
+
+			} else if (pos < str_len && inst_consumes(regex, inst, chr)) {
+				pike_add(regex, nlist, &no_nlist, marks, gen_next, thread->pc + 1, thread->start, false, pos + 1 == str_len);
+			}
+		}
+
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+
+		no_clist = no_nlist;
+		gen_cur = gen_next;
+	}
+
+	if (best_start < 0) {
+		return NULL;
+	}
+
+	*len = best_end - best_start;
+
+	return (wchar_t*) str + best_start;
+}
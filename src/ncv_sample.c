@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_sample.h"
+#include "ncv_common.h"
+
+#include <stdlib.h>
+
+/******************************************************************************
+ * The initial number of fields of a row.
+ *****************************************************************************/
+
+#define SAMPLE_FIELDS_INIT 16
+
+/******************************************************************************
+ * The function initializes a row without fields.
+ *****************************************************************************/
+
+static void s_sample_row_init(s_sample_row *row) {
+	row->number = 0;
+	row->fields = NULL;
+	row->no_fields = 0;
+	row->size = 0;
+}
+
+/******************************************************************************
+ * The function frees the fields of a row. The allocated array is kept, so it
+ * can be reused, if the row is replaced.
+ *****************************************************************************/
+
+static void s_sample_row_clear(s_sample_row *row) {
+
+	for (int i = 0; i < row->no_fields; i++) {
+		free(row->fields[i]);
+	}
+
+	row->no_fields = 0;
+}
+
+/******************************************************************************
+ * The function returns a random number in the range: [0, max). It uses a
+ * xorshift generator, which is fast and good enough for sampling.
+ *****************************************************************************/
+
+static long s_sample_random(s_sample *sample, const long max) {
+
+	sample->random ^= sample->random << 13;
+	sample->random ^= sample->random >> 7;
+	sample->random ^= sample->random << 17;
+
+	return (long) (sample->random % (uint64_t) max);
+}
+
+/******************************************************************************
+ * The function initializes the sample with the size of the reservoir and the
+ * seed of the random number generator.
+ *****************************************************************************/
+
+void s_sample_init(s_sample *sample, const int size, const uint64_t seed) {
+
+	sample->size = size;
+	sample->no_rows = 0;
+	sample->no_read = 0;
+	sample->current = NULL;
+	//
+	// The seed is mixed (splitmix64), so similar seeds result in different
+	// sequences.
+	//
+	uint64_t mix = seed + UINT64_C(0x9E3779B97F4A7C15);
+	mix = (mix ^ (mix >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	mix = (mix ^ (mix >> 27)) * UINT64_C(0x94D049BB133111EB);
+	mix ^= mix >> 31;
+
+	sample->random = mix != 0 ? mix : 1;
+
+	sample->rows = xmalloc(sizeof(s_sample_row) * size);
+
+	for (int i = 0; i < size; i++) {
+		s_sample_row_init(&sample->rows[i]);
+	}
+
+	s_sample_row_init(&sample->first);
+}
+
+/******************************************************************************
+ * The function frees the rows of the sample.
+ *****************************************************************************/
+
+void s_sample_free(s_sample *sample) {
+
+	for (int i = 0; i < sample->size; i++) {
+		s_sample_row_clear(&sample->rows[i]);
+		free(sample->rows[i].fields);
+	}
+
+	free(sample->rows);
+
+	s_sample_row_clear(&sample->first);
+	free(sample->first.fields);
+
+	sample->rows = NULL;
+	sample->size = 0;
+	sample->no_rows = 0;
+}
+
+/******************************************************************************
+ * The function is called at the start of each row of the csv file. It decides
+ * whether the row is kept (algorithm R). The k-th row (starting with 0, after
+ * the first row) is kept with the probability: size / (k + 1) and replaces a
+ * random row of the reservoir.
+ *****************************************************************************/
+
+void s_sample_start_row(s_sample *sample) {
+
+	const long number = ++sample->no_read;
+
+	if (number == 1) {
+		sample->current = &sample->first;
+
+	} else if (sample->no_rows < sample->size) {
+		sample->current = &sample->rows[sample->no_rows++];
+
+	} else {
+		const long idx = s_sample_random(sample, number - 1);
+
+		sample->current = idx < sample->size ? &sample->rows[idx] : NULL;
+	}
+
+	if (sample->current != NULL) {
+		s_sample_row_clear(sample->current);
+		sample->current->number = number;
+	}
+}
+
+/******************************************************************************
+ * The function adds a field to the current row, if the row is kept.
+ *****************************************************************************/
+
+void s_sample_add_field(s_sample *sample, const wchar_t *str) {
+	s_sample_row *row = sample->current;
+
+	if (row == NULL) {
+		return;
+	}
+
+	if (row->no_fields >= row->size) {
+		row->size = row->size == 0 ? SAMPLE_FIELDS_INIT : 2 * row->size;
+		row->fields = xrealloc(row->fields, sizeof(wchar_t*) * row->size);
+	}
+
+	if ((row->fields[row->no_fields] = wcsdup(str)) == NULL) {
+		log_exit_str("Unable to allocate memory!");
+	}
+
+	row->no_fields++;
+}
+
+/******************************************************************************
+ * The function compares two rows by their numbers.
+ *****************************************************************************/
+
+static int s_sample_row_cmp(const void *ptr1, const void *ptr2) {
+	const long n1 = ((const s_sample_row*) ptr1)->number;
+	const long n2 = ((const s_sample_row*) ptr2)->number;
+
+	return (n1 > n2) - (n1 < n2);
+}
+
+/******************************************************************************
+ * The function sorts the rows of the reservoir, so they have the order of the
+ * csv file.
+ *****************************************************************************/
+
+void s_sample_sort(s_sample *sample) {
+	qsort(sample->rows, sample->no_rows, sizeof(s_sample_row), s_sample_row_cmp);
+}
@@ -37,37 +37,155 @@ bool s_sort_set_inactive(s_sort *sort, const bool uninit) {
 
 	if (uninit || sort->is_active) {
 		sort->is_active = false;
-		sort->column = -1;
-		sort->direction = E_DIR_FORWARD;
+		sort->no_keys = 0;
 		return true;
 	}
 
 	return false;
 }
 
+/******************************************************************************
+ * The function returns the index of the key of a column or -1 if the column
+ * is not used for sorting.
+ *****************************************************************************/
+
+int s_sort_key_idx(const s_sort *sort, const int column) {
+
+	if (!sort->is_active) {
+		return -1;
+	}
+
+	for (int idx = 0; idx < sort->no_keys; idx++) {
+		if (sort->keys[idx].column == column) {
+			return idx;
+		}
+	}
+
+	return -1;
+}
+
 /******************************************************************************
  * The function updates the sort struct with new data. It returns true if the
  * sorting is active. Sorting is toggled, which means, if the sorting is active
  * and the function is called with identical data, the sorting will be
- * deactivated.
+ * deactivated. The column is the only key of the sorting. If the column was a
+ * key, its type is kept.
  *****************************************************************************/
 
 bool s_sort_update(s_sort *sort, const int column, const enum e_direction direction) {
 
-	log_debug("Before - active: %s column: %d direction: %s", bool_str(sort->is_active), sort->column, e_direction_str(sort->direction));
+	const int idx = s_sort_key_idx(sort, column);
 
-	if (sort->is_active && sort->column == column && sort->direction == direction) {
-		sort->is_active = false;
-		sort->column = -1;
-		sort->direction = E_DIR_FORWARD;
+	log_debug("Before - active: %s keys: %d column: %d direction: %s", bool_str(sort->is_active), sort->no_keys, column, e_direction_str(direction));
+
+	if (sort->is_active && sort->no_keys == 1 && idx == 0 && sort->keys[0].direction == direction) {
+		s_sort_set_inactive(sort, false);
 
 	} else {
+		const enum e_sort_type type = idx >= 0 ? sort->keys[idx].type : E_SORT_AUTO;
+
 		sort->is_active = true;
-		sort->column = column;
-		sort->direction = direction;
+		sort->no_keys = 1;
+		sort->keys[0] = (s_sort_key ) { .column = column, .direction = direction, .type = type };
 	}
 
-	log_debug("After - active: %s column: %d direction: %s", bool_str(sort->is_active), sort->column, e_direction_str(sort->direction));
+	log_debug("After - active: %s keys: %d", bool_str(sort->is_active), sort->no_keys);
 
 	return sort->is_active;
 }
+
+/******************************************************************************
+ * The function adds a column as the key with the lowest priority to the
+ * sorting. If the column is already a key with the same direction, the key
+ * is removed, otherwise the direction of the key is changed. The function
+ * returns false if the maximum number of keys is reached.
+ *****************************************************************************/
+
+bool s_sort_add_key(s_sort *sort, const int column, const enum e_direction direction) {
+
+	const int idx = s_sort_key_idx(sort, column);
+
+	if (idx >= 0 && sort->keys[idx].direction == direction) {
+
+		for (int i = idx; i < sort->no_keys - 1; i++) {
+			sort->keys[i] = sort->keys[i + 1];
+		}
+
+		if (--sort->no_keys == 0) {
+			sort->is_active = false;
+		}
+
+	} else if (idx >= 0) {
+		sort->keys[idx].direction = direction;
+
+	} else if (!sort->is_active) {
+		s_sort_update(sort, column, direction);
+
+	} else if (sort->no_keys < SORT_MAX_KEYS) {
+		sort->keys[sort->no_keys++] = (s_sort_key ) { .column = column, .direction = direction, .type = E_SORT_AUTO };
+
+	} else {
+		log_debug("Max keys reached: %d", sort->no_keys);
+		return false;
+	}
+
+	log_debug("Keys: %d active: %s", sort->no_keys, bool_str(sort->is_active));
+
+	return true;
+}
+
+/******************************************************************************
+ * The function switches the type of the key of a column to the next type. It
+ * returns false if the column is not used for sorting.
+ *****************************************************************************/
+
+bool s_sort_toggle_type(s_sort *sort, const int column) {
+
+	const int idx = s_sort_key_idx(sort, column);
+
+	if (idx < 0) {
+		return false;
+	}
+
+	sort->keys[idx].type = (sort->keys[idx].type + 1) % SORT_NO_TYPES;
+
+	log_debug("Column: %d type: %d", column, sort->keys[idx].type);
+
+	return true;
+}
+
+/******************************************************************************
+ * The function initializes the sort cache. The permutations are created on
+ * demand. The view with the id 0 is the unfiltered table.
+ *****************************************************************************/
+
+void s_sort_cache_init(s_sort_cache *cache, const int no_columns) {
+
+	cache->no_columns = no_columns;
+	cache->last_view = 0;
+
+	cache->perms = xmalloc(sizeof(s_sort_perm) * no_columns);
+
+	for (int column = 0; column < no_columns; column++) {
+		cache->perms[column].view = -1;
+		cache->perms[column].type = E_SORT_AUTO;
+		cache->perms[column].size = 0;
+		cache->perms[column].rows = NULL;
+		cache->perms[column].ranks = NULL;
+		cache->perms[column].no_ranks = 0;
+	}
+}
+
+/******************************************************************************
+ * The function frees the permutations of the sort cache.
+ *****************************************************************************/
+
+void s_sort_cache_free(s_sort_cache *cache) {
+
+	for (int column = 0; column < cache->no_columns; column++) {
+		free(cache->perms[column].rows);
+		free(cache->perms[column].ranks);
+	}
+
+	free(cache->perms);
+}
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_spans.h"
+#include "ncv_common.h"
+
+#include <stdint.h>
+
+/******************************************************************************
+ * The initial size of the spans array of an entry.
+ *****************************************************************************/
+
+#define SPANS_INIT_SIZE 8
+
+/******************************************************************************
+ * The function initializes the cache. The generation starts with 1, so the
+ * empty entries with generation 0 are outdated.
+ *****************************************************************************/
+
+void s_spans_cache_init(s_spans_cache *cache) {
+
+	cache->generation = 1;
+
+	for (int i = 0; i < SPANS_CACHE_SIZE; i++) {
+		cache->entries[i].field = NULL;
+		cache->entries[i].generation = 0;
+		cache->entries[i].spans = NULL;
+		cache->entries[i].count = 0;
+		cache->entries[i].size = 0;
+	}
+}
+
+/******************************************************************************
+ * The function frees the spans arrays of the cache entries.
+ *****************************************************************************/
+
+void s_spans_cache_free(s_spans_cache *cache) {
+
+	for (int i = 0; i < SPANS_CACHE_SIZE; i++) {
+		free(cache->entries[i].spans);
+		cache->entries[i].spans = NULL;
+		cache->entries[i].size = 0;
+	}
+}
+
+/******************************************************************************
+ * The function is called if the filter changed. It increments the generation,
+ * which makes all entries outdated.
+ *****************************************************************************/
+
+void s_spans_cache_invalidate(s_spans_cache *cache) {
+
+	cache->generation++;
+
+	log_debug("New generation: %u", cache->generation);
+}
+
+/******************************************************************************
+ * The function adds a span to a cache entry. The array grows on demand.
+ *****************************************************************************/
+
+static void s_spans_add(s_spans_entry *entry, const int line, const int start, const int len) {
+
+	if (entry->count == entry->size) {
+		entry->size = entry->size == 0 ? SPANS_INIT_SIZE : entry->size * 2;
+		entry->spans = xrealloc(entry->spans, sizeof(s_span) * entry->size);
+	}
+
+	entry->spans[entry->count].line = line;
+	entry->spans[entry->count].start = start;
+	entry->spans[entry->count].len = len;
+
+	entry->count++;
+}
+
+/******************************************************************************
+ * The function computes the spans of a field. The field is copied and the new
+ * lines are replaced by string terminators, so each line can be searched
+ * separately. A regex can have empty matches, which are not highlighted, so
+ * the search continues after the empty match.
+ *****************************************************************************/
+
+static void s_spans_compute(s_spans_entry *entry, const int column, const wchar_t *field, const s_filter *filter) {
+	wchar_t *ptr;
+	size_t offset;
+	size_t match_len;
+
+	entry->count = 0;
+
+	//
+	// The predicates of an expression, that compare the whole field, have to
+	// be checked with the field and not with its lines.
+	//
+	if (s_filter_is_expr(filter) && !s_filter_matches(filter, column, field)) {
+		return;
+	}
+
+	const size_t field_len = wcslen(field);
+
+	wchar_t *copy = xmalloc(sizeof(wchar_t) * (field_len + 1));
+	wmemcpy(copy, field, field_len + 1);
+
+	for (size_t i = 0; i < field_len; i++) {
+		if (copy[i] == W_NEW_LINE) {
+			copy[i] = W_STR_TERM;
+		}
+	}
+
+	wchar_t *line = copy;
+
+	for (int line_no = 0; line <= copy + field_len; line_no++) {
+		offset = 0;
+
+		while (line[offset] != W_STR_TERM) {
+
+			ptr = s_filter_search_match(filter, column, line, offset, &match_len);
+
+			while (ptr != NULL && match_len == 0) {
+				ptr = (*ptr == W_STR_TERM) ? NULL : s_filter_search_match(filter, column, line, ptr - line + 1, &match_len);
+			}
+
+			if (ptr == NULL) {
+				break;
+			}
+
+			s_spans_add(entry, line_no, ptr - line, match_len);
+
+			offset = ptr - line + match_len;
+		}
+
+		line += wcslen(line) + 1;
+	}
+
+	free(copy);
+}
+
+/******************************************************************************
+ * The function returns the cache entry with the spans of the field. If the
+ * entry is outdated or belongs to an other field, the spans are computed. The
+ * column of the field is required for expression filters.
+ *****************************************************************************/
+
+const s_spans_entry* s_spans_cache_get(s_spans_cache *cache, const int column, const wchar_t *field, const s_filter *filter) {
+
+	//
+	// Fibonacci hashing of the pointer. The lower bits are zero because of
+	// the alignment, so they are dropped.
+	//
+	const size_t idx = (size_t) ((((uintptr_t) field >> 3) * UINT64_C(11400714819323198485)) >> 32) % SPANS_CACHE_SIZE;
+
+	s_spans_entry *entry = &cache->entries[idx];
+
+	if (entry->field != field || entry->generation != cache->generation) {
+
+		s_spans_compute(entry, column, field, filter);
+
+		entry->field = field;
+		entry->generation = cache->generation;
+	}
+
+	return entry;
+}
@@ -24,6 +24,8 @@
 
 #include "ncv_table_sort.h"
 
+#include <string.h>
+
 /******************************************************************************
  * The widths and the heights have to be at least one. Otherwise the cursor
  * field will not be displayed.
@@ -31,6 +33,12 @@
 
 #define MIN_WIDTH_HEIGHT 1
 
+/******************************************************************************
+ * The initial size of the match index.
+ *****************************************************************************/
+
+#define MATCHES_INIT_SIZE 1024
+
 /******************************************************************************
  * The function initializes the internal structure of the table struct. The
  * main task is to allocate memory for the fields and the arrays for the column
@@ -72,12 +80,14 @@ void s_table_init(s_table *table, const int no_rows, const int no_columns) {
 
 	//
 	// Allocate a two dimensional array for the fields. The fields are not
-	// initialized.
+	// initialized. The rows are allocated in one block.
 	//
 	table->__fields = xmalloc(sizeof(wchar_t**) * no_rows);
 
+	wchar_t **block = xmalloc(sizeof(wchar_t*) * no_rows * no_columns);
+
 	for (int row = 0; row < no_rows; row++) {
-		table->__fields[row] = xmalloc(sizeof(wchar_t*) * no_columns);
+		table->__fields[row] = block + (size_t) row * no_columns;
 	}
 
 	//
@@ -91,6 +101,38 @@ void s_table_init(s_table *table, const int no_rows, const int no_columns) {
 	s_filter_init(&table->filter);
 
 	s_sort_set_inactive(&table->sort, true);
+
+	//
+	// The match index is allocated on the first search.
+	//
+	table->matches = NULL;
+	table->matches_size = 0;
+
+	table->match_limit = 0;
+	table->is_counting = false;
+
+	//
+	// The columns are parsed on demand.
+	//
+	table->num_cache = xmalloc(sizeof(s_num_column) * no_columns);
+
+	for (int column = 0; column < no_columns; column++) {
+		s_num_column_init(&table->num_cache[column]);
+	}
+
+	table->sort_cache = xmalloc(sizeof(s_sort_cache));
+	s_sort_cache_init(table->sort_cache, no_columns);
+
+	table->view = 0;
+
+	s_blocks_init(&table->blocks);
+
+	table->filter_cache = xmalloc(sizeof(s_lru));
+	s_lru_init(table->filter_cache);
+
+	s_bitmap_init(&table->combined);
+
+	table->progress = NULL;
 }
 
 /******************************************************************************
@@ -121,12 +163,43 @@ void s_table_free(s_table *table) {
 			//
 			free(table->__fields[row][column]);
 		}
+	}
 
-		free(table->__fields[row]);
+	//
+	// The rows are allocated in one block.
+	//
+	if (table->__no_rows > 0) {
+		free(table->__fields[0]);
 	}
 
 	free(table->__fields);
 	free(table->fields);
+
+	//
+	// Free the compiled regex of the filter and the match index.
+	//
+	s_filter_free(&table->filter);
+
+	free(table->matches);
+
+	//
+	// Free the parsed columns.
+	//
+	for (int column = 0; column < table->no_columns; column++) {
+		s_num_column_free(&table->num_cache[column]);
+	}
+
+	free(table->num_cache);
+
+	s_sort_cache_free(table->sort_cache);
+	free(table->sort_cache);
+
+	s_blocks_free(&table->blocks);
+
+	s_lru_free(table->filter_cache);
+	free(table->filter_cache);
+
+	s_bitmap_free(&table->combined);
 }
 
 /******************************************************************************
@@ -149,6 +222,7 @@ void s_table_reset_rows(s_table *table) {
 	}
 
 	table->no_rows = table->__no_rows;
+	table->view = 0;
 }
 
 /******************************************************************************
@@ -173,118 +247,412 @@ static bool s_table_reset_rows_opt(s_table *table) {
 }
 
 /******************************************************************************
- * The function searches in the table for the search string. The cursor is set
- * to the first match. The count member of the filter is set to the total
- * number of matches.
+ * The function adds the position of a field to the match index. The array
+ * grows on demand.
+ *****************************************************************************/
+
+static void s_table_add_match(s_table *table, const int row, const int col) {
+
+	if (table->filter.count >= table->matches_size) {
+		table->matches_size = table->matches_size == 0 ? MATCHES_INIT_SIZE : 2 * table->matches_size;
+		table->matches = xrealloc(table->matches, sizeof(s_field) * table->matches_size);
+	}
+
+	table->matches[table->filter.count].row = row;
+	table->matches[table->filter.count].col = col;
+
+	table->filter.count++;
+}
+
+/******************************************************************************
+ * The function allocates the memo for the checks of the blocks, which is
+ * initialized with -1 for: not checked.
+ *****************************************************************************/
+
+static signed char* s_table_block_memo(const s_table *table) {
+
+	signed char *memo = xmalloc(sizeof(signed char) * (table->blocks.no_blocks + 1));
+
+	for (int block = 0; block <= table->blocks.no_blocks; block++) {
+		memo[block] = -1;
+	}
+
+	return memo;
+}
+
+/******************************************************************************
+ * The function checks with the summaries, whether a row of a block may match
+ * the filter. The result is stored in the memo, so each block is checked only
+ * once. Without summaries, each row may match.
+ *****************************************************************************/
+
+static bool s_table_block_may_match(const s_table *table, signed char *memo, const int block) {
+
+	if (block >= table->blocks.no_blocks) {
+		return true;
+	}
+
+	if (memo[block] < 0) {
+		memo[block] = s_filter_may_match_block(&table->filter, &table->blocks, block, table->no_columns);
+	}
+
+	return memo[block];
+}
+
+/******************************************************************************
+ * The function searches the filtered and sorted table for the filter string
+ * and records the positions of all matching fields in the match index. The
+ * positions are in view order, so prev / next can do a binary search. The
+ * count member of the filter is set to the total number of matches and the
+ * cursor is set to the first match.
  * If the string was not found, then the cursor is unchanged and the filter
  * count is 0.
  *****************************************************************************/
 
-static void s_table_do_search(s_table *table, s_cursor *cursor) {
+static void s_table_index_matches(s_table *table, s_cursor *cursor) {
+	int row_idx;
 
-	log_debug("Do search the table data with: %ls", table->filter.str);
+	log_debug("Index the matches of the table data with: %ls", table->filter.str);
+
+	table->filter.count = 0;
+	table->is_counting = false;
 
 	//
-	// Reset the row pointers and the row heights, if the table is filtered.
+	// A search can stop early, the matches of a filter are always indexed,
+	// because the view is restricted to the matching rows anyway.
 	//
-	s_table_reset_rows_opt(table);
+	const int limit = s_filter_is_filtering(&table->filter) ? 0 : table->match_limit;
 
-	table->filter.count = 0;
+	//
+	// The number of columns that are searched, which may be restricted.
+	//
+	const int num_columns = s_filter_num_columns(&table->filter, table->no_columns);
 
-	for (int row = 0; row < table->__no_rows; row++) {
-		for (int column = 0; column < table->no_columns; column++) {
+	signed char *memo = s_table_block_memo(table);
+
+	//
+	// The occurrences of the patterns of a multi pattern filter are counted,
+	// which is done with the same scan of a field as the matching.
+	//
+	s_aho *aho = table->filter.aho;
+
+	if (aho != NULL) {
+		s_aho_reset_counts(aho);
+	}
+
+	s_progress_phase(table->progress, E_PHASE_INDEX, table->no_rows);
+
+	for (int row = 0; row < table->no_rows; row++) {
+
+		//
+		// If the update is cancelled, the result is thrown away.
+		//
+		if (s_progress_step(table->progress, row)) {
+			free(memo);
+			return;
+		}
+
+		row_idx = s_table_row_idx(table, table->fields[row]);
+
+		//
+		// The rows may be sorted, so the blocks are checked row by row.
+		//
+		if (!s_table_block_may_match(table, memo, s_blocks_of_row(row_idx))) {
+			continue;
+		}
+
+		//
+		// An expression is evaluated for the whole row. Only the fields of
+		// matching rows are indexed.
+		//
+		if (s_filter_is_expr(&table->filter) && !s_filter_matches_row(&table->filter, table->fields[row], row_idx, table->no_columns)) {
+			continue;
+		}
+
+		const int count = table->filter.count;
+
+		for (int idx = 0; idx < num_columns; idx++) {
+			const int column = s_filter_get_column(&table->filter, idx);
 
 			//
 			// Check if the field content matches the search string.
 			//
-			if (s_filter_search_str(&table->filter, table->__fields[row][column]) != NULL) {
+			if (aho != NULL ? s_aho_count(aho, table->fields[row][column]) > 0 : s_filter_matches(&table->filter, column, table->fields[row][column])) {
+				s_table_add_match(table, row, column);
+			}
+		}
 
-				//
-				// Set the cursor to the first found field.
-				//
-				if (table->filter.count == 0) {
-					s_cursor_pos(cursor, row, column);
-				}
+		//
+		// A row can match an expression without a matching field, for
+		// example with: NOT col=value. In this case the first field of the
+		// row is the match.
+		//
+		if (s_filter_is_expr(&table->filter) && count == table->filter.count) {
+			s_table_add_match(table, row, 0);
+		}
 
-				table->filter.count++;
+		if (count < table->filter.count) {
+			s_progress_found(table->progress, table->filter.count);
+
+			//
+			// If the limit is reached, the remaining rows are counted later.
+			//
+			if (limit > 0 && table->filter.count >= limit && row < table->no_rows - 1) {
+				table->is_counting = true;
+				break;
 			}
 		}
 	}
 
-	log_debug("Found total: %d cursor row: %d col: %d", table->filter.count, cursor->row, cursor->col);
+	free(memo);
+
+	//
+	// Set the cursor to the first found field.
+	//
+	if (table->filter.count > 0) {
+		s_cursor_pos(cursor, table->matches[0].row, table->matches[0].col);
+	}
+
+	log_debug("Found total: %d counting: %s cursor row: %d col: %d", table->filter.count, bool_2_str(table->is_counting), cursor->row, cursor->col);
 }
 
 /******************************************************************************
- * The function filters the table with the filtering string. The cursor is set
- * to the first match. The count member of the filter is set to the total
- * number of matches.
- * If the string was not found, then the cursor is unchanged and the filter
- * count is 0.
+ * The function filters the table with the filtering string. The rows that
+ * contain a matching field are added to the filtered table. The search in a
+ * row stops with the first match, the positions of the matches are recorded
+ * by s_table_index_matches() after sorting the filtered rows. The function
+ * returns true if at least one row matches.
+ *
+ * The rows that are filtered are given by the parameters. This is typically
+ * the unfiltered table, but on a refinement it is the current view of the
+ * table, which is filtered in place. This works, because the rows are only
+ * moved to the front.
+ *
+ * If the bit set is not NULL, the indices of the matching rows in the
+ * unfiltered table are set.
  *****************************************************************************/
 
-static void s_table_do_filter(s_table *table, s_cursor *cursor) {
+static bool s_table_do_filter(s_table *table, wchar_t ***src_fields, int *src_height, const int src_no_rows, uint64_t *bits) {
 	bool found_in_row;
+	bool found = false;
+	int row_idx, block;
 
 	log_debug("Do filter the table data with: %ls", table->filter.str);
 
 	//
-	// Init the number of rows of the filtered table and the number of matches.
+	// Init the number of rows of the filtered table, which is a new view.
 	//
 	table->no_rows = 0;
-	table->filter.count = 0;
+	table->view = ++table->sort_cache->last_view;
 
-	for (int row = 0; row < table->__no_rows; row++) {
+	signed char *memo = s_table_block_memo(table);
 
-		found_in_row = false;
+	s_progress_phase(table->progress, E_PHASE_FILTER, src_no_rows);
 
-		for (int column = 0; column < table->no_columns; column++) {
+	for (int row = 0; row < src_no_rows; row++) {
 
-			//
-			// Check if the field content matches the search string.
-			//
-			if (s_filter_search_str(&table->filter, table->__fields[row][column]) != NULL) {
-
-				//
-				// The first match in the row
-				//
-				if (!found_in_row) {
-					found_in_row = true;
-
-					//
-					// Set the cursor to the first found field.
-					//
-					if (table->filter.count == 0) {
-						s_cursor_pos(cursor, table->no_rows, column);
-					}
-
-					//
-					// Add the current row to the result by setting the fields
-					// pointer, the height and update the number of rows. This
-					// is something, that we want only once for a row.
-					//
-					//
-					table->fields[table->no_rows] = table->__fields[row];
-					table->height[table->no_rows] = table->__height[row];
-
-					table->no_rows++;
-				}
-
-				table->filter.count++;
-			}
+		//
+		// If the update is cancelled, the result is thrown away.
+		//
+		if (s_progress_step(table->progress, row)) {
+			free(memo);
+			return false;
+		}
+
+		row_idx = s_table_row_idx(table, src_fields[row]);
+		block = s_blocks_of_row(row_idx);
+
+		//
+		// Check if the row matches the filter. A row of a block that cannot
+		// match is skipped. The search stops with the first matching field,
+		// an expression stops with the first predicate that decides the
+		// result.
+		//
+		found_in_row = s_table_block_may_match(table, memo, block) && s_filter_matches_row(&table->filter, src_fields[row], row_idx, table->no_columns);
+
+		//
+		// If the rows are in the original order, the rest of a block that
+		// cannot match is skipped. The header row is never skipped.
+		//
+		if (!found_in_row && src_fields == table->__fields && !s_table_block_may_match(table, memo, block) && !(table->show_header && row == 0)) {
+			row = min_or_equal(src_no_rows, (block + 1) * BLOCK_ROWS) - 1;
+			continue;
+		}
+
+		if (found_in_row && bits != NULL) {
+			s_bits_set(bits, row_idx);
 		}
 
 		//
 		// If show header is configured, then the header line is always part of
 		// the filtered table.
 		//
-		if (table->show_header && row == 0 && table->filter.count == 0) {
-			table->fields[0] = table->__fields[0];
-			table->height[0] = table->__height[0];
-			table->no_rows = 1;
+		if (found_in_row || (table->show_header && row == 0)) {
+
+			//
+			// Add the current row to the result by setting the fields pointer,
+			// the height and update the number of rows.
+			//
+			table->fields[table->no_rows] = src_fields[row];
+			table->height[table->no_rows] = src_height[row];
+
+			table->no_rows++;
+		}
+
+		found = found || found_in_row;
+	}
+
+	free(memo);
+
+	log_debug("Found: %s rows: %d", bool_2_str(found), table->no_rows);
+
+	return found;
+}
+
+/******************************************************************************
+ * The function sets the rows of the bitmap as the filtered table, in the
+ * order of the unfiltered table. If show header is configured, the header is
+ * always part of the filtered table. The function returns true if the bitmap
+ * is not empty.
+ *****************************************************************************/
+
+static bool s_table_apply_bitmap(s_table *table, const s_bitmap *bitmap) {
+
+	uint64_t *bits = xmalloc(sizeof(uint64_t) * s_bits_words(table->__no_rows));
+	s_bitmap_to_bits(bitmap, bits, table->__no_rows);
+
+	table->no_rows = 0;
+	table->view = ++table->sort_cache->last_view;
+
+	for (int row = 0; row < table->__no_rows; row++) {
+
+		if (s_bits_get(bits, row) || (table->show_header && row == 0)) {
+			table->fields[table->no_rows] = table->__fields[row];
+			table->height[table->no_rows] = table->__height[row];
+
+			table->no_rows++;
+		}
+	}
+
+	free(bits);
+
+	log_debug("Rows: %d matching: %d", table->no_rows, s_bitmap_cardinality(bitmap));
+
+	return s_bitmap_cardinality(bitmap) > 0;
+}
+
+/******************************************************************************
+ * The function filters the unfiltered table. The matching rows of recent
+ * filters are cached as compressed bitmaps, so a cached filter is applied
+ * without a scan of the table. Otherwise the table is filtered and the
+ * matching rows are added to the cache. The function returns true if at
+ * least one row matches.
+ *****************************************************************************/
+
+static bool s_table_filter_cached(s_table *table) {
+	wchar_t key[FILTER_KEY_LEN + 1];
+	s_bitmap bitmap;
+
+	if (!s_filter_cache_key(&table->filter, key, FILTER_KEY_LEN + 1)) {
+		return s_table_do_filter(table, table->__fields, table->__height, table->__no_rows, NULL);
+	}
+
+	const s_bitmap *cached = s_lru_get(table->filter_cache, key);
+
+	if (cached != NULL) {
+		return s_table_apply_bitmap(table, cached);
+	}
+
+	const size_t size = sizeof(uint64_t) * s_bits_words(table->__no_rows);
+
+	uint64_t *bits = xmalloc(size);
+	memset(bits, 0, size);
+
+	const bool found = s_table_do_filter(table, table->__fields, table->__height, table->__no_rows, bits);
+
+	//
+	// The result of a cancelled update is incomplete.
+	//
+	if (!s_progress_is_cancelled(table->progress)) {
+		s_bitmap_from_bits(&bitmap, bits, table->__no_rows);
+		s_lru_put(table->filter_cache, key, &bitmap);
+	}
+
+	free(bits);
+
+	return found;
+}
+
+/******************************************************************************
+ * The function returns the parsed numerical values of a column. The column is
+ * parsed with the first call. If the parsing is cancelled, the function
+ * returns NULL.
+ *****************************************************************************/
+
+const s_num_column* s_table_num_column(s_table *table, const int column) {
+	s_num_column *num_column = &table->num_cache[column];
+
+	if (!s_num_column_parse(num_column, table->__fields, table->__no_rows, column, table->progress)) {
+		return NULL;
+	}
+
+	return num_column;
+}
+
+/******************************************************************************
+ * The function creates the bitmaps of the numeric ranges of an expression
+ * filter, that are not created. It returns false if it was cancelled.
+ *****************************************************************************/
+
+static bool s_table_apply_ranges(s_table *table) {
+	const s_num_column *num_column;
+	int no_ranges;
+
+	s_num_range *ranges = s_expr_get_ranges(table->filter.expr, &no_ranges);
+
+	for (int i = 0; i < no_ranges; i++) {
+
+		if (ranges[i].bitmap != NULL) {
+			continue;
+		}
+
+		if ((num_column = s_table_num_column(table, ranges[i].column)) == NULL) {
+			return false;
 		}
+
+		s_num_range_apply(&ranges[i], num_column, table->__no_rows);
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function returns the message for a filter, that cannot be prepared.
+ *****************************************************************************/
+
+static wchar_t* s_table_invalid_filter_msg(const s_filter *filter) {
+
+	if (s_filter_is_restricted(filter) && filter->col_bits == NULL) {
+		return L"Invalid columns!";
+	}
+
+	if (s_filter_is_expr(filter)) {
+		return L"Invalid filter expression!";
+	}
+
+	if (filter->is_regex) {
+		return L"Invalid regular expression!";
+	}
+
+	if (filter->is_fuzzy) {
+		return L"Fuzzy pattern is too long!";
+	}
+
+	if (filter->is_multi && filter->str[0] == FILTER_MULTI_FILE) {
+		return L"Invalid pattern file!";
 	}
 
-	log_debug("Found total: %d rows: %d cursor row: %d col: %d", table->filter.count, table->no_rows, cursor->row, cursor->col);
+	return L"No patterns found!";
 }
 
 /******************************************************************************
@@ -309,6 +677,25 @@ wchar_t* s_table_update_filter_sort(s_table *table, s_cursor *cursor, const bool
 
 	bool did_reset = false;
 
+	//
+	// Compile the regex, the expression, the fuzzy pattern or the pattern
+	// automaton of the filter, if it changed or if the table is a copy for a
+	// background update. The column names of an expression are taken from the
+	// header. If the filter is not valid, it is deactivated.
+	//
+	if ((filter_changed || !s_filter_is_prepared(&table->filter)) && !s_filter_prepare(&table->filter, table->show_header && table->__no_rows > 0 ? table->__fields[0] : NULL, table->no_columns)) {
+		s_filter_set_inactive(&table->filter);
+		result = s_table_invalid_filter_msg(&table->filter);
+	}
+
+	//
+	// The numeric comparisons of an expression are evaluated with the parsed
+	// columns. If the parsing is cancelled, the result is thrown away.
+	//
+	if (s_filter_is_active(&table->filter) && s_filter_is_expr(&table->filter) && !s_table_apply_ranges(table)) {
+		return NULL;
+	}
+
 	if (s_filter_is_active(&table->filter)) {
 
 		//
@@ -317,30 +704,29 @@ wchar_t* s_table_update_filter_sort(s_table *table, s_cursor *cursor, const bool
 		if (s_filter_is_filtering(&table->filter)) {
 
 			//
-			// Filtering does an implicit reset.
+			// Filtering does an implicit reset. If no row matches,
+			// deactivate the filtering and set an error message. If the
+			// filter is unchanged, a combined view is restored from its
+			// bitmap.
 			//
-			s_table_do_filter(table, cursor);
+			if (!filter_changed && s_table_is_combined(table)) {
+				s_table_apply_bitmap(table, &table->combined);
+
+			} else if (!s_table_filter_cached(table)) {
+				s_filter_set_inactive(&table->filter);
+				result = L"No matches found!";
+
+				s_table_reset_rows(table);
+			}
+
 			did_reset = true;
 
 		} else {
-			s_table_do_search(table, cursor);
-		}
-
-		//
-		// If no match was found, deactivate the filtering and set an error
-		// message.
-		//
-		if (!s_filter_has_matches(&table->filter)) {
-			s_filter_set_inactive(&table->filter);
-			result = L"No matches found!";
 
 			//
-			// If filtering is active, the table has to be reset. At this
-			// point: "did_reset = true;" is already set.
+			// Searching is done on the unfiltered table.
 			//
-			if (s_filter_is_filtering(&table->filter)) {
-				s_table_reset_rows(table);
-			}
+			s_table_reset_rows_opt(table);
 		}
 
 	} else {
@@ -372,18 +758,273 @@ wchar_t* s_table_update_filter_sort(s_table *table, s_cursor *cursor, const bool
 		}
 	}
 
+	//
+	// Record the positions of the matches in the filtered and sorted table.
+	// If no match was found, deactivate the searching and set an error
+	// message.
+	//
+	if (s_filter_is_active(&table->filter)) {
+		s_table_index_matches(table, cursor);
+
+		if (!s_filter_has_matches(&table->filter)) {
+			s_filter_set_inactive(&table->filter);
+			result = L"No matches found!";
+		}
+	}
+
 	return result;
 }
 
+/******************************************************************************
+ * The function refines the filtering of the table. It is called with a table,
+ * that is filtered and sorted, and a filter, that is a refinement of the
+ * filter that was used (see: s_filter_is_refinement()). So only the rows of
+ * the current view have to be filtered. The sorting is preserved, because the
+ * order of the rows does not change. If no row matches, the function falls
+ * back to a normal update, which resets the table.
+ *****************************************************************************/
+
+wchar_t* s_table_refine_filter(s_table *table, s_cursor *cursor) {
+
+	wchar_t key[FILTER_KEY_LEN + 1];
+
+	log_debug("Refine filter with: %ls rows: %d", table->filter.str, table->no_rows);
+
+	//
+	// The columns of a restricted filter are created for the copy of the
+	// table. If they are not valid, the update sets the message.
+	//
+	if (!s_filter_is_prepared(&table->filter) && !s_filter_prepare(&table->filter, table->show_header && table->__no_rows > 0 ? table->__fields[0] : NULL, table->no_columns)) {
+		return s_table_update_filter_sort(table, cursor, true, false);
+	}
+
+	//
+	// If the result of the filter is cached, the table is updated with the
+	// cached rows, which is faster than filtering the view.
+	//
+	const bool is_cached = s_filter_cache_key(&table->filter, key, FILTER_KEY_LEN + 1);
+
+	if ((is_cached && s_lru_get(table->filter_cache, key) != NULL) || !s_table_do_filter(table, table->fields, table->height, table->no_rows, NULL)) {
+		return s_table_update_filter_sort(table, cursor, true, false);
+	}
+
+	s_table_index_matches(table, cursor);
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function creates a bitmap with the rows of the current view, which are
+ * the rows of the filtered table without the header.
+ *****************************************************************************/
+
+static void s_table_view_bitmap(const s_table *table, s_bitmap *bitmap) {
+	int row_idx;
+
+	const size_t size = sizeof(uint64_t) * s_bits_words(table->__no_rows);
+
+	uint64_t *bits = xmalloc(size);
+	memset(bits, 0, size);
+
+	for (int row = 0; row < table->no_rows; row++) {
+		row_idx = s_table_row_idx(table, table->fields[row]);
+
+		if (!table->show_header || row_idx != 0) {
+			s_bits_set(bits, row_idx);
+		}
+	}
+
+	s_bitmap_from_bits(bitmap, bits, table->__no_rows);
+
+	free(bits);
+}
+
+/******************************************************************************
+ * The function combines the current view of an active filter with the rows
+ * of the previous filter from the cache (AND / OR) or replaces the view with
+ * the rows that are not in the view (NOT). The combination is done with the
+ * compressed bitmaps, without a scan of the table. The rows are sorted, if
+ * the sorting is active, and the matches of the current filter are indexed.
+ * On success the function returns NULL, otherwise a message and the table is
+ * unchanged. The function is called with a copy of the table in a background
+ * thread, so the filter may have to be prepared.
+ *****************************************************************************/
+
+wchar_t* s_table_combine_filter(s_table *table, s_cursor *cursor, const enum e_combine combine) {
+	wchar_t key[FILTER_KEY_LEN + 1];
+	s_bitmap view, result;
+	const s_bitmap *other = NULL;
+
+	if (!s_filter_is_active(&table->filter) || !s_filter_is_filtering(&table->filter)) {
+		return L"No filter to combine!";
+	}
+
+	if (!s_filter_is_prepared(&table->filter) && !s_filter_prepare(&table->filter, table->show_header && table->__no_rows > 0 ? table->__fields[0] : NULL, table->no_columns)) {
+		log_exit("Unable to prepare filter: %ls", table->filter.str);
+	}
+
+	if (s_filter_is_expr(&table->filter) && !s_table_apply_ranges(table)) {
+		return NULL;
+	}
+
+	if (combine != E_COMBINE_NOT) {
+
+		if (!s_filter_cache_key(&table->filter, key, FILTER_KEY_LEN + 1)) {
+			key[0] = W_STR_TERM;
+		}
+
+		if ((other = s_lru_get_other(table->filter_cache, key)) == NULL) {
+			return L"No previous filter!";
+		}
+	}
+
+	s_table_view_bitmap(table, &view);
+
+	switch (combine) {
+
+	case E_COMBINE_AND:
+		s_bitmap_combine(&result, &view, other, E_BITMAP_AND);
+		break;
+
+	case E_COMBINE_OR:
+		s_bitmap_combine(&result, &view, other, E_BITMAP_OR);
+		break;
+
+	default:
+		s_bitmap_not(&result, &view, table->__no_rows);
+		break;
+	}
+
+	s_bitmap_free(&view);
+
+	//
+	// The header row is not part of the view.
+	//
+	if (s_bitmap_cardinality(&result) - (table->show_header && s_bitmap_contains(&result, 0) ? 1 : 0) == 0) {
+		s_bitmap_free(&result);
+		return L"No rows left!";
+	}
+
+	s_bitmap_free(&table->combined);
+	table->combined = result;
+
+	s_table_apply_bitmap(table, &table->combined);
+
+	if (s_sort_is_active(&table->sort)) {
+		s_table_do_sort(table);
+	}
+
+	//
+	// The cursor is moved to the first match of the view. The rows of the
+	// view may not contain a match, so the cursor is reset first.
+	//
+	s_cursor_pos(cursor, 0, 0);
+
+	s_table_index_matches(table, cursor);
+
+	return NULL;
+}
+
+/******************************************************************************
+ * The function indexes all matches of a search, after the indexing stopped
+ * with the first matches (see: match_limit). It is called with a copy of the
+ * table in a background thread, so the filter has to be prepared. The cursor
+ * is not changed, because the user may have moved it in the meantime.
+ *****************************************************************************/
+
+void s_table_count_matches(s_table *table) {
+	s_cursor cursor;
+
+	log_debug("Count the matches of: %ls", table->filter.str);
+
+	if (!s_filter_is_prepared(&table->filter) && !s_filter_prepare(&table->filter, table->show_header && table->__no_rows > 0 ? table->__fields[0] : NULL, table->no_columns)) {
+		log_exit("Unable to prepare filter: %ls", table->filter.str);
+	}
+
+	if (s_filter_is_expr(&table->filter) && !s_table_apply_ranges(table)) {
+		return;
+	}
+
+	table->match_limit = 0;
+	s_cursor_pos(&cursor, 0, 0);
+
+	s_table_index_matches(table, &cursor);
+}
+
+/******************************************************************************
+ * The function compares a field position with a row and a column in view
+ * order.
+ *****************************************************************************/
+
+static inline int s_table_match_cmp(const s_field *match, const int row, const int col) {
+
+	if (match->row != row) {
+		return match->row < row ? -1 : 1;
+	}
+
+	return match->col < col ? -1 : (match->col > col ? 1 : 0);
+}
+
+/******************************************************************************
+ * The function does a binary search in the match index. It returns the index
+ * of the first match that is greater than the position (upper is true) or
+ * greater or equal than the position (upper is false). If there is no such
+ * match, the number of matches is returned.
+ *****************************************************************************/
+
+static int s_table_match_bound(const s_table *table, const int row, const int col, const bool upper) {
+	int low = 0;
+	int high = table->filter.count;
+	int mid, cmp;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		cmp = s_table_match_cmp(&table->matches[mid], row, col);
+
+		if (cmp < 0 || (upper && cmp == 0)) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+/******************************************************************************
+ * The function returns the index of the match at the cursor position or -1 if
+ * the field at the cursor position is not a match.
+ *****************************************************************************/
+
+int s_table_match_idx(const s_table *table, const s_cursor *cursor) {
+
+	if (!s_filter_is_active(&table->filter)) {
+		return -1;
+	}
+
+	const int idx = s_table_match_bound(table, cursor->row, cursor->col, false);
+
+	if (idx < table->filter.count && s_table_match_cmp(&table->matches[idx], cursor->row, cursor->col) == 0) {
+		return idx;
+	}
+
+	return -1;
+}
+
 /******************************************************************************
  * The function is called if the table is filtered and searches for the prev /
  * next field that contains the filter string. The cursor is updated with the
  * new position. If the cursor position changed, the function returns true. The
  * cursor position does not change, if there is only one field in the whole
  * table that contains the filter string.
+ *
+ * The positions of the matches are recorded in the match index, so the
+ * function does a binary search with the cursor position and wraps around at
+ * the start / end of the index.
  *****************************************************************************/
 
 bool s_table_prev_next(const s_table *table, s_cursor *cursor, const enum e_direction direction) {
+	int idx;
 
 	//
 	// The filter has to be set to find the next matching field.
@@ -403,89 +1044,50 @@ bool s_table_prev_next(const s_table *table, s_cursor *cursor, const enum e_dire
 
 	log_debug("Cursor row: %d col: %d", cursor->row, cursor->col);
 
-	//
-	// The start position is the current cursor position.
-	//
-	int row_cur = cursor->row;
-	int col_cur = cursor->col;
-
-	//
-	// The flag shows whether the row position has to be updated.
-	//
-	bool update_row = false;
-
-	while (true) {
-
-		//
-		// First go with the column to the direction.
-		//
-		col_cur += direction;
-
-		//
-		// Ensure that the column is still in its range. If the column position
-		// has to be adjusted, we move to the prev / next row.
-		//
-		if (col_cur < 0) {
-			col_cur = table->no_columns - 1;
-			update_row = true;
-
-		} else if (col_cur >= table->no_columns) {
-			col_cur = 0;
-			update_row = true;
-		}
+	if (direction == E_DIR_FORWARD) {
 
 		//
-		// Check if we have to change the row.
+		// The first match after the cursor or the first match.
 		//
-		if (update_row) {
-			update_row = false;
-
-			//
-			// Move the row in the direction and adjust if necessary.
-			//
-			row_cur += direction;
+		idx = s_table_match_bound(table, cursor->row, cursor->col, true);
 
-			if (row_cur < 0) {
-				row_cur = table->no_rows - 1;
-
-			} else if (row_cur >= table->no_rows) {
-				row_cur = 0;
-			}
+		if (idx >= table->filter.count) {
+			idx = 0;
 		}
 
-		log_debug("New cursor row: %d column: %d", row_cur, col_cur);
+	} else {
 
 		//
-		// If there is only one filter match, we end up at the initial cursor
-		// position and we are finished.
+		// The last match before the cursor or the last match.
 		//
-		if (row_cur == cursor->row && col_cur == cursor->col) {
-			log_debug_str("Search reached the initial cursor position.");
+		idx = s_table_match_bound(table, cursor->row, cursor->col, false) - 1;
 
-			//
-			// Return false to indicate that nothing changed.
-			//
-			return false;
+		if (idx < 0) {
+			idx = table->filter.count - 1;
 		}
+	}
+
+	//
+	// If there is only one filter match, we end up at the initial cursor
+	// position and we are finished.
+	//
+	if (s_table_match_cmp(&table->matches[idx], cursor->row, cursor->col) == 0) {
+		log_debug_str("Search reached the initial cursor position.");
 
 		//
-		// Found prev / next field that contains the filter string.
+		// Return false to indicate that nothing changed.
 		//
-		if (s_filter_search_str(&table->filter, table->fields[row_cur][col_cur]) != NULL) {
+		return false;
+	}
 
-			//
-			// Set the cursor to the first found field.
-			//
-			s_cursor_pos(cursor, row_cur, col_cur);
+	s_cursor_pos(cursor, table->matches[idx].row, table->matches[idx].col);
 
-			log_debug("Found cursor row: %d col: %d", cursor->row, cursor->col);
+	log_debug("Found match: %d cursor row: %d col: %d", idx, cursor->row, cursor->col);
 
-			//
-			// Return true to indicate that the cursor position changed.
-			//
-			return true;
-		}
-	}
+	//
+	// Return true to indicate that the cursor position changed.
+	//
+	return true;
 }
 
 /******************************************************************************
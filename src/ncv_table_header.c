@@ -160,9 +160,54 @@ int check_column_characteristic(const s_table *table, const int max_rows, const
 	return 0;
 }
 
+/******************************************************************************
+ * The function infers the type of a column from the rows after the first row.
+ * If the column is a date, a numerical or a boolean column, the first row has
+ * to have that type or it is a header. String columns are not decisive.
+ *****************************************************************************/
+
+bool check_column_type(const s_table *table, const int max_rows, const int column, const wchar_t decimal) {
+	const wchar_t *suffix;
+	unsigned int candidates;
+	s_date_fmt date_fmt;
+	s_num_infer infer;
+	int64_t epoch;
+	double value;
+	bool is_bool;
+
+	//
+	// A date column has a header if the first row is not a date.
+	//
+	if (s_date_detect(table->__fields, 1, max_rows, column, &candidates, &date_fmt)) {
+		return !wcs_is_empty(table->__fields[0][column]) && !s_date_parse(&date_fmt, table->__fields[0][column], &epoch);
+	}
+
+	s_num_infer_init(&infer);
+
+	for (int row = 1; row < max_rows; row++) {
+
+		if (wcs_is_empty(table->__fields[row][column])) {
+			continue;
+		}
+
+		if (s_num_parse_field(table->__fields[row][column], decimal, &value, &suffix, &is_bool)) {
+			s_num_infer_add(&infer, value, suffix, is_bool);
+
+		} else {
+			s_num_infer_add(&infer, NAN, NULL, false);
+		}
+	}
+
+	log_debug("Col: %d type: %d", column, s_num_infer_type(&infer));
+
+	return !s_num_infer_matches(&infer, table->__fields[0][column], decimal);
+}
+
 /******************************************************************************
  * The function checks the first HA_MAX_ROWS rows to decide whether the table
- * has a header or not.
+ * has a header or not. A column with a type, whose first row does not have
+ * the type, is one vote for a header, like the string lengths and the ratios
+ * of the digits, so a single stray value does not decide.
  *****************************************************************************/
 
 bool s_table_has_header(const s_table *table) {
@@ -186,8 +231,18 @@ bool s_table_has_header(const s_table *table) {
 
 	int no_sucessful_checks = 0;
 
+	const wchar_t decimal = s_num_decimal_point();
+
 	for (int column = 0; column < table->no_columns; column++) {
 
+		//
+		// Check the type of the column.
+		//
+		no_sucessful_checks += check_column_type(table, max_rows, column, decimal) ? 1 : 0;
+		if (no_sucessful_checks >= max_successful) {
+			return true;
+		}
+
 		//
 		// Check the string lengths
 		//
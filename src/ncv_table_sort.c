@@ -23,27 +23,44 @@
  */
 
 #include "ncv_table.h"
+#include "ncv_psort.h"
 
-#include <errno.h>
 #include <string.h>
 #include <float.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * The numerical sorting is done with a LSD radix sort on 64 bit keys. Each
+ * pass sorts by a digit of RADIX_BITS bits, so RADIX_PASSES passes are
+ * necessary for the 64 bits.
+ *****************************************************************************/
+
+#define RADIX_BITS 11
+
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+#define RADIX_MASK (RADIX_SIZE - 1)
+
+#define RADIX_PASSES ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+#define radix_digit(k,p) (((k) >> ((p) * RADIX_BITS)) & RADIX_MASK)
 
 /******************************************************************************
  * The struct is used to sort the table by a column with numerical values. A
- * helper array is created, that contains the numerical values, represented by
- * a double value. This helper array is sorted and the sorting is applied to
- * the table. The helper array consists of s_comp_num elements.
+ * helper array is created, that contains the numerical values, encoded as an
+ * unsigned 64 bit key, which has the same order as the double values. This
+ * helper array is sorted and the sorting is applied to the table. The helper
+ * array consists of s_comp_num elements.
  *****************************************************************************/
 
 typedef struct s_comp_num {
 
 	//
-	// The double value of a wchar_t string. Empty strings are represented with
-	// DBL_MAX, so that they appear at the end of the sorted column, with a
-	// forward direction.
-	//
+	// The key of the double value of a wchar_t string. Empty strings are
+	// represented with DBL_MAX, so that they appear at the end of the sorted
+	// column, with a forward direction.
 	//
-	double value;
+	uint64_t key;
 
 	//
 	// A pointer to the row that contains the column value.
@@ -53,187 +70,562 @@ typedef struct s_comp_num {
 } s_comp_num;
 
 /******************************************************************************
- * The function is a callback function for the sorting of numerical values. It
- * is called with two s_comp_num pointers and a pointer to a s_sort struct,
- * which contains the column and the direction. The function compares the
- * column values by their corresponding double value and applies the direction.
+ * The string sorting works on an array with the prefixes of the strings, so
+ * most comparisons do not access the strings. A prefix consists of
+ * WCS_PREFIX_WORDS words, each with WCS_CHARS_PER_WORD chars of 21 bits,
+ * which is enough for all unicode chars. A shorter string is padded with
+ * 0 chars.
  *****************************************************************************/
 
-static int compare_num(const void *ptr_1, const void *ptr_2, void *sort_ptr) {
+#define WCS_PREFIX_WORDS 3
+
+#define WCS_CHARS_PER_WORD 3
+
+#define WCS_CHAR_BITS 21
+
+#define WCS_PREFIX_CHARS (WCS_PREFIX_WORDS * WCS_CHARS_PER_WORD)
+
+typedef struct s_comp_wcs {
 
 	//
-	// Get the s_sort stuct for the sort direction and column.
+	// The packed prefix of the string of the sort column.
 	//
-	const s_sort *sort = (const s_sort*) sort_ptr;
-
-	const s_comp_num *comp_num_1 = (const s_comp_num*) ptr_1;
-	const s_comp_num *comp_num_2 = (const s_comp_num*) ptr_2;
+	uint64_t prefix[WCS_PREFIX_WORDS];
 
 	//
-	// Compare the double values. The difference would be ok, but we have to
-	// return an int value not a double.
+	// A pointer to the row that contains the column value.
 	//
-	int result;
-	if (comp_num_1->value > comp_num_2->value) {
-		result = (sort->direction);
+	wchar_t **row;
+
+} s_comp_wcs;
+
+/******************************************************************************
+ * The struct is the context of the callback function for the sorting of
+ * wchar_t strings. It contains the table and the column to sort.
+ *****************************************************************************/
+
+typedef struct s_wcs_ctx {
+
+	s_table *table;
 
-	} else if (comp_num_1->value < comp_num_2->value) {
-		result = -1 * (sort->direction);
+	int column;
 
-	} else {
-		result = 0;
+} s_wcs_ctx;
+
+/******************************************************************************
+ * The function packs the prefix of a string. The chars are compared as
+ * unsigned values, like wcscmp does with valid unicode chars.
+ *****************************************************************************/
+
+static void wcs_prefix(s_comp_wcs *comp, const wchar_t *str) {
+	uint64_t word;
+
+	for (int w = 0; w < WCS_PREFIX_WORDS; w++) {
+		word = 0;
+
+		for (int c = 0; c < WCS_CHARS_PER_WORD; c++) {
+			word <<= WCS_CHAR_BITS;
+
+			if (*str != W_STR_TERM) {
+				word |= (uint32_t) *str++ & ((1 << WCS_CHAR_BITS) - 1);
+			}
+		}
+
+		comp->prefix[w] = word;
 	}
+}
 
-	log_debug("Direction: %s result: %d '%ls' '%ls'", e_direction_str(sort->direction), result, comp_num_1->row[sort->column], comp_num_2->row[sort->column]);
+/******************************************************************************
+ * The function compares the strings of two s_comp_wcs. If the prefixes are
+ * equal and the prefix contains the whole string (the last char is 0), the
+ * strings are equal. Otherwise the rest of the strings are compared.
+ *****************************************************************************/
 
-	return result;
+static int wcs_cmp(const s_comp_wcs *comp_1, const s_comp_wcs *comp_2, const int column) {
+
+	for (int w = 0; w < WCS_PREFIX_WORDS; w++) {
+		if (comp_1->prefix[w] != comp_2->prefix[w]) {
+			return comp_1->prefix[w] < comp_2->prefix[w] ? -1 : 1;
+		}
+	}
+
+	if ((comp_1->prefix[WCS_PREFIX_WORDS - 1] & ((1 << WCS_CHAR_BITS) - 1)) == 0) {
+		return 0;
+	}
+
+	return wcscmp(comp_1->row[column] + WCS_PREFIX_CHARS, comp_2->row[column] + WCS_PREFIX_CHARS);
 }
 
 /******************************************************************************
  * The function is a callback function for the sorting of wchar_t strings. It
- * is called with two row pointers and a pointer to a s_sort struct, which
- * contains the column and the direction. The function gets the two wchar_t
- * string for the rows and the column and compares them according to the
- * direction.
+ * is called with two s_comp_wcs pointers and a pointer to a s_wcs_ctx with
+ * the table and the column. The function compares the prefixes and only if
+ * they are equal, the strings. Equal strings are compared by the position of
+ * the rows in the table, so the sorting is stable. The direction is applied,
+ * when the sorted rows are applied to the table.
  *****************************************************************************/
 
-static int compare_wcs(const void *ptr_row_prt_1, const void *ptr_row_ptr_2, void *sort_ptr) {
+static int compare_wcs(const void *ptr_1, const void *ptr_2, void *ctx_ptr) {
+
+	const s_wcs_ctx *ctx = (const s_wcs_ctx*) ctx_ptr;
 
 	//
-	// Get the s_sort stuct for the sort direction and column.
+	// If the sorting is cancelled, qsort should finish as fast as possible.
 	//
-	const s_sort *sort = (const s_sort*) sort_ptr;
+	if (s_progress_is_cancelled(ctx->table->progress)) {
+		return 0;
+	}
 
-	const wchar_t **row_ptr_1 = (*(const wchar_t***) ptr_row_prt_1);
-	const wchar_t **row_ptr_2 = (*(const wchar_t***) ptr_row_ptr_2);
+	const s_comp_wcs *comp_1 = (const s_comp_wcs*) ptr_1;
+	const s_comp_wcs *comp_2 = (const s_comp_wcs*) ptr_2;
 
 	//
-	// Do the actual comparison.
+	// Do the actual comparison. The rows are allocated in one block, so the
+	// pointers have the order of the rows.
 	//
-	const int result = (sort->direction) * wcscmp(row_ptr_1[sort->column], row_ptr_2[sort->column]);
+	const int result = wcs_cmp(comp_1, comp_2, ctx->column);
 
-	log_debug("Direction: %s result: %d '%ls' '%ls'", e_direction_str(sort->direction), result, row_ptr_1[sort->column], row_ptr_2[sort->column]);
+	if (result != 0) {
+		return result;
+	}
 
-	return result;
+	return comp_1->row < comp_2->row ? -1 : 1;
 }
 
 /******************************************************************************
- * The function applies the sorting of the helper array of s_comp_num's to the
- * table.
+ * The struct is used to sort a column by keys, which are computed from the
+ * values. This is the collation key of the locale or the natural key. The
+ * key of each value is computed once and stored in an arena, so the keys can
+ * be compared with wcscmp. The prefix contains the first two chars of the
+ * key, which decide most comparisons.
  *****************************************************************************/
 
-static void apply_num_sorting(s_table *table, const s_comp_num *comp_num) {
+typedef struct s_comp_key {
 
-#ifdef DEBUG
-	const int col = table->sort.column;
-#endif
+	uint64_t prefix;
 
 	//
-	// The s_comp_num array is sorted and contains a pointer to the row of the
-	// column value.
+	// The offset of the key in the arena, which can move while it grows.
 	//
-	for (int row = 0; row < table->no_rows; row++) {
-		table->fields[row] = comp_num[row].row;
+	size_t offset;
+
+	wchar_t **row;
+
+} s_comp_key;
+
+/******************************************************************************
+ * The struct is the context of the callback function for the sorting with the
+ * keys. It contains the table and the arena with the keys.
+ *****************************************************************************/
+
+typedef struct s_key_ctx {
+
+	s_table *table;
+
+	const wchar_t *arena;
+
+} s_key_ctx;
+
+/******************************************************************************
+ * The macro packs the first two chars of a key into an unsigned 64 bit value,
+ * with the same order as the key. The chars of the keys are positive.
+ *****************************************************************************/
+
+#define key_prefix(k) ((k)[0] == W_STR_TERM ? 0 : ((uint64_t) (uint32_t) (k)[0] << 32) | (uint32_t) (k)[1])
+
+/******************************************************************************
+ * The function is a callback function for the sorting with the keys. The
+ * prefixes are compared first and only if they are equal, the
+ * keys are compared. Equal keys are compared by the position of the rows in
+ * the table, so the sorting is stable.
+ *****************************************************************************/
+
+static int compare_key(const void *ptr_1, const void *ptr_2, void *ctx_ptr) {
+
+	const s_key_ctx *ctx = (const s_key_ctx*) ctx_ptr;
+
+	//
+	// If the sorting is cancelled, qsort should finish as fast as possible.
+	//
+	if (s_progress_is_cancelled(ctx->table->progress)) {
+		return 0;
+	}
+
+	const s_comp_key *key_1 = (const s_comp_key*) ptr_1;
+	const s_comp_key *key_2 = (const s_comp_key*) ptr_2;
+
+	if (key_1->prefix != key_2->prefix) {
+		return key_1->prefix < key_2->prefix ? -1 : 1;
+	}
+
+	const int result = wcscmp(ctx->arena + key_1->offset, ctx->arena + key_2->offset);
+
+	if (result != 0) {
+		return result;
+	}
+
+	return key_1->row < key_2->row ? -1 : 1;
+}
+
+/******************************************************************************
+ * The function encodes a double value as an unsigned 64 bit key, with the same
+ * order. For positive values the sign bit is set, for negative values all
+ * bits are inverted. -0.0 is mapped to 0.0, because the two values are equal.
+ *****************************************************************************/
+
+static uint64_t num_key(double value) {
+	uint64_t bits;
+
+	if (value == 0.0) {
+		value = 0.0;
+	}
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return (bits & UINT64_C(0x8000000000000000)) ? ~bits : bits | UINT64_C(0x8000000000000000);
+}
+
+/******************************************************************************
+ * The function sorts the s_comp_num array by its keys with a LSD radix sort.
+ * The histograms of all digits are computed in a single pass. Passes with a
+ * digit, that is equal for all keys, are skipped. The sort is stable and
+ * requires a second buffer of the same size. The function returns the buffer
+ * with the sorted elements, which is one of the two. It returns NULL if the
+ * sorting was cancelled.
+ *****************************************************************************/
+
+static s_comp_num* radix_sort(s_progress *progress, s_comp_num *src, s_comp_num *tmp, const int size) {
 
-#ifdef DEBUG
-		log_debug("Sorted value: %ls", table->fields[row][col]);
-#endif
+	//
+	// The histograms are allocated, because the function runs in a thread.
+	//
+	size_t (*hist)[RADIX_SIZE] = xmalloc(sizeof(size_t[RADIX_PASSES][RADIX_SIZE]));
+
+	memset(hist, 0, sizeof(size_t[RADIX_PASSES][RADIX_SIZE]));
+
+	for (int i = 0; i < size; i++) {
+		for (int pass = 0; pass < RADIX_PASSES; pass++) {
+			hist[pass][radix_digit(src[i].key, pass)]++;
+		}
 	}
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++) {
+
+		if (s_progress_is_cancelled(progress)) {
+			src = NULL;
+			break;
+		}
+
+		//
+		// If all keys have the same digit, the pass changes nothing.
+		//
+		if (hist[pass][radix_digit(src[0].key, pass)] == (size_t) size) {
+			continue;
+		}
+
+		//
+		// Convert the histogram to the start offsets of the buckets.
+		//
+		size_t sum = 0;
+		for (int i = 0; i < RADIX_SIZE; i++) {
+			const size_t count = hist[pass][i];
+			hist[pass][i] = sum;
+			sum += count;
+		}
+
+		for (int i = 0; i < size; i++) {
+			tmp[hist[pass][radix_digit(src[i].key, pass)]++] = src[i];
+		}
+
+		s_comp_num *swap = src;
+		src = tmp;
+		tmp = swap;
+	}
+
+	free(hist);
+
+	return src;
+}
+
+/******************************************************************************
+ * The function stores the rows of the sorted helper array of s_comp_num's in
+ * the permutation. Rows with equal keys get the same rank.
+ *****************************************************************************/
+
+static void perm_from_num(const s_table *table, s_sort_perm *perm, const s_comp_num *comp_num) {
+
+	for (int i = 0; i < perm->size; i++) {
+		perm->rows[i] = s_table_row_idx(table, comp_num[i].row);
+		perm->ranks[i] = i == 0 ? 0 : perm->ranks[i - 1] + (comp_num[i].key != comp_num[i - 1].key);
+	}
+
+	perm->no_ranks = perm->ranks[perm->size - 1] + 1;
+}
+
+/******************************************************************************
+ * The function stores the sorted rows in the permutation. Rows with equal
+ * strings get the same rank.
+ *****************************************************************************/
+
+static void perm_from_wcs(const s_table *table, s_sort_perm *perm, const s_comp_wcs *comp_wcs, const int column) {
+
+	for (int i = 0; i < perm->size; i++) {
+		perm->rows[i] = s_table_row_idx(table, comp_wcs[i].row);
+		perm->ranks[i] = i == 0 ? 0 : perm->ranks[i - 1] + (wcs_cmp(&comp_wcs[i], &comp_wcs[i - 1], column) != 0);
+	}
+
+	perm->no_ranks = perm->ranks[perm->size - 1] + 1;
 }
 
 /******************************************************************************
- * The function tries to convert the column values to double values and stores
- * the result in an array of s_comp_num. If one column value cannot be
- * converted, the function returns immediately with false. If the conversion of
- * the hole column succeeded, the function returns true.
+ * Marker of a number in a natural key. It is lower than the chars of the
+ * text, which are shifted by NAT_TEXT_SHIFT.
+ *****************************************************************************/
+
+#define NAT_NUMBER 1
+
+#define NAT_TEXT_SHIFT 2
+
+/******************************************************************************
+ * The function computes the natural key of a string, which has the order of
+ * the natural sorting with wcscmp. The string is split into runs of text and
+ * numbers. A number is encoded with a marker, the number of digits without
+ * leading zeros (plus one) and the digits, so a shorter number is lower than
+ * a longer number. A number is lower than text at the same position:
  *
- * Empty strings are converted to DBL_MAX.
+ * host2 < host10 and v1.9 < v1.10
  *
- * It is possible that the column values have a non numerical suffix. If so,
- * all suffixes have to be equal. An example is a column with currencies like:
+ * The key has at most three times the length of the string. The function
+ * returns the length of the key.
+ *****************************************************************************/
+
+static size_t nat_key(wchar_t *key, const wchar_t *str) {
+	size_t len = 0;
+	const wchar_t *start;
+
+	while (*str != W_STR_TERM) {
+
+		if (*str < L'0' || *str > L'9') {
+			key[len++] = *str++ + NAT_TEXT_SHIFT;
+			continue;
+		}
+
+		//
+		// Skip the leading zeros and count the digits.
+		//
+		while (*str == L'0') {
+			str++;
+		}
+
+		for (start = str; *str >= L'0' && *str <= L'9'; str++)
+			;
+
+		key[len++] = NAT_NUMBER;
+		key[len++] = (wchar_t) (str - start) + 1;
+
+		while (start < str) {
+			key[len++] = *start++;
+		}
+	}
+
+	key[len] = W_STR_TERM;
+
+	return len;
+}
+
+/******************************************************************************
+ * The function computes the keys of the column values of the rows, with
+ * wcsxfrm for the collation of the locale or the natural keys, and stores
+ * them in an arena, which grows on demand. The function returns the arena or
+ * NULL if the sorting was cancelled.
+ *****************************************************************************/
+
+static wchar_t* sort_keys(s_table *table, wchar_t ***rows, const int size, const int column, const enum e_sort_type type, s_comp_key *keys) {
+	size_t len = 0;
+	size_t cap = (size_t) size * 16 + 1;
+	size_t n;
+
+	wchar_t *arena = xmalloc(sizeof(wchar_t) * cap);
+
+	for (int i = 0; i < size; i++) {
+
+		if (s_progress_step(table->progress, i)) {
+			free(arena);
+			return NULL;
+		}
+
+		//
+		// Ensure that the arena has enough space for the natural key.
+		//
+		if (type == E_SORT_NAT) {
+			n = 3 * wcslen(rows[i][column]) + 1;
+
+			if (n > cap - len) {
+				cap = 2 * cap + n;
+				arena = xrealloc(arena, sizeof(wchar_t) * cap);
+			}
+
+			n = nat_key(arena + len, rows[i][column]);
+		}
+
+		//
+		// If the collation key does not fit into the arena, the arena grows
+		// and the key is computed again.
+		//
+		else if ((n = wcsxfrm(arena + len, rows[i][column], cap - len)) != (size_t) -1 && n >= cap - len) {
+			cap = 2 * cap + n + 1;
+			arena = xrealloc(arena, sizeof(wchar_t) * cap);
+
+			n = wcsxfrm(arena + len, rows[i][column], cap - len);
+		}
+
+		//
+		// A value, that cannot be transformed, gets an empty key.
+		//
+		if (n == (size_t) -1) {
+			arena[len] = W_STR_TERM;
+			n = 0;
+		}
+
+		keys[i].offset = len;
+		keys[i].row = rows[i];
+
+		len += n + 1;
+	}
+
+	for (int i = 0; i < size; i++) {
+		keys[i].prefix = key_prefix(arena + keys[i].offset);
+	}
+
+	log_debug("Keys: %d arena: %zu", size, len);
+
+	return arena;
+}
+
+/******************************************************************************
+ * The function sorts the rows by the keys of the type and stores the sorted
+ * rows in the permutation. Rows with equal keys get the same rank. The
+ * function returns false if the sorting was cancelled.
+ *****************************************************************************/
+
+static bool perm_from_keys(s_table *table, s_sort_perm *perm, wchar_t ***rows, const int column, const enum e_sort_type type) {
+
+	s_comp_key *keys = xmalloc(sizeof(s_comp_key) * perm->size);
+
+	wchar_t *arena = sort_keys(table, rows, perm->size, column, type, keys);
+
+	if (arena == NULL) {
+		free(keys);
+		return false;
+	}
+
+	s_key_ctx ctx = { .table = table, .arena = arena };
+
+	psort_r(keys, perm->size, sizeof(s_comp_key), compare_key, (void*) &ctx, psort_threads());
+
+	const bool result = !s_progress_is_cancelled(table->progress);
+
+	if (result) {
+		for (int i = 0; i < perm->size; i++) {
+			perm->rows[i] = s_table_row_idx(table, keys[i].row);
+			perm->ranks[i] = i == 0 ? 0 : perm->ranks[i - 1] + (wcscmp(arena + keys[i].offset, arena + keys[i - 1].offset) != 0);
+		}
+
+		perm->no_ranks = perm->ranks[perm->size - 1] + 1;
+	}
+
+	free(arena);
+	free(keys);
+
+	return result;
+}
+
+/******************************************************************************
+ * The function tries to get the double values of the column values of the
+ * rows and stores the result in an array of s_comp_num. The values and the
+ * type are taken from the parsed column, so a column is converted and its
+ * type is inferred only once. The values of a numerical column can have a non
+ * numerical suffix, which is the same for all values, like:
  *
  * "1000,00 Euro"
+ *
+ * The type is inferred without the first row. If the first row is not the
+ * header, it has to have the type of the column. If the column has no type,
+ * the rows of the view can be numerical nevertheless, so each row is checked.
+ * If one column value is not a number or has an other suffix, the function
+ * returns false.
+ *
+ * Empty strings are converted to DBL_MAX.
  *****************************************************************************/
 
-static bool try_convert_num(s_table *table, s_comp_num *num_comp) {
+static bool try_convert_num(s_table *table, wchar_t ***rows, const int col, s_comp_num *num_comp) {
+	int idx;
 
 	//
-	// Two pointer to suffixes. The first suffix found is stored in:
-	// init_tailptr. All other are stored in: tailptr and are compared
-	// with the init_tailptr.
+	// Get the parsed column, which can be cancelled.
 	//
-	wchar_t *init_tailptr = NULL;
-	wchar_t *tailptr;
+	const s_num_column *num_column = s_table_num_column(table, col);
+
+	if (num_column == NULL) {
+		return false;
+	}
+
+	const bool is_typed = num_column->type != E_NUM_TYPE_STR && (table->show_header || num_column->first_has_type);
+
+	log_debug("Column: %d type: %d typed: %d", col, num_column->type, is_typed);
 
 	//
-	// The column that should be sorted.
+	// The first suffix found is stored in: init_tailptr. All other are
+	// compared with the init_tailptr, if the column has no type.
 	//
-	const int col = table->sort.column;
+	const wchar_t *init_tailptr = NULL;
 
 	//
-	// Iterate through the rows to convert the column values.
+	// Iterate through the rows to get the column values.
 	//
 	for (int row = 0; row < table->no_rows; row++) {
 
+		//
+		// If the sorting is cancelled, stop the conversion.
+		//
+		if (s_progress_step(table->progress, row)) {
+			return false;
+		}
+
+		idx = s_table_row_idx(table, rows[row]);
+
 		//
 		// Ignore the header if necessary.
 		//
 		if (row == 0 && table->show_header) {
-			num_comp[row].value = 0;
-			log_debug_str("String is header, set value to: 0");
-
+			num_comp[row].key = 0;
 		}
 
 		//
 		// Check if the column value is empty.
 		//
-		//
-		else if (wcs_is_empty(table->fields[row][col])) {
-			num_comp[row].value = DBL_MAX;
-			log_debug_str("String is empty, set value to: DBL_MAX");
+		else if (s_num_bit(num_column->empty, idx)) {
+			num_comp[row].key = num_key(DBL_MAX);
 
-		} else {
+		}
 
-			//
-			// Set errno to 0 to be able to detect errors and to the conversion.
-			//
-			errno = 0;
-			num_comp[row].value = wcstod(table->fields[row][col], &tailptr);
-
-			//
-			// Check for errors (for example overflows)
-			//
-			if (errno != 0) {
-				log_debug("Unable to convert: '%ls' - %s", table->fields[row][col], strerror(errno));
-				return false;
-			}
+		//
+		// Check if the column value is a number with the same suffix, which
+		// is given if the column has a type.
+		//
+		else if (!is_typed && !s_num_bit(num_column->valid, idx)) {
+			log_debug("Unable to convert: %ls", rows[row][col]);
+			return false;
 
-			//
-			// If the tail pointer is equal to the column value, no conversion
-			// was possible. (the column value is not a number)
-			//
-			if (table->fields[row][col] == tailptr) {
-				log_debug("Unable to convert: %ls", table->fields[row][col]);
-				return false;
-			}
+		} else if (!is_typed && init_tailptr != NULL && wcscmp(init_tailptr, num_column->suffixes[idx]) != 0) {
+			log_debug("String: '%ls' does not end with: '%ls'", rows[row][col], init_tailptr);
+			return false;
 
-			log_debug("'%ls' %f '%ls'", table->fields[row][col], num_comp[row].value, tailptr);
+		} else {
+			num_comp[row].key = num_key(num_column->values[idx]);
 
-			//
-			// Save the first suffix.
-			//
 			if (init_tailptr == NULL) {
-				init_tailptr = tailptr;
-				log_debug("Save suffix: '%ls'", init_tailptr);
-
-			}
-
-			//
-			// If a suffix exists, we have to ensure, that the new is the same.
-			//
-			else if (wcscmp(init_tailptr, tailptr) != 0) {
-				log_debug("String: '%ls' does not end with: '%ls'", table->fields[row][col], init_tailptr);
-				return false;
+				init_tailptr = num_column->suffixes[idx];
 			}
 		}
 
@@ -241,7 +633,7 @@ static bool try_convert_num(s_table *table, s_comp_num *num_comp) {
 		// Store a pointer to the row. This is used when the sorted array is
 		// applied to the table.
 		//
-		num_comp[row].row = table->fields[row];
+		num_comp[row].row = rows[row];
 	}
 
 	log_debug_str("Succeeded!");
@@ -250,40 +642,66 @@ static bool try_convert_num(s_table *table, s_comp_num *num_comp) {
 }
 
 /******************************************************************************
- * The function does the sorting of the table by a given column and direction.
- * First it is tried to do the sorting by numerical values. For this, the
- * column entries are converted to double values. If the conversion of the
- * column succeeded, the sorting is done numerically. If not the sorting is
- * done by (wchar_t) strings.
+ * The function creates the permutation of the rows of the view for a column.
+ * The rows are given in the order of the table. If the type of the key
+ * allows it, it is tried to do the sorting by numerical values first. For
+ * this, the column entries are converted to double values. If the conversion
+ * of the column succeeded, the sorting is done numerically. If not the sorting
+ * is done by (wchar_t) strings, by the collation of the locale or by the
+ * natural order. The rows are sorted in forward direction. The function
+ * returns false if the sorting was cancelled.
  *****************************************************************************/
 
-void s_table_do_sort(s_table *table) {
+static bool create_perm(s_table *table, s_sort_perm *perm, const s_sort_key *key, wchar_t ***rows, const int offset) {
+	bool result = true;
 
-	//
-	// If the table has a header, the first row is excluded from the sorting.
-	//
-	const int offset = table->show_header ? 1 : 0;
+	perm->view = -1;
+	perm->type = key->type;
+	perm->size = table->no_rows - offset;
+	perm->rows = xrealloc(perm->rows, sizeof(int) * perm->size);
+	perm->ranks = xrealloc(perm->ranks, sizeof(int) * perm->size);
 
 	//
-	// Create a helper array for the numerical sorting.
+	// Create the helper array for the numerical sorting. It is allocated on
+	// the heap, because the table can have millions of rows.
 	//
-	s_comp_num comp_num_array[table->no_rows];
+	s_comp_num *comp_num_array = xmalloc(sizeof(s_comp_num) * table->no_rows);
+
+	s_progress_phase(table->progress, E_PHASE_SORT, table->no_rows);
 
 	//
 	// Try a numerical sorting first.
 	//
-	if (try_convert_num(table, comp_num_array)) {
+	if (key->type == E_SORT_AUTO && try_convert_num(table, rows, key->column, comp_num_array)) {
 		log_debug_str("Sort by numerical values.");
 
 		//
-		// Do the numerical sorting.
+		// Do the numerical sorting. The header row is not part of it.
 		//
-		qsort_r(&comp_num_array[offset], table->no_rows - offset, sizeof(s_comp_num), compare_num, (void*) &table->sort);
+		s_comp_num *tmp_array = xmalloc(sizeof(s_comp_num) * perm->size);
 
-		//
-		// Apply the sorting to the table.
-		//
-		apply_num_sorting(table, comp_num_array);
+		s_comp_num *sorted = radix_sort(table->progress, &comp_num_array[offset], tmp_array, perm->size);
+
+		if (sorted != NULL) {
+			perm_from_num(table, perm, sorted);
+		} else {
+			result = false;
+		}
+
+		free(tmp_array);
+	}
+
+	else if (s_progress_is_cancelled(table->progress)) {
+		result = false;
+	}
+
+	//
+	// Sort with the collation of the locale or the natural order.
+	//
+	else if (key->type == E_SORT_COLL || key->type == E_SORT_NAT) {
+		log_debug("Sort by keys of type: %d", key->type);
+
+		result = perm_from_keys(table, perm, &rows[offset], key->column, key->type);
 	}
 
 	//
@@ -292,6 +710,198 @@ void s_table_do_sort(s_table *table) {
 	else {
 		log_debug_str("Sort by string values.");
 
-		qsort_r(&table->fields[offset], table->no_rows - offset, sizeof(wchar_t**), compare_wcs, (void*) &table->sort);
+		//
+		// Create the array with the prefixes of the strings.
+		//
+		s_comp_wcs *comp_wcs_array = xmalloc(sizeof(s_comp_wcs) * perm->size);
+
+		for (int i = 0; i < perm->size; i++) {
+			wcs_prefix(&comp_wcs_array[i], rows[offset + i][key->column]);
+			comp_wcs_array[i].row = rows[offset + i];
+		}
+
+		s_wcs_ctx ctx = { .table = table, .column = key->column };
+
+		//
+		// Large views are sorted with several threads. The comparison is a
+		// total order, so the result is the same as with one thread.
+		//
+		psort_r(comp_wcs_array, perm->size, sizeof(s_comp_wcs), compare_wcs, (void*) &ctx, psort_threads());
+
+		result = !s_progress_is_cancelled(table->progress);
+
+		if (result) {
+			perm_from_wcs(table, perm, comp_wcs_array, key->column);
+		}
+
+		free(comp_wcs_array);
+	}
+
+	free(comp_num_array);
+
+	//
+	// The permutation is valid for the current view, if the sorting was not
+	// cancelled.
+	//
+	if (result) {
+		perm->view = table->view;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+ * The function returns the rows of the view in the order of the table. If the
+ * view is sorted, the rows are collected with a bitmap of the view.
+ *****************************************************************************/
+
+static wchar_t*** view_rows(const s_table *table) {
+
+	wchar_t ***rows = xmalloc(sizeof(wchar_t**) * table->no_rows);
+
+	bool in_order = true;
+
+	for (int row = 1; row < table->no_rows && in_order; row++) {
+		in_order = table->fields[row - 1] < table->fields[row];
+	}
+
+	if (in_order) {
+		memcpy(rows, table->fields, sizeof(wchar_t**) * table->no_rows);
+		return rows;
+	}
+
+	const size_t size = sizeof(uint64_t) * s_bits_words(table->__no_rows);
+
+	uint64_t *bits = xmalloc(size);
+	memset(bits, 0, size);
+
+	for (int row = 0; row < table->no_rows; row++) {
+		s_bits_set(bits, s_table_row_idx(table, table->fields[row]));
+	}
+
+	int no_rows = 0;
+
+	for (int row = 0; row < table->__no_rows; row++) {
+		if (s_bits_get(bits, row)) {
+			rows[no_rows++] = table->__fields[row];
+		}
+	}
+
+	free(bits);
+
+	return rows;
+}
+
+/******************************************************************************
+ * The function sorts the rows (row indices) by the ranks of the rows with a
+ * counting sort, which is stable. The sorted rows are written to the second
+ * array.
+ *****************************************************************************/
+
+static void counting_sort(const int *rows, int *sorted, const int size, const int *rank_of, const int no_ranks) {
+
+	int *count = xmalloc(sizeof(int) * (no_ranks + 1));
+	memset(count, 0, sizeof(int) * (no_ranks + 1));
+
+	for (int i = 0; i < size; i++) {
+		count[rank_of[rows[i]] + 1]++;
+	}
+
+	for (int i = 1; i <= no_ranks; i++) {
+		count[i] += count[i - 1];
+	}
+
+	for (int i = 0; i < size; i++) {
+		sorted[count[rank_of[rows[i]]]++] = rows[i];
 	}
+
+	free(count);
+}
+
+/******************************************************************************
+ * The function does the sorting of the table by the keys of the sorting. Each
+ * key has a permutation of the rows of the view, which is cached and reused,
+ * until the set of rows of the view changes. From a permutation the ranks of
+ * the rows are computed, with the direction of the key. The rows are sorted
+ * by the ranks of the keys, starting with the key with the lowest priority.
+ * The sorting of each key is stable, so the sorting of the keys with lower
+ * priority is kept for equal values. Rows that are equal for all keys keep
+ * the order of the table. The header row stays in place.
+ *****************************************************************************/
+
+void s_table_do_sort(s_table *table) {
+
+	//
+	// If the table has a header, the first row is excluded from the sorting.
+	//
+	const int offset = table->show_header ? 1 : 0;
+
+	const int size = table->no_rows - offset;
+
+	//
+	// Nothing to sort, if there are less than two rows.
+	//
+	if (size < 2) {
+		return;
+	}
+
+	wchar_t ***rows = view_rows(table);
+
+	int *cur = xmalloc(sizeof(int) * size);
+	int *next = xmalloc(sizeof(int) * size);
+	int *rank_of = xmalloc(sizeof(int) * table->__no_rows);
+	int *tmp;
+
+	for (int i = 0; i < size; i++) {
+		cur[i] = s_table_row_idx(table, rows[offset + i]);
+	}
+
+	bool result = true;
+
+	for (int k = table->sort.no_keys - 1; k >= 0 && result; k--) {
+		const s_sort_key *key = &table->sort.keys[k];
+		s_sort_perm *perm = &table->sort_cache->perms[key->column];
+
+		if (perm->view != table->view || perm->size != size || perm->type != key->type) {
+			result = create_perm(table, perm, key, rows, offset);
+
+			if (!result) {
+				break;
+			}
+
+		} else {
+			log_debug("Reuse sorting of column: %d view: %d", key->column, table->view);
+		}
+
+		//
+		// Compute the ranks of the rows with the direction of the key.
+		//
+		for (int i = 0; i < size; i++) {
+			rank_of[perm->rows[i]] = key->direction == E_DIR_FORWARD ? perm->ranks[i] : perm->no_ranks - 1 - perm->ranks[i];
+		}
+
+		counting_sort(cur, next, size, rank_of, perm->no_ranks);
+
+		tmp = cur;
+		cur = next;
+		next = tmp;
+
+		result = !s_progress_is_cancelled(table->progress);
+	}
+
+	//
+	// Apply the sorted rows and the row heights to the view, if the sorting
+	// was not cancelled.
+	//
+	if (result) {
+		for (int i = 0; i < size; i++) {
+			table->fields[offset + i] = table->__fields[cur[i]];
+			table->height[offset + i] = table->__height[cur[i]];
+		}
+	}
+
+	free(rows);
+	free(cur);
+	free(next);
+	free(rank_of);
 }
@@ -29,6 +29,7 @@
 #include "ncv_win_help.h"
 
 #include "ncv_filter.h"
+#include "ncv_job.h"
 #include "ncv_table_part.h"
 #include "ncv_ncurses.h"
 #include "ncv_common.h"
@@ -248,6 +249,169 @@ static bool change_mode(WINDOW **win, s_cursor *cursor, enum MODE *mode_current,
 	return true;
 }
 
+/******************************************************************************
+ * The number of milliseconds to wait for a background update, before the
+ * progress is printed and the user input is checked.
+ *****************************************************************************/
+
+#define JOB_WAIT_MS 50
+
+/******************************************************************************
+ * The number of milliseconds without user input in the filter popup, before a
+ * live filter is applied. So fast typing does not start a filtering for each
+ * char.
+ *****************************************************************************/
+
+#define LIVE_DEBOUNCE_MS 150
+
+/******************************************************************************
+ * The number of matches of a search, after which the indexing stops, so the
+ * first match is shown immediately. The remaining matches are counted by a
+ * background job, while the user can browse the table.
+ *****************************************************************************/
+
+#define SEARCH_MATCH_LIMIT 1
+
+static s_job count_job;
+
+/******************************************************************************
+ * The function starts the background count of the matches, if the indexing
+ * of the last update stopped early.
+ *****************************************************************************/
+
+static void count_start(s_table *table, const s_cursor *cursor) {
+
+	if (table->is_counting) {
+		s_job_start_count(&count_job, table, cursor);
+		win_footer_set_counting(&count_job.progress);
+	}
+}
+
+/******************************************************************************
+ * The function finishes the background count of the matches, if it is
+ * running. If the count is cancelled, the table keeps the first matches and
+ * the count has to be restarted.
+ *****************************************************************************/
+
+static void count_finish(s_table *table, s_cursor *cursor, const bool do_cancel) {
+
+	if (table->is_counting) {
+
+		if (do_cancel) {
+			s_job_cancel(&count_job);
+		}
+
+		s_job_finish(&count_job, table, cursor);
+		win_footer_set_counting(NULL);
+	}
+}
+
+/******************************************************************************
+ * The function waits for a started job, which updates the table in a
+ * background thread, so the ui stays responsive. While the thread is running,
+ * the progress is shown in the footer and the user input is checked without
+ * blocking. ESC cancels the job and resizing is processed. All other input is
+ * ignored. After the thread finished, the result is published to the table at
+ * once.
+ *
+ * A live update is started while the user is typing the filter. In this case
+ * each input cancels the update and is pushed back, so it is processed by the
+ * ui loop, which starts a new update later.
+ *****************************************************************************/
+
+static void run_job(WINDOW *win, s_table *table, s_cursor *cursor, const char *filename, const enum MODE mode, s_job *job, const bool is_live) {
+	wint_t chr;
+	int key_type;
+
+	//
+	// Read the user input without blocking, while the job is running.
+	//
+	wtimeout(win, 0);
+
+	while (!s_job_wait(job, JOB_WAIT_MS)) {
+
+		key_type = wget_wch(win, &chr);
+
+		if (key_type == KEY_CODE_YES && chr == KEY_RESIZE) {
+			wins_resize(table, cursor);
+			wins_print(table, cursor, filename, mode, true);
+
+		} else if (is_live && key_type != ERR) {
+
+			//
+			// The update is outdated, so the input is pushed back.
+			//
+			s_job_cancel(job);
+
+			if ((key_type == OK ? unget_wch(chr) : ungetch(chr)) == ERR) {
+				log_exit_str("Unable to push back the input!");
+			}
+
+		} else if (key_type == OK && chr == NCV_KEY_ESC) {
+			s_job_cancel(job);
+		}
+
+		//
+		// Print the footer with the progress.
+		//
+		win_footer_set_progress(&job->progress);
+		win_footer_content_print(table, cursor, filename);
+		wins_refresh(mode);
+	}
+
+	wtimeout(win, -1);
+
+	wchar_t *msg = s_job_finish(job, table, cursor);
+
+	//
+	// A cancelled live update is not worth a message.
+	//
+	if (!is_live || !atomic_load(&job->progress.cancelled)) {
+		win_footer_set_msg(msg);
+	}
+
+	//
+	// After filtering and sorting the table changed.
+	//
+	win_table_on_table_change(table, cursor);
+
+	count_start(table, cursor);
+}
+
+/******************************************************************************
+ * The function applies a filter and a sorting to the table with a background
+ * job.
+ *****************************************************************************/
+
+static void update_filter_sort(WINDOW *win, s_table *table, s_cursor *cursor, const char *filename, const enum MODE mode, const s_filter *filter, const s_sort *sort, const bool filter_changed, const bool sort_changed, const bool is_live) {
+	s_job job;
+
+	//
+	// A running count is outdated or restarted after the update.
+	//
+	count_finish(table, cursor, true);
+
+	s_job_start(&job, table, cursor, filter, sort, filter_changed, sort_changed);
+
+	run_job(win, table, cursor, filename, mode, &job, is_live);
+}
+
+/******************************************************************************
+ * The function combines the view of the filter with the rows of the previous
+ * filter with a background job. The combination of large tables with an
+ * active sorting takes a while, so it can be cancelled with ESC.
+ *****************************************************************************/
+
+static void combine_filter(WINDOW *win, s_table *table, s_cursor *cursor, const char *filename, const enum MODE mode, const enum e_combine combine) {
+	s_job job;
+
+	count_finish(table, cursor, true);
+
+	s_job_start_combine(&job, table, cursor, combine);
+
+	run_job(win, table, cursor, filename, mode, &job, false);
+}
+
 /******************************************************************************
  * The function processes user input. It processes input that is independent of
  * the mode (TABLE / FILTER) like quit and resize and the change of the mode.
@@ -274,12 +438,30 @@ void ui_loop(s_table *table, const char *filename) {
 	//
 	bool do_continue = true;
 
+	//
+	// Copies of the filter and the sorting, which are applied to the table.
+	//
+	s_filter filter;
+	s_sort sort;
+
+	//
+	// A flag that indicates that the filter popup is in live mode and the
+	// input changed, so the filter has to be applied, after the user stopped
+	// typing.
+	//
+	bool live_pending = false;
+
 	//
 	// Define and initialize the field cursor
 	//
 	s_cursor cursor;
 	s_cursor_set(&cursor, 0, 0, true);
 
+	//
+	// A search shows the first match, while the matches are counted.
+	//
+	table->match_limit = SEARCH_MATCH_LIMIT;
+
 	//
 	// Initializing the table.
 	//
@@ -300,6 +482,13 @@ void ui_loop(s_table *table, const char *filename) {
 		//
 		move(0, 0);
 
+		//
+		// If a live filter is pending, the input is read with a timeout.
+		//
+		const bool do_debounce = live_pending && mode == MODE_FILTER;
+
+		wtimeout(win, do_debounce ? LIVE_DEBOUNCE_MS : (table->is_counting ? JOB_WAIT_MS : -1));
+
 		//
 		// Read the user input
 		//
@@ -345,8 +534,11 @@ void ui_loop(s_table *table, const char *filename) {
 				//
 				// Deactivate filtering and sorting.
 				//
-				const bool is_filter_reset = s_filter_set_inactive(&table->filter);
-				const bool is_sort_reset = s_sort_set_inactive(&table->sort, false);
+				filter = table->filter;
+				sort = table->sort;
+
+				const bool is_filter_reset = s_filter_set_inactive(&filter);
+				const bool is_sort_reset = s_sort_set_inactive(&sort, false);
 
 				if (is_filter_reset || is_sort_reset) {
 
@@ -354,9 +546,7 @@ void ui_loop(s_table *table, const char *filename) {
 					// If one of the values changed, do a reset and print the
 					// result.
 					//
-					s_table_update_filter_sort(table, &cursor, is_filter_reset, is_sort_reset);
-
-					win_table_on_table_change(table, &cursor);
+					update_filter_sort(win, table, &cursor, filename, mode, &filter, &sort, is_filter_reset, is_sort_reset, false);
 				}
 
 				//
@@ -381,6 +571,15 @@ void ui_loop(s_table *table, const char *filename) {
 				//
 			case L'/':
 			case CTRL('f'):
+
+				//
+				// In the filter dialog a slash is part of the input, for
+				// example the path of a pattern file.
+				//
+				if (chr == L'/' && mode == MODE_FILTER) {
+					break;
+				}
+
 				log_debug_str("Found <ctrl>-f");
 
 				//
@@ -396,15 +595,39 @@ void ui_loop(s_table *table, const char *filename) {
 
 				continue;
 
+				//
+				// Combine the view of the filter with the previous filter or
+				// invert the view.
+				//
+			case L'&':
+			case L'|':
+			case L'!':
+
+				//
+				// In the filter dialog the chars are part of the input.
+				//
+				if (mode != MODE_TABLE) {
+					break;
+				}
+
+				log_debug("Found combine char: %lc", chr);
+
+				combine_filter(win, table, &cursor, filename, mode, chr == L'&' ? E_COMBINE_AND : chr == L'|' ? E_COMBINE_OR : E_COMBINE_NOT);
+
+				wins_print(table, &cursor, filename, mode, true);
+
+				continue;
+
 				//
 				// Sort forward (sorting always changes the table)
 				//
 			case CTRL('s'):
 				log_debug_str("Found <ctrl>-s");
 
-				s_sort_update(&table->sort, cursor.col, E_DIR_FORWARD);
+				sort = table->sort;
+				s_sort_update(&sort, cursor.col, E_DIR_FORWARD);
 
-				s_table_update_filter_sort(table, &cursor, false, true);
+				update_filter_sort(win, table, &cursor, filename, mode, &table->filter, &sort, false, true, false);
 
 				wins_print(table, &cursor, filename, mode, true);
 
@@ -416,9 +639,66 @@ void ui_loop(s_table *table, const char *filename) {
 			case CTRL('r'):
 				log_debug_str("Found <ctrl>-r");
 
-				s_sort_update(&table->sort, cursor.col, E_DIR_BACKWARD);
+				sort = table->sort;
+				s_sort_update(&sort, cursor.col, E_DIR_BACKWARD);
+
+				update_filter_sort(win, table, &cursor, filename, mode, &table->filter, &sort, false, true, false);
+
+				wins_print(table, &cursor, filename, mode, true);
+
+				continue;
 
-				s_table_update_filter_sort(table, &cursor, false, true);
+				//
+				// Add the current column as the next sort key forward /
+				// backward.
+				//
+			case L'>':
+			case L'<':
+
+				//
+				// In the filter dialog the chars are part of the input.
+				//
+				if (mode != MODE_TABLE) {
+					break;
+				}
+
+				log_debug("Found sort key char: %lc", chr);
+
+				sort = table->sort;
+
+				if (!s_sort_add_key(&sort, cursor.col, chr == L'>' ? E_DIR_FORWARD : E_DIR_BACKWARD)) {
+					win_footer_set_msg(L"Too many sort keys!");
+
+				} else {
+					update_filter_sort(win, table, &cursor, filename, mode, &table->filter, &sort, false, true, false);
+				}
+
+				wins_print(table, &cursor, filename, mode, true);
+
+				continue;
+
+				//
+				// Toggle the type of the sort key of the current column
+				// (automatic / string / locale / natural).
+				//
+			case CTRL('t'):
+				log_debug_str("Found <ctrl>-t");
+
+				sort = table->sort;
+
+				if (!s_sort_toggle_type(&sort, cursor.col)) {
+					win_footer_set_msg(L"Column is not sorted!");
+
+				} else {
+					update_filter_sort(win, table, &cursor, filename, mode, &table->filter, &sort, false, true, false);
+
+					const int idx = s_sort_key_idx(&table->sort, cursor.col);
+
+					if (idx >= 0) {
+						const enum e_sort_type type = table->sort.keys[idx].type;
+						win_footer_set_msg(type == E_SORT_AUTO ? L"Sort: numeric / text" : type == E_SORT_STR ? L"Sort: text" : type == E_SORT_COLL ? L"Sort: locale" : L"Sort: natural");
+					}
+				}
 
 				wins_print(table, &cursor, filename, mode, true);
 
@@ -462,6 +742,57 @@ void ui_loop(s_table *table, const char *filename) {
 
 		case ERR:
 
+			//
+			// The user stopped typing, so the live filter is applied.
+			//
+			if (do_debounce) {
+				live_pending = false;
+
+				filter = table->filter;
+
+				if (win_filter_peek_filter(&filter) && s_filter_has_changed(&filter)) {
+					update_filter_sort(win, table, &cursor, filename, mode, &filter, &table->sort, true, false, true);
+				}
+
+				//
+				// Show the number of matches, if there is a filter string.
+				//
+				if (s_filter_is_active(&table->filter)) {
+					win_filter_set_count(table->filter.count, table->is_counting);
+
+				} else {
+					win_filter_set_count(s_filter_len(&filter) > 0 ? 0 : -1, false);
+				}
+
+				wins_print(table, &cursor, filename, mode, true);
+
+				continue;
+			}
+
+			//
+			// While the matches are counted, the footer is updated until the
+			// count is finished.
+			//
+			if (table->is_counting) {
+
+				if (s_job_wait(&count_job, 0)) {
+					count_finish(table, &cursor, false);
+
+					//
+					// The live filter dialog shows the final number of
+					// matches.
+					//
+					if (mode == MODE_FILTER && win_filter_is_live() && s_filter_is_active(&table->filter)) {
+						win_filter_set_count(table->filter.count, false);
+					}
+				}
+
+				win_footer_content_print(table, &cursor, filename);
+				wins_refresh(mode);
+
+				continue;
+			}
+
 			//
 			// An error from wget_wch
 			//
@@ -475,6 +806,19 @@ void ui_loop(s_table *table, const char *filename) {
 		//
 		if (mode == MODE_TABLE) {
 
+			//
+			// Searching the next / previous match requires all matches.
+			//
+			if (table->is_counting && key_type == OK && (chr == CTRL('n') || chr == CTRL('p'))) {
+
+				while (!s_job_wait(&count_job, JOB_WAIT_MS)) {
+					win_footer_content_print(table, &cursor, filename);
+					wins_refresh(mode);
+				}
+
+				count_finish(table, &cursor, false);
+			}
+
 			//
 			// The method processes a single input char pair. It returns true
 			// if the table view changed and a redrawing is necessary.
@@ -493,29 +837,31 @@ void ui_loop(s_table *table, const char *filename) {
 			//
 			// The method returns true if the filter mode finished.
 			//
-			if (win_filter_process_input(&table->filter, key_type, chr)) {
+			//
+			// The popup updates a copy of the filter, so the table is
+			// unchanged until the update is finished.
+			//
+			filter = table->filter;
+
+			if (win_filter_process_input(&filter, key_type, chr)) {
 
 				//
 				// Check if a new filtering is necessary.
 				//
-				if (s_filter_has_changed(&table->filter)) {
+				if (s_filter_has_changed(&filter)) {
 
 					log_debug_str("Filter changed, update table!");
 
 					//
 					// Do the filtering of the table.
 					//
-					win_footer_set_msg(s_table_update_filter_sort(table, &cursor, true, false));
-
-					//
-					// After filtering the table changed.
-					//
-					win_table_on_table_change(table, &cursor);
+					update_filter_sort(win, table, &cursor, filename, mode, &filter, &table->sort, true, false, false);
 				}
 
 				//
 				// Change mode from FILTER to TABLE.
 				//
+				live_pending = false;
 				change_mode(&win, &cursor, &mode, MODE_TABLE);
 
 				//
@@ -523,6 +869,14 @@ void ui_loop(s_table *table, const char *filename) {
 				// cursor. the table content may be filtered.
 				//
 				wins_print(table, &cursor, filename, mode, true);
+
+			} else if (win_filter_is_live()) {
+
+				//
+				// The input may have changed the filter, which is applied if
+				// the user stops typing.
+				//
+				live_pending = true;
 			}
 
 		} else if (mode == MODE_HELP) {
@@ -546,5 +900,10 @@ void ui_loop(s_table *table, const char *filename) {
 		}
 	}
 
+	//
+	// The count job uses the table, which is freed after the loop.
+	//
+	count_finish(table, &cursor, true);
+
 	log_debug_str("End");
 }
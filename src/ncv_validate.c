@@ -0,0 +1,339 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_validate.h"
+#include "ncv_common.h"
+
+#include <string.h>
+#include <errno.h>
+
+/******************************************************************************
+ * The states of the validation of a field.
+ *****************************************************************************/
+
+enum e_validate_state {
+
+	//
+	// Before the first char of a field.
+	//
+	E_VALIDATE_START,
+
+	E_VALIDATE_UNESCAPED,
+
+	E_VALIDATE_ESCAPED,
+
+	//
+	// A quote was found in an escaped field, which is the end of the field
+	// or the first of two quotes.
+	//
+	E_VALIDATE_QUOTE
+};
+
+/******************************************************************************
+ * The struct contains the state of the validation. The file is read with a
+ * buffer of a fixed size and decoded char by char, so the memory does not
+ * depend on the size of the file and the byte offset of each char is known.
+ *****************************************************************************/
+
+typedef struct s_validate {
+
+	FILE *file;
+
+	FILE *out;
+
+	const char *name;
+
+	unsigned char buf[VALIDATE_BUF_SIZE];
+
+	size_t buf_len;
+
+	size_t buf_idx;
+
+	//
+	// The byte offset of the next byte in the buffer.
+	//
+	long offset;
+
+	mbstate_t state;
+
+	//
+	// A char that was read ahead to detect a windows line ending.
+	//
+	bool has_next;
+
+	wchar_t next;
+
+	long next_offset;
+
+	s_validate_result *result;
+
+} s_validate;
+
+/******************************************************************************
+ * The function fills the buffer. It returns false at the end of the file.
+ *****************************************************************************/
+
+static bool validate_fill(s_validate *validate) {
+
+	validate->buf_len = fread(validate->buf, 1, VALIDATE_BUF_SIZE, validate->file);
+	validate->buf_idx = 0;
+
+	if (validate->buf_len == 0 && ferror(validate->file)) {
+		log_exit("I/O error: %s", strerror(errno));
+	}
+
+	return validate->buf_len > 0;
+}
+
+/******************************************************************************
+ * The function decodes the next char of the file and its byte offset. An
+ * invalid byte sequence is reported and skipped. The function returns false
+ * at the end of the file.
+ *****************************************************************************/
+
+static bool validate_decode(s_validate *validate, wchar_t *wchr, long *offset) {
+	size_t len;
+
+	*offset = validate->offset;
+
+	while (true) {
+
+		if (validate->buf_idx == validate->buf_len && !validate_fill(validate)) {
+
+			//
+			// A multibyte char that is not complete at the end of the file.
+			//
+			if (!mbsinit(&validate->state)) {
+				fprintf(validate->out, "%s: offset %ld: incomplete character at the end of the file\n", validate->name, *offset);
+				validate->result->encoding_errors++;
+				memset(&validate->state, 0, sizeof(mbstate_t));
+			}
+
+			return false;
+		}
+
+		len = mbrtowc(wchr, (const char*) validate->buf + validate->buf_idx, validate->buf_len - validate->buf_idx, &validate->state);
+
+		//
+		// The buffer ends within a multibyte char, which is stored in the
+		// state, so the rest is read with the next buffer.
+		//
+		if (len == (size_t) -2) {
+			validate->offset += validate->buf_len - validate->buf_idx;
+			validate->buf_idx = validate->buf_len;
+			continue;
+		}
+
+		if (len == (size_t) -1) {
+			fprintf(validate->out, "%s: offset %ld: character encoding error\n", validate->name, validate->offset);
+			validate->result->encoding_errors++;
+
+			memset(&validate->state, 0, sizeof(mbstate_t));
+
+			validate->buf_idx++;
+			validate->offset++;
+			*offset = validate->offset;
+			continue;
+		}
+
+		//
+		// The \0 char has a length of 0, but consumes a byte.
+		//
+		if (len == 0) {
+			len = 1;
+		}
+
+		validate->buf_idx += len;
+		validate->offset += len;
+
+		return true;
+	}
+}
+
+/******************************************************************************
+ * The function returns the next char of the file. The line endings \r\n and
+ * \r are returned as \n, like read_wchar() does.
+ *****************************************************************************/
+
+static bool validate_next(s_validate *validate, wchar_t *wchr, long *offset) {
+
+	if (validate->has_next) {
+		validate->has_next = false;
+		*wchr = validate->next;
+		*offset = validate->next_offset;
+		return true;
+	}
+
+	if (!validate_decode(validate, wchr, offset)) {
+		return false;
+	}
+
+	if (*wchr == W_CR) {
+		*wchr = W_NEW_LINE;
+
+		if (validate_decode(validate, &validate->next, &validate->next_offset) && validate->next != W_NEW_LINE) {
+			validate->has_next = true;
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * The function is called at the end of a row. The number of columns of the
+ * first row is the expected number of all rows.
+ *****************************************************************************/
+
+static void validate_row_end(s_validate *validate, const long row_offset, const int no_columns, int *expected) {
+
+	validate->result->no_rows++;
+
+	if (*expected < 0) {
+		*expected = no_columns;
+
+	} else if (no_columns != *expected) {
+		fprintf(validate->out, "%s: offset %ld: row %ld has %d columns, expected %d\n", validate->name, row_offset, validate->result->no_rows, no_columns, *expected);
+		validate->result->column_errors++;
+	}
+}
+
+/******************************************************************************
+ * The function validates a csv file, which is read as a stream. Each error is
+ * reported with its byte offset to the out stream and the validation goes on.
+ * The errors are: rows with a different number of columns than the first
+ * row, escaped fields without a closing quote, chars after the closing quote
+ * of a field and invalid byte sequences of the encoding of the locale. The
+ * memory does not depend on the size of the file.
+ *****************************************************************************/
+
+void validate_file(FILE *file, const s_cfg_parser *cfg_parser, FILE *out, s_validate_result *result) {
+	wchar_t wchr;
+	long offset;
+
+	s_validate *validate = xmalloc(sizeof(s_validate));
+
+	validate->file = file;
+	validate->out = out;
+	validate->name = cfg_parser->filename != NULL ? cfg_parser->filename : "<STDIN>";
+	validate->buf_len = 0;
+	validate->buf_idx = 0;
+	validate->offset = 0;
+	validate->has_next = false;
+	validate->result = result;
+
+	memset(&validate->state, 0, sizeof(mbstate_t));
+	memset(result, 0, sizeof(s_validate_result));
+
+	enum e_validate_state state = E_VALIDATE_START;
+
+	int column = 0;
+	int expected = -1;
+
+	long row_offset = 0;
+	long quote_offset = 0;
+
+	while (validate_next(validate, &wchr, &offset)) {
+
+		if (state == E_VALIDATE_START && column == 0) {
+			row_offset = offset;
+		}
+
+		switch (state) {
+
+		case E_VALIDATE_START:
+
+			if (wchr == W_QUOTE) {
+				quote_offset = offset;
+				state = E_VALIDATE_ESCAPED;
+				break;
+			}
+
+			state = E_VALIDATE_UNESCAPED;
+
+			// fall through
+
+		case E_VALIDATE_UNESCAPED:
+
+			if (wchr == cfg_parser->delim) {
+				column++;
+				state = E_VALIDATE_START;
+
+			} else if (wchr == W_NEW_LINE) {
+				validate_row_end(validate, row_offset, column + 1, &expected);
+				column = 0;
+				state = E_VALIDATE_START;
+			}
+			break;
+
+		case E_VALIDATE_ESCAPED:
+
+			if (wchr == W_QUOTE) {
+				state = E_VALIDATE_QUOTE;
+			}
+			break;
+
+		case E_VALIDATE_QUOTE:
+
+			if (wchr == W_QUOTE) {
+				state = E_VALIDATE_ESCAPED;
+
+			} else if (wchr == cfg_parser->delim) {
+				column++;
+				state = E_VALIDATE_START;
+
+			} else if (wchr == W_NEW_LINE) {
+				validate_row_end(validate, row_offset, column + 1, &expected);
+				column = 0;
+				state = E_VALIDATE_START;
+
+			} else {
+
+				//
+				// The rest of the field is treated as unescaped.
+				//
+				fprintf(validate->out, "%s: offset %ld: invalid character after a quote: %lc\n", validate->name, offset, wchr);
+				result->char_errors++;
+				state = E_VALIDATE_UNESCAPED;
+			}
+			break;
+		}
+	}
+
+	//
+	// An escaped field without a closing quote contains the rest of the file.
+	//
+	if (state == E_VALIDATE_ESCAPED) {
+		fprintf(validate->out, "%s: offset %ld: quote missing\n", validate->name, quote_offset);
+		result->quote_errors++;
+	}
+
+	//
+	// The last row has no line ending.
+	//
+	if (state != E_VALIDATE_START || column > 0) {
+		validate_row_end(validate, row_offset, column + 1, &expected);
+	}
+
+	free(validate);
+}
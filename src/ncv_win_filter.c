@@ -50,9 +50,21 @@
 //
 #define FILTER_ROW 0
 
-#define CASE_ROW 2
+#define COLUMNS_ROW 2
 
-#define SEARCH_ROW 4
+#define CASE_ROW 4
+
+#define SEARCH_ROW 6
+
+#define REGEX_ROW 8
+
+#define FUZZY_ROW 10
+
+#define MULTI_ROW 12
+
+#define EXPR_ROW 14
+
+#define LIVE_ROW 16
 
 //
 // The length and the heights of the fields
@@ -66,6 +78,18 @@
 //
 static s_popup popup;
 
+//
+// The number of matches of a live filter, which is shown in the box of the
+// popup. A negative value means that there is no number to show.
+//
+static int live_count = -1;
+
+//
+// The flag indicates that the matches are still counted, so the number is a
+// lower bound.
+//
+static bool live_is_counting = false;
+
 /******************************************************************************
  * The struct contains data specific to a field.
  *****************************************************************************/
@@ -338,11 +362,11 @@ void popup_get_sizes(const s_popup *popup, s_popup_sizes *popup_sizes, const int
 }
 
 /******************************************************************************
- * The function prints the content of the window. It contains of the fields
- * with their labels, inside a window with a box.
+ * The function prints the box of the window, with the number of matches of a
+ * live filter.
  *****************************************************************************/
 
-static void win_filter_print_content() {
+static void win_filter_print_box() {
 
 	//
 	// Add a box
@@ -351,6 +375,24 @@ static void win_filter_print_content() {
 		log_exit_str("Unable to setup win!");
 	}
 
+	//
+	// Print the number of matches of a live filter on the bottom line of the
+	// box.
+	//
+	if (live_count >= 0) {
+		mvwprintw(popup.win, popup_sizes.win_rows - 1, BOX + PADDING, " Matches: %ls%d ", live_is_counting ? L"\u2265" : L"", live_count);
+	}
+}
+
+/******************************************************************************
+ * The function prints the content of the window. It contains of the fields
+ * with their labels, inside a window with a box.
+ *****************************************************************************/
+
+static void win_filter_print_content() {
+
+	win_filter_print_box();
+
 	//
 	// post form and menu with their wins
 	//
@@ -416,7 +458,7 @@ void win_filter_init() {
 	//
 	popup_init(&popup);
 
-	FIELD **fields = forms_create_fields(3);
+	FIELD **fields = forms_create_fields(9);
 
 	//
 	// Create filter field
@@ -424,17 +466,61 @@ void win_filter_init() {
 	fields[0] = forms_create_field(FIELD_HIGHT, FILTER_FIELD_COLS, FILTER_ROW, 0, attr_input);
 	field_user_ptr_create(fields[0], FIELD_TYPE_INPUT, "Filter: ", forms_process_input_field);
 
+	//
+	// The filter string can be longer than the field, especially regular
+	// expressions, so the field is scrolling.
+	//
+	if (field_opts_off(fields[0], O_STATIC) != E_OK || set_max_field(fields[0], FILTER_STR_LEN) != E_OK) {
+		log_exit_str("Unable to make the filter field dynamic!");
+	}
+
+	//
+	// Create the columns field, which restricts the filter to columns.
+	//
+	fields[1] = forms_create_field(FIELD_HIGHT, FILTER_FIELD_COLS, COLUMNS_ROW, 0, attr_input);
+	field_user_ptr_create(fields[1], FIELD_TYPE_INPUT, "Columns: ", forms_process_input_field);
+
 	//
 	// Create case checkbox field
 	//
-	fields[1] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, CASE_ROW, 1, attr_normal);
-	field_user_ptr_create(fields[1], FIELD_TYPE_CHECKBOX, "Case: ", forms_process_checkbox);
+	fields[2] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, CASE_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[2], FIELD_TYPE_CHECKBOX, "Case: ", forms_process_checkbox);
 
 	//
 	// Create search checkbox field
 	//
-	fields[2] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, SEARCH_ROW, 1, attr_normal);
-	field_user_ptr_create(fields[2], FIELD_TYPE_CHECKBOX, "Search: ", forms_process_checkbox);
+	fields[3] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, SEARCH_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[3], FIELD_TYPE_CHECKBOX, "Search: ", forms_process_checkbox);
+
+	//
+	// Create regex checkbox field
+	//
+	fields[4] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, REGEX_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[4], FIELD_TYPE_CHECKBOX, "Regex: ", forms_process_checkbox);
+
+	//
+	// Create fuzzy checkbox field
+	//
+	fields[5] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, FUZZY_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[5], FIELD_TYPE_CHECKBOX, "Fuzzy: ", forms_process_checkbox);
+
+	//
+	// Create multi pattern checkbox field
+	//
+	fields[6] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, MULTI_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[6], FIELD_TYPE_CHECKBOX, "Multi: ", forms_process_checkbox);
+
+	//
+	// Create expression checkbox field
+	//
+	fields[7] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, EXPR_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[7], FIELD_TYPE_CHECKBOX, "Expr: ", forms_process_checkbox);
+
+	//
+	// Create live checkbox field, which applies the filter while typing.
+	//
+	fields[8] = forms_create_field(FIELD_HIGHT, CKBOX_FIELD_LEN, LIVE_ROW, 1, attr_normal);
+	field_user_ptr_create(fields[8], FIELD_TYPE_CHECKBOX, "Live: ", forms_process_checkbox);
 
 	//
 	// Create the for with the fields
@@ -546,10 +632,14 @@ void win_filter_resize() {
  * The function updates the filter struct with the data from the form fields.
  * It sets the has_changed flag if the struct changed. It is assumed that the
  * filtering should be activated if the filter string is not empty.
+ *
+ * If the filter should be activated, but the columns field is not valid, the
+ * function returns false and the filter struct is unchanged.
  *****************************************************************************/
 
-static void win_filter_get_filter(s_filter *to_filter, s_popup *popup, const bool is_active) {
+static bool win_filter_get_filter(s_filter *to_filter, s_popup *popup, const bool is_active) {
 	s_filter from_filter;
+	wchar_t cols_str[FILTER_COLS_LEN + 1];
 
 	FIELD **fields = form_fields(popup->form);
 	if (fields == NULL) {
@@ -561,9 +651,33 @@ static void win_filter_get_filter(s_filter *to_filter, s_popup *popup, const boo
 	//
 	forms_get_input_str(fields[0], from_filter.str, FILTER_STR_LEN + 1);
 
-	from_filter.case_insensitive = !forms_checkbox_is_checked(fields[1]);
+	from_filter.case_insensitive = !forms_checkbox_is_checked(fields[2]);
+
+	from_filter.is_search = forms_checkbox_is_checked(fields[3]);
+
+	from_filter.is_regex = forms_checkbox_is_checked(fields[4]);
 
-	from_filter.is_search = forms_checkbox_is_checked(fields[2]);
+	from_filter.is_fuzzy = forms_checkbox_is_checked(fields[5]);
+
+	from_filter.is_multi = forms_checkbox_is_checked(fields[6]);
+
+	from_filter.is_expr = forms_checkbox_is_checked(fields[7]);
+
+	//
+	// Parse the column restriction. On CANCEL or ESC an invalid value is
+	// ignored, which means the filter is not restricted.
+	//
+	forms_get_input_str(fields[1], cols_str, FILTER_COLS_LEN + 1);
+
+	if (!s_filter_set_columns(&from_filter, cols_str)) {
+
+		if (is_active) {
+			log_debug("Invalid columns: %ls", cols_str);
+			return false;
+		}
+
+		s_filter_set_columns(&from_filter, L"");
+	}
 
 	//
 	// On CANCEL or ESC the filter is inactive although the filter string is
@@ -580,6 +694,8 @@ static void win_filter_get_filter(s_filter *to_filter, s_popup *popup, const boo
 #ifdef DEBUG
 	s_filter_print(to_filter);
 #endif
+
+	return true;
 }
 
 /******************************************************************************
@@ -596,17 +712,15 @@ static bool process_menu_input(s_filter *filter, s_popup *popup, const int key_t
 
 		case 0:
 			//
-			// OK button
+			// OK button (the popup stays open if the input is not valid)
 			//
-			win_filter_get_filter(filter, popup, true);
-			return true;
+			return win_filter_get_filter(filter, popup, true);
 
 		case 1:
 			//
 			// CANCEL button
 			//
-			win_filter_get_filter(filter, popup, false);
-			return true;
+			return win_filter_get_filter(filter, popup, false);
 		}
 	}
 
@@ -631,11 +745,9 @@ static bool process_form_input(s_filter *filter, s_popup *popup, const int key_t
 		case NCV_KEY_NEWLINE:
 
 			//
-			// Submit form
+			// Submit form (the popup stays open if the input is not valid)
 			//
-			win_filter_get_filter(filter, popup, true);
-
-			return true;
+			return win_filter_get_filter(filter, popup, true);
 
 		case CTRL('x'):
 
@@ -715,6 +827,53 @@ bool win_filter_process_input(s_filter *filter, const int key_type, const wint_t
 
 void win_filter_prepair_show() {
 	popup_prepair_show(&popup);
+
+	win_filter_set_count(-1, false);
+}
+
+/******************************************************************************
+ * The function returns true if the live checkbox is checked, which means that
+ * the filter should be applied while typing.
+ *****************************************************************************/
+
+bool win_filter_is_live() {
+
+	FIELD **fields = form_fields(popup.form);
+	if (fields == NULL) {
+		log_exit_str("Unable to get form fields!");
+	}
+
+	return forms_checkbox_is_checked(fields[8]);
+}
+
+/******************************************************************************
+ * The function updates the filter struct with the current data from the form
+ * fields, without closing the popup. It is used for the live filtering. The
+ * function returns false if the input is not valid.
+ *****************************************************************************/
+
+bool win_filter_peek_filter(s_filter *filter) {
+	return win_filter_get_filter(filter, &popup, true);
+}
+
+/******************************************************************************
+ * The function sets the number of matches of a live filter, which is shown in
+ * the box of the popup. A negative value removes the number. If the matches
+ * are still counted, the number is shown as a lower bound.
+ *****************************************************************************/
+
+void win_filter_set_count(const int count, const bool is_counting) {
+
+	live_count = count;
+	live_is_counting = is_counting;
+
+	win_filter_print_box();
+
+	//
+	// Printing moves the cursor of the window, so it has to be set back to
+	// the field.
+	//
+	popup_pos_cursor(&popup);
 }
 
 /******************************************************************************
@@ -53,6 +53,16 @@
 
 #define LABEL_COL L"Col"
 
+#define LABEL_MATCH L"Match"
+
+#define LABEL_FILTERING L"Filtering"
+
+#define LABEL_SORTING L"Sorting"
+
+#define LABEL_INDEXING L"Indexing"
+
+#define LABEL_PATTERNS L"Patterns"
+
 /******************************************************************************
  * Definition of the footer window.
  *****************************************************************************/
@@ -61,6 +71,13 @@ static WINDOW *win_footer = NULL;
 
 static wchar_t *msg = NULL;
 
+static const s_progress *progress = NULL;
+
+//
+// The progress of the background count of the matches of a search.
+//
+static const s_progress *counting = NULL;
+
 static chtype attr_normal;
 
 static chtype attr_highlight;
@@ -74,6 +91,54 @@ void win_footer_set_msg(wchar_t *message) {
 	msg = message;
 }
 
+/******************************************************************************
+ * The function sets the progress of a background update of the table, which
+ * is printed instead of the cursor informations.
+ *****************************************************************************/
+
+void win_footer_set_progress(const s_progress *job_progress) {
+	progress = job_progress;
+}
+
+/******************************************************************************
+ * The function sets the progress of the count of the matches of a search. As
+ * long as it is set, the number of matches is a lower bound. NULL means that
+ * the count is exact.
+ *****************************************************************************/
+
+void win_footer_set_counting(const s_progress *count_progress) {
+	counting = count_progress;
+}
+
+/******************************************************************************
+ * The function prints the progress of a background update to the buffer. The
+ * sorting has no percentage, because qsort does not report its progress.
+ *****************************************************************************/
+
+static void progress_to_buf(wchar_t *buf, const int max) {
+
+	const int phase = atomic_load_explicit(&progress->phase, memory_order_relaxed);
+	const int done = atomic_load_explicit(&progress->done, memory_order_relaxed);
+	const int total = atomic_load_explicit(&progress->total, memory_order_relaxed);
+
+	const int percent = total > 0 ? (int) ((100L * done) / total) : 0;
+
+	switch (phase) {
+
+	case E_PHASE_FILTER:
+		swprintf(buf, max, L" %ls: %d%% (ESC to cancel) ", LABEL_FILTERING, percent);
+		break;
+
+	case E_PHASE_INDEX:
+		swprintf(buf, max, L" %ls: %d%% (ESC to cancel) ", LABEL_INDEXING, percent);
+		break;
+
+	default:
+		swprintf(buf, max, L" %ls... (ESC to cancel) ", LABEL_SORTING);
+		break;
+	}
+}
+
 /******************************************************************************
  * The function is called to initialize the footer window.
  *****************************************************************************/
@@ -122,10 +187,36 @@ void win_footer_resize() {
 
 /******************************************************************************
  * The function prints the cursor and the row / column informations if they are
- * present.
+ * present. If the cursor is on a match, the match number is printed too.
  *****************************************************************************/
 
-static void cursor_to_buf(wchar_t *buf, const int max, const s_table *table, const s_cursor *cursor) {
+static void cursor_to_buf(wchar_t *buf, int max, const s_table *table, const s_cursor *cursor) {
+
+	//
+	// If the cursor is on a match of the filter, the number of the match is
+	// printed first.
+	//
+	const int match_idx = cursor->visible ? s_table_match_idx(table, cursor) : -1;
+
+	if (match_idx >= 0) {
+		int len;
+
+		//
+		// While the matches are counted, the number is a lower bound.
+		//
+		if (counting != NULL) {
+			const int found = atomic_load_explicit(&counting->found, memory_order_relaxed);
+			len = swprintf(buf, max, L" %ls: %d/\u2265%d", LABEL_MATCH, match_idx + 1, found > table->filter.count ? found : table->filter.count);
+
+		} else {
+			len = swprintf(buf, max, L" %ls: %d/%d", LABEL_MATCH, match_idx + 1, table->filter.count);
+		}
+
+		if (len > 0) {
+			buf += len;
+			max -= len;
+		}
+	}
 
 	if (s_filter_is_active(&table->filter) && s_filter_is_filtering(&table->filter)) {
 
@@ -145,10 +236,38 @@ static void cursor_to_buf(wchar_t *buf, const int max, const s_table *table, con
 	}
 }
 
+/******************************************************************************
+ * The function prints the number of matches of each pattern of a multi
+ * pattern filter to the buffer. The patterns are added as long as they fit
+ * in the given width.
+ *****************************************************************************/
+
+static void patterns_to_buf(wchar_t *buf, const int width, const s_aho *aho) {
+	const int max = width + 1 < FOOTER_BUF_SIZE ? width + 1 : FOOTER_BUF_SIZE;
+	int len, written;
+
+	if ((len = swprintf(buf, max, L" %ls:", LABEL_PATTERNS)) < 0) {
+		buf[0] = W_STR_TERM;
+		return;
+	}
+
+	for (int i = 0; i < s_aho_no_patterns(aho); i++) {
+
+		if ((written = swprintf(buf + len, max - len, L" %ls=%d", s_aho_pattern(aho, i), s_aho_get_count(aho, i))) < 0) {
+			buf[len] = W_STR_TERM;
+			return;
+		}
+
+		len += written;
+	}
+}
+
 /******************************************************************************
  * The function prints the footer line, which consists of the current row /
  * column index of the field cursor and the filename. If there is not enough
- * space, the filename is shorten or completely left out.
+ * space, the filename is shorten or completely left out. For a multi pattern
+ * filter, the number of matches of the patterns are printed instead of the
+ * filename.
  *****************************************************************************/
 
 void win_footer_content_print(const s_table *table, const s_cursor *cursor, const char *filename) {
@@ -178,6 +297,16 @@ void win_footer_content_print(const s_table *table, const s_cursor *cursor, cons
 		//
 		msg = NULL;
 
+	} else if (progress != NULL) {
+
+		progress_to_buf(buf, FOOTER_BUF_SIZE);
+		written = nc_cond_addstr(win_footer, buf, win_width, AT_RIGHT);
+
+		//
+		// The progress is set before each print.
+		//
+		progress = NULL;
+
 	} else {
 		cursor_to_buf(buf, FOOTER_BUF_SIZE, table, cursor);
 		written = nc_cond_addstr(win_footer, buf, win_width, AT_RIGHT);
@@ -191,6 +320,17 @@ void win_footer_content_print(const s_table *table, const s_cursor *cursor, cons
 		return;
 	}
 
+	//
+	// The summary of a multi pattern filter.
+	//
+	if (s_filter_is_active(&table->filter) && table->filter.aho != NULL) {
+		patterns_to_buf(buf, win_width - written, table->filter.aho);
+
+		if (nc_cond_addstr(win_footer, buf, win_width - written, AT_LEFT) > 0) {
+			return;
+		}
+	}
+
 	//
 	// If we read the csv file from stdin, no filename is defined.
 	//
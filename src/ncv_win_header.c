@@ -36,6 +36,12 @@
 
 #define SEARCH_LABEL  L"Search"
 
+#define COLUMNS_LABEL L"Columns"
+
+#define REGEX_DELIM   L"/"
+
+#define FUZZY_DELIM   L"~"
+
 #define HEADER_BUF_SIZE 256
 
 /******************************************************************************
@@ -106,9 +112,23 @@ void win_header_content_print(const s_filter *filter) {
 
 		const wchar_t *label = filter->is_search ? SEARCH_LABEL : FILTER_LABEL;
 
+		//
+		// A regular expression is enclosed in slashes: /[0-9]+/ and a fuzzy
+		// pattern in tildes: ~recieved~ but not an expression.
+		//
+		const wchar_t *delim = filter->is_expr ? L"" : filter->is_regex ? REGEX_DELIM : filter->is_fuzzy ? FUZZY_DELIM : L"";
+
 		wchar_t buf[HEADER_BUF_SIZE];
 
-		swprintf(buf, HEADER_BUF_SIZE, L" %ls: %ls ", label, filter->str);
+		//
+		// If the filter is restricted to columns, the columns are added.
+		//
+		if (s_filter_is_restricted(filter)) {
+			swprintf(buf, HEADER_BUF_SIZE, L" %ls: %ls%ls%ls %ls: %ls ", label, delim, filter->str, delim, COLUMNS_LABEL, filter->cols_str);
+
+		} else {
+			swprintf(buf, HEADER_BUF_SIZE, L" %ls: %ls%ls%ls ", label, delim, filter->str, delim);
+		}
 
 		written = nc_cond_addstr(win_header, buf, max_width, AT_RIGHT);
 
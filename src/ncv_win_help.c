@@ -51,6 +51,9 @@ static const char *msgs[] = {
 		"       resets table",
 	    "^N, ^P Searches next/previous string",
 	    "^S, ^R Sorts by current column",
+	    ">, <   Adds column as next sort key",
+	    "^T     Toggles the sort type",
+	    "&, |, ! Combines with last filter",
 		NULL
 };
 // @formatter:on
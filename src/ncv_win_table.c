@@ -63,6 +63,12 @@ static s_table_part row_table_part;
 
 static s_table_part col_table_part;
 
+/******************************************************************************
+ * The cache for the matches of the filter, that are highlighted.
+ *****************************************************************************/
+
+static s_spans_cache spans_cache;
+
 /******************************************************************************
  * The macro is called with a s_cursor and a s_field. If checks whether the
  * field is the cursor field of the table.
@@ -105,6 +111,8 @@ void win_table_init() {
 	attr_header_cursor.normal = ncurses_attr_color(COLOR_PAIR(CP_HEADER_CURSOR) | A_BOLD, A_REVERSE | A_BOLD);
 
 	attr_header_cursor.highlight = ncurses_attr_color(COLOR_PAIR(CP_HEADER_CURSOR_HL) | A_BOLD, A_REVERSE | A_BOLD | A_UNDERLINE);
+
+	s_spans_cache_init(&spans_cache);
 }
 
 /******************************************************************************
@@ -162,6 +170,11 @@ void win_table_on_table_change(const s_table *table, s_cursor *cursor) {
 	// Initialize the corners
 	//
 	s_corner_inits(table->no_rows, table->no_columns);
+
+	//
+	// The filter may have changed, so the cached matches are outdated.
+	//
+	s_spans_cache_invalidate(&spans_cache);
 }
 
 /******************************************************************************
@@ -262,21 +275,40 @@ void win_table_set_cursor(const s_table *table, s_cursor *cursor, const enum e_d
 #define get_row_col_offset(p, i) (((p).direction == E_DIR_FORWARD || ((p).truncated == -1 && i == (p).first)) ? 1 : 0)
 
 /******************************************************************************
- * The macro returns the char for the horizontal border. If column is sorted,
- * the first and the last char are special. The macro is called with a table
- * and an index of a column. Results are: '>', '<', '-'
+ * The function returns the char for the horizontal border. If column is
+ * sorted, the first and the last char are special. The function is called
+ * with a table and an index of a column. Results are: '>', '<', '-'
+ *
+ * If the table is sorted by more than one column, the priority of the sort
+ * key (1, 2, ...) is returned as the mark, which is printed after the first
+ * border char. Otherwise the mark is 0.
  *****************************************************************************/
 
-#define get_border_char(t, i) ((t)->sort.is_active && (t)->sort.column == (i)) ? ((t)->sort.direction == E_DIR_FORWARD ? '>' : '<') : NCV_HLINE;
+static chtype get_border_char(const s_table *table, const int column, chtype *mark) {
+
+	const int idx = s_sort_key_idx(&table->sort, column);
+
+	*mark = 0;
+
+	if (idx < 0) {
+		return NCV_HLINE;
+	}
+
+	if (table->sort.no_keys > 1) {
+		*mark = '1' + idx;
+	}
+
+	return table->sort.keys[idx].direction == E_DIR_FORWARD ? '>' : '<';
+}
 
 /******************************************************************************
  * The function prints a horizontal line. The first and last chars are the
  * border char and the rest of the chars are the line char.
  *
- * Examples: ">------->" or "<-------<" or "---------"
+ * Examples: ">------->" or "<-------<" or "---------" or ">2------>"
  *****************************************************************************/
 
-static void mvw_hline(WINDOW *win, const int row, const int col, const chtype border, const chtype line, const int width) {
+static void mvw_hline(WINDOW *win, const int row, const int col, const chtype border, const chtype line, const chtype mark, const int width) {
 
 #ifdef DEBUG
 	//
@@ -314,6 +346,14 @@ static void mvw_hline(WINDOW *win, const int row, const int col, const chtype bo
 				// If space is left, print line chars.
 				//
 				mvwhline(win, row, col + 1, line, width - 2);
+
+				//
+				// If the column has a priority, it is printed after the
+				// first border char.
+				//
+				if (mark != 0) {
+					mvwaddch(win, row, col + 1, mark);
+				}
 			}
 		}
 	}
@@ -435,7 +475,17 @@ void win_table_content_print(const s_table *table, const s_cursor *cursor) {
 					wattrset(win_table, attr_cur->normal);
 				}
 
-				print_field_content(win_table, table->fields[idx.row][idx.col], &row_field_part, &col_field_part, &win_text, table->width[idx.col], &table->filter, attr_cur);
+				//
+				// Only columns that are searched by the filter are
+				// highlighted. The matches are computed once and cached.
+				//
+				const s_spans_entry *spans = NULL;
+
+				if (s_filter_is_active(&table->filter) && s_filter_has_column(&table->filter, idx.col)) {
+					spans = s_spans_cache_get(&spans_cache, idx.col, table->fields[idx.row][idx.col], &table->filter);
+				}
+
+				print_field_content(win_table, table->fields[idx.row][idx.col], &row_field_part, &col_field_part, &win_text, table->width[idx.col], spans, attr_cur);
 
 				//
 				// Reset the attribute the the table normal value.
@@ -450,21 +500,21 @@ void win_table_content_print(const s_table *table, const s_cursor *cursor) {
 			// last char of the horirontal line are special.
 			// Example: ">------->"
 			//
-			const chtype border = get_border_char(table, idx.col)
-			;
+			chtype mark;
+			const chtype border = get_border_char(table, idx.col, &mark);
 
 			if (row_table_part.direction == E_DIR_FORWARD) {
-				mvw_hline(win_table, win_field.row, win_text.col, border, NCV_HLINE, col_field_part.size);
+				mvw_hline(win_table, win_field.row, win_text.col, border, NCV_HLINE, mark, col_field_part.size);
 
 				if (is_not_truncated_and_last(&row_table_part, idx.row)) {
-					mvw_hline(win_table, win_field_end.row, win_text.col, border, NCV_HLINE, col_field_part.size);
+					mvw_hline(win_table, win_field_end.row, win_text.col, border, NCV_HLINE, mark, col_field_part.size);
 					num_borders.row++;
 				}
 			} else {
-				mvw_hline(win_table, win_field_end.row, win_text.col, border, NCV_HLINE, col_field_part.size);
+				mvw_hline(win_table, win_field_end.row, win_text.col, border, NCV_HLINE, mark, col_field_part.size);
 
 				if (is_not_truncated_and_first(&row_table_part, idx.row)) {
-					mvw_hline(win_table, win_field.row, win_text.col, border, NCV_HLINE, col_field_part.size);
+					mvw_hline(win_table, win_field.row, win_text.col, border, NCV_HLINE, mark, col_field_part.size);
 					num_borders.row++;
 				}
 			}
@@ -736,5 +786,7 @@ void win_table_free() {
 
 	log_debug_str("Removing table window.");
 	ncurses_win_free(win_table);
+
+	s_spans_cache_free(&spans_cache);
 }
 
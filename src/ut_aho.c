@@ -0,0 +1,225 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_aho.h"
+
+#include <stdbool.h>
+#include <locale.h>
+
+/******************************************************************************
+ * The function counts the (overlapping) occurrences of a pattern in a string
+ * with a naive search. It is used to check the automaton.
+ *****************************************************************************/
+
+static int naive_count(const wchar_t *pattern, const wchar_t *str) {
+	int count = 0;
+
+	for (const wchar_t *ptr = str; (ptr = wcsstr(ptr, pattern)) != NULL; ptr++) {
+		count++;
+	}
+
+	return count;
+}
+
+/******************************************************************************
+ * The function searches a string from an offset and checks the position and
+ * the length of the match.
+ *****************************************************************************/
+
+static void check_search(const s_aho *aho, const wchar_t *str, const size_t offset, const int start, const size_t len) {
+	size_t match_len;
+
+	log_debug("Str: '%ls' offset: %zu", str, offset);
+
+	const wchar_t *ptr = s_aho_search(aho, str, offset, &match_len);
+
+	if (start < 0) {
+		ut_check_wcs_null(ptr, UT_IS_NULL);
+
+	} else {
+		ut_check_int((int) (ptr - str), start, "search - start");
+		ut_check_size(match_len, len, "search - len");
+	}
+}
+
+/******************************************************************************
+ * The function checks the creation of the automaton.
+ *****************************************************************************/
+
+static void test_aho_create() {
+	wchar_t *empty[] = { L"abc", L"" };
+
+	log_debug_str("Start");
+
+	ut_check_bool(s_aho_create(empty, 0, false) == NULL, true);
+	ut_check_bool(s_aho_create(empty, 2, false) == NULL, true);
+
+	s_aho *aho = s_aho_create(empty, 1, false);
+	ut_check_int(s_aho_no_patterns(aho), 1, "create - no patterns");
+	ut_check_wchar_str(s_aho_pattern(aho, 0), L"abc");
+	s_aho_free(aho);
+}
+
+/******************************************************************************
+ * The function checks the matching and searching with overlapping patterns.
+ *****************************************************************************/
+
+static void test_aho_search() {
+	wchar_t *patterns[] = { L"he", L"she", L"his", L"hers", L"Ärger" };
+
+	log_debug_str("Start");
+
+	s_aho *aho = s_aho_create(patterns, 5, false);
+
+	ut_check_bool(s_aho_matches(aho, L"ushers"), true);
+	ut_check_bool(s_aho_matches(aho, L"hi s"), false);
+	ut_check_bool(s_aho_matches(aho, L""), false);
+	ut_check_bool(s_aho_matches(aho, L"ärger"), false);
+
+	//
+	// The first match ends first, the longest for the same end.
+	//
+	check_search(aho, L"ushers", 0, 1, 3);
+	check_search(aho, L"ushers", 3, -1, 0);
+	check_search(aho, L"xhis", 0, 1, 3);
+	check_search(aho, L"xhis", 2, -1, 0);
+	check_search(aho, L"viel Ärger", 0, 5, 5);
+
+	s_aho_free(aho);
+
+	//
+	// Case insensitive with non ASCII chars
+	//
+	aho = s_aho_create(patterns, 5, true);
+
+	ut_check_bool(s_aho_matches(aho, L"ÄRGER"), true);
+	ut_check_bool(s_aho_matches(aho, L"SHE"), true);
+
+	s_aho_free(aho);
+}
+
+/******************************************************************************
+ * The function checks the counting of the occurrences of duplicate and
+ * overlapping patterns.
+ *****************************************************************************/
+
+static void test_aho_count() {
+	wchar_t *patterns[] = { L"aa", L"a", L"b", L"aa", L"xyz" };
+
+	log_debug_str("Start");
+
+	s_aho *aho = s_aho_create(patterns, 5, false);
+
+	ut_check_int(s_aho_count(aho, L"aaab"), 6, "count - total");
+	ut_check_int(s_aho_count(aho, L"ba"), 2, "count - total");
+
+	ut_check_int(s_aho_get_count(aho, 0), 2, "count - aa");
+	ut_check_int(s_aho_get_count(aho, 1), 4, "count - a");
+	ut_check_int(s_aho_get_count(aho, 2), 2, "count - b");
+	ut_check_int(s_aho_get_count(aho, 3), 2, "count - aa");
+	ut_check_int(s_aho_get_count(aho, 4), 0, "count - xyz");
+
+	s_aho_reset_counts(aho);
+	ut_check_int(s_aho_get_count(aho, 1), 0, "count - reset");
+
+	s_aho_free(aho);
+}
+
+/******************************************************************************
+ * The function checks the counting with a naive search for generated
+ * patterns and strings with a small alphabet.
+ *****************************************************************************/
+
+static void test_aho_naive() {
+	wchar_t buf[8][8];
+	wchar_t *patterns[8];
+	wchar_t str[64];
+	unsigned int seed = 42;
+
+	log_debug_str("Start");
+
+	for (int run = 0; run < 500; run++) {
+
+		const int no_patterns = 1 + rand_r(&seed) % 8;
+
+		for (int i = 0; i < no_patterns; i++) {
+			const int len = 1 + rand_r(&seed) % 6;
+
+			for (int j = 0; j < len; j++) {
+				buf[i][j] = L'a' + rand_r(&seed) % 3;
+			}
+			buf[i][len] = W_STR_TERM;
+			patterns[i] = buf[i];
+		}
+
+		const int str_len = rand_r(&seed) % 63;
+
+		for (int i = 0; i < str_len; i++) {
+			str[i] = L'a' + rand_r(&seed) % 3;
+		}
+		str[str_len] = W_STR_TERM;
+
+		s_aho *aho = s_aho_create(patterns, no_patterns, false);
+
+		s_aho_count(aho, str);
+
+		bool found = false;
+
+		for (int i = 0; i < no_patterns; i++) {
+			ut_check_int(s_aho_get_count(aho, i), naive_count(patterns[i], str), "naive - count");
+			found = found || wcsstr(str, patterns[i]) != NULL;
+		}
+
+		ut_check_bool(s_aho_matches(aho, str), found);
+
+		s_aho_free(aho);
+	}
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	//
+	// The case insensitive matching of non ASCII chars requires a locale.
+	//
+	setlocale(LC_ALL, "");
+
+	test_aho_create();
+
+	test_aho_search();
+
+	test_aho_count();
+
+	test_aho_naive();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
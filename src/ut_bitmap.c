@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_bitmap.h"
+#include "ncv_lru.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/******************************************************************************
+ * The number of bits of the tests. The first chunk is dense, the second
+ * chunk is sparse, the third chunk is empty and the last chunk is partial.
+ *****************************************************************************/
+
+#define NO_BITS (3 * BITMAP_CHUNK_BITS + 100)
+
+/******************************************************************************
+ * The function sets the bits of a plain bit set. The step defines the density
+ * of the set and the offset the first bit.
+ *****************************************************************************/
+
+static uint64_t* test_bits(const int step_dense, const int step_sparse, const int offset) {
+
+	const size_t size = sizeof(uint64_t) * s_bits_words(NO_BITS);
+
+	uint64_t *bits = xmalloc(size);
+	memset(bits, 0, size);
+
+	for (int i = offset; i < BITMAP_CHUNK_BITS; i += step_dense) {
+		s_bits_set(bits, i);
+	}
+
+	for (int i = BITMAP_CHUNK_BITS + offset; i < 2 * BITMAP_CHUNK_BITS; i += step_sparse) {
+		s_bits_set(bits, i);
+	}
+
+	for (int i = 3 * BITMAP_CHUNK_BITS + offset; i < NO_BITS; i += step_dense) {
+		s_bits_set(bits, i);
+	}
+
+	return bits;
+}
+
+/******************************************************************************
+ * The function checks that a bitmap contains exactly the bits of a plain bit
+ * set.
+ *****************************************************************************/
+
+static void check_bits(const s_bitmap *bitmap, const uint64_t *bits, const char *msg) {
+	int count = 0;
+
+	uint64_t *result = xmalloc(sizeof(uint64_t) * s_bits_words(NO_BITS));
+	s_bitmap_to_bits(bitmap, result, NO_BITS);
+
+	for (int i = 0; i < NO_BITS; i++) {
+
+		if (s_bits_get(bits, i) != s_bits_get(result, i) || (bool) s_bits_get(bits, i) != s_bitmap_contains(bitmap, i)) {
+			log_exit("%s - bit: %d differs", msg, i);
+		}
+
+		count += s_bits_get(bits, i);
+	}
+
+	ut_check_int(s_bitmap_cardinality(bitmap), count, msg);
+
+	free(result);
+}
+
+/******************************************************************************
+ * The function checks the conversion from and to a plain bit set.
+ *****************************************************************************/
+
+static void test_bitmap_from_to() {
+	s_bitmap bitmap;
+
+	log_debug_str("Start");
+
+	uint64_t *bits = test_bits(3, 100, 1);
+
+	s_bitmap_from_bits(&bitmap, bits, NO_BITS);
+
+	//
+	// The empty chunk is not stored.
+	//
+	ut_check_int(bitmap.no_chunks, 3, "bitmap - chunks");
+
+	ut_check_bool(bitmap.chunks[0].words != NULL, true);
+	ut_check_bool(bitmap.chunks[1].array != NULL, true);
+
+	check_bits(&bitmap, bits, "bitmap - from to");
+
+	s_bitmap_free(&bitmap);
+
+	ut_check_int(s_bitmap_cardinality(&bitmap), 0, "bitmap - free");
+
+	free(bits);
+}
+
+/******************************************************************************
+ * The function checks the combination of two bitmaps against the combination
+ * of the plain bit sets.
+ *****************************************************************************/
+
+static void test_bitmap_combine() {
+	s_bitmap bitmap_1, bitmap_2, result;
+
+	log_debug_str("Start");
+
+	uint64_t *bits_1 = test_bits(2, 50, 0);
+	uint64_t *bits_2 = test_bits(3, 7, 0);
+	uint64_t *expected = xmalloc(sizeof(uint64_t) * s_bits_words(NO_BITS));
+
+	s_bitmap_from_bits(&bitmap_1, bits_1, NO_BITS);
+	s_bitmap_from_bits(&bitmap_2, bits_2, NO_BITS);
+
+	const enum e_bitmap_op ops[] = { E_BITMAP_AND, E_BITMAP_OR, E_BITMAP_AND_NOT };
+
+	for (int i = 0; i < 3; i++) {
+
+		for (int w = 0; w < s_bits_words(NO_BITS); w++) {
+			expected[w] = ops[i] == E_BITMAP_AND ? bits_1[w] & bits_2[w] : ops[i] == E_BITMAP_OR ? bits_1[w] | bits_2[w] : bits_1[w] & ~bits_2[w];
+		}
+
+		s_bitmap_combine(&result, &bitmap_1, &bitmap_2, ops[i]);
+		check_bits(&result, expected, "bitmap - combine");
+		s_bitmap_free(&result);
+	}
+
+	//
+	// The complement is restricted to the number of bits.
+	//
+	for (int w = 0; w < s_bits_words(NO_BITS); w++) {
+		expected[w] = ~bits_1[w];
+	}
+
+	expected[s_bits_words(NO_BITS) - 1] &= (UINT64_C(1) << (NO_BITS % 64)) - 1;
+
+	s_bitmap_not(&result, &bitmap_1, NO_BITS);
+	check_bits(&result, expected, "bitmap - not");
+	s_bitmap_free(&result);
+
+	s_bitmap_free(&bitmap_1);
+	s_bitmap_free(&bitmap_2);
+
+	free(bits_1);
+	free(bits_2);
+	free(expected);
+}
+
+/******************************************************************************
+ * The function checks the replacement of the least recently used entry of
+ * the cache.
+ *****************************************************************************/
+
+static void test_lru() {
+	s_lru lru;
+	s_bitmap bitmap;
+	wchar_t key[16];
+	uint64_t bits[1];
+
+	log_debug_str("Start");
+
+	s_lru_init(&lru);
+
+	ut_check_bool(s_lru_get(&lru, L"0") == NULL, true);
+	ut_check_bool(s_lru_get_other(&lru, L"0") == NULL, true);
+
+	//
+	// Each entry has a bitmap with the bit of its number.
+	//
+	for (int i = 0; i < LRU_SIZE; i++) {
+		bits[0] = UINT64_C(1) << i;
+		s_bitmap_from_bits(&bitmap, bits, 64);
+
+		swprintf(key, 16, L"%d", i);
+		s_lru_put(&lru, key, &bitmap);
+
+		ut_check_int(s_bitmap_cardinality(&bitmap), 0, "lru - ownership");
+	}
+
+	//
+	// Use the first entry, so the second entry is the least recently used.
+	//
+	ut_check_bool(s_bitmap_contains(s_lru_get(&lru, L"0"), 0), true);
+
+	bits[0] = 1;
+	s_bitmap_from_bits(&bitmap, bits, 64);
+	s_lru_put(&lru, L"new", &bitmap);
+
+	ut_check_int(lru.no_entries, LRU_SIZE, "lru - full");
+	ut_check_bool(s_lru_get(&lru, L"0") != NULL, true);
+	ut_check_bool(s_lru_get(&lru, L"1") == NULL, true);
+
+	//
+	// The other entry is the most recently used with a different key.
+	//
+	ut_check_bool(s_bitmap_contains(s_lru_get_other(&lru, L"new"), 0), true);
+	ut_check_bool(s_lru_get(&lru, L"2") != NULL, true);
+	ut_check_bool(s_bitmap_contains(s_lru_get_other(&lru, L"0"), 2), true);
+
+	s_lru_free(&lru);
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_bitmap_from_to();
+
+	test_bitmap_combine();
+
+	test_lru();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_blocks.h"
+#include "ncv_num.h"
+
+#include <stdbool.h>
+
+/******************************************************************************
+ * The number of rows of the tests, which is two blocks and one row.
+ *****************************************************************************/
+
+#define NO_ROWS (2 * BLOCK_ROWS + 1)
+
+/******************************************************************************
+ * The function checks the summaries of the blocks. The first block contains
+ * "abc" in column 0, the second block "Xyz" in column 1 and the last block
+ * (with one row) "123" in column 0.
+ *****************************************************************************/
+
+static void test_blocks_may_contain() {
+	s_blocks blocks;
+
+	log_debug_str("Start");
+
+	wchar_t **fields = xmalloc(sizeof(wchar_t*) * NO_ROWS * 2);
+	wchar_t ***rows = xmalloc(sizeof(wchar_t**) * NO_ROWS);
+
+	for (int row = 0; row < NO_ROWS; row++) {
+		rows[row] = &fields[row * 2];
+		rows[row][0] = L"";
+		rows[row][1] = L"";
+	}
+
+	rows[10][0] = L"abc";
+	rows[BLOCK_ROWS + 10][1] = L"Xyz";
+	rows[2 * BLOCK_ROWS][0] = L"123";
+
+	s_blocks_init(&blocks);
+	s_blocks_create(&blocks, rows, NO_ROWS, 2);
+
+	ut_check_int(blocks.no_blocks, 3, "blocks - count");
+
+	//
+	// A substring of a field or the empty string may be contained.
+	//
+	ut_check_bool(s_blocks_may_contain(&blocks, 0, 0, L"bc"), true);
+	ut_check_bool(s_blocks_may_contain(&blocks, 0, 0, L"ABC"), true);
+	ut_check_bool(s_blocks_may_contain(&blocks, 0, 0, L""), true);
+	ut_check_bool(s_blocks_may_contain(&blocks, 1, 1, L"xy"), true);
+	ut_check_bool(s_blocks_may_contain(&blocks, 2, 0, L"23"), true);
+
+	//
+	// Missing chars are never contained.
+	//
+	ut_check_bool(s_blocks_may_contain(&blocks, 0, 1, L"abc"), false);
+	ut_check_bool(s_blocks_may_contain(&blocks, 1, 0, L"abc"), false);
+	ut_check_bool(s_blocks_may_contain(&blocks, 2, 1, L"1"), false);
+
+	//
+	// Without summaries each block may contain the string.
+	//
+	ut_check_bool(s_blocks_may_contain(&blocks, 3, 0, L"abc"), true);
+
+	s_blocks_free(&blocks);
+
+	ut_check_int(blocks.no_blocks, 0, "blocks - free");
+
+	free(rows);
+	free(fields);
+}
+
+/******************************************************************************
+ * The function checks that a numeric range marks only the blocks with
+ * matching rows. The values of the first block are 0, the values of the
+ * second block are 100 and the last row has the value 50.
+ *****************************************************************************/
+
+static void test_blocks_num_range() {
+	s_num_column column;
+	s_num_range range;
+
+	log_debug_str("Start");
+
+	wchar_t *data[NO_ROWS][1];
+	wchar_t **rows[NO_ROWS];
+
+	for (int row = 0; row < NO_ROWS; row++) {
+		data[row][0] = row < BLOCK_ROWS ? L"0" : L"100";
+		rows[row] = data[row];
+	}
+
+	data[2 * BLOCK_ROWS][0] = L"50";
+
+	s_num_column_init(&column);
+	ut_check_bool(s_num_column_parse(&column, rows, NO_ROWS, 0, NULL), true);
+
+	ut_check_double(column.block_min[1], 100.0, "blocks - min");
+	ut_check_double(column.block_max[2], 50.0, "blocks - max");
+
+	s_num_range_init(&range, 0, 50, true, 100, false);
+	s_num_range_apply(&range, &column, NO_ROWS);
+
+	ut_check_bool(s_num_bit(range.blocks, 0), false);
+	ut_check_bool(s_num_bit(range.blocks, 1), false);
+	ut_check_bool(s_num_bit(range.blocks, 2), true);
+
+	ut_check_bool(s_num_bit(range.bitmap, 2 * BLOCK_ROWS), true);
+	ut_check_bool(s_num_bit(range.bitmap, BLOCK_ROWS), false);
+
+	s_num_range_free(&range);
+	s_num_column_free(&column);
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_blocks_may_contain();
+
+	test_blocks_num_range();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_date.h"
+
+/******************************************************************************
+ * The function parses a date with a format and checks the result.
+ *****************************************************************************/
+
+static void check_date(const enum e_date_order order, const wchar_t sep, const wchar_t *str, const bool expected, const int64_t epoch) {
+	const s_date_fmt fmt = { order, sep };
+	int64_t result;
+
+	ut_check_bool(s_date_parse(&fmt, str, &result), expected);
+
+	if (expected) {
+		ut_check_double((double) result, (double) epoch, "date - epoch");
+	}
+}
+
+/******************************************************************************
+ * The function checks the computation of the seconds since 1970-01-01.
+ *****************************************************************************/
+
+static void test_date_epoch() {
+
+	log_debug_str("Start");
+
+	ut_check_double((double) s_date_epoch(1970, 1, 1, 0, 0, 0), 0, "epoch - 1970");
+	ut_check_double((double) s_date_epoch(1969, 12, 31, 23, 59, 59), -1, "epoch - 1969");
+	ut_check_double((double) s_date_epoch(2000, 2, 29, 0, 0, 0), 951782400, "epoch - leap year");
+	ut_check_double((double) s_date_epoch(2026, 10, 16, 14, 3, 59), 1792159439, "epoch - 2026");
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the parsing of dates with the different formats.
+ *****************************************************************************/
+
+static void test_date_parse() {
+	int64_t epoch;
+
+	log_debug_str("Start");
+
+	check_date(E_DATE_YMD, L'-', L"2026-10-16", true, 1792108800);
+	check_date(E_DATE_YMD, L'-', L" 2026-10-16T14:03:59 ", true, 1792159439);
+	check_date(E_DATE_YMD, L'-', L"2026-10-16 14:03:59.123", true, 1792159439);
+	check_date(E_DATE_DMY, L'/', L"16/10/2026 14:03", true, 1792159380);
+	check_date(E_DATE_DMY, L'.', L"16.10.2026", true, 1792108800);
+	check_date(E_DATE_MDY, L'/', L"10/16/2026", true, 1792108800);
+	check_date(E_DATE_MON_D_Y, L' ', L"Oct 16 2026", true, 1792108800);
+	check_date(E_DATE_MON_D_Y, L' ', L"October 16, 2026 14:03", true, 1792159380);
+	check_date(E_DATE_D_MON_Y, L'-', L"16-oct.-2026", true, 1792108800);
+
+	//
+	// Invalid dates
+	//
+	check_date(E_DATE_YMD, L'-', L"2026-10-16x", false, 0);
+	check_date(E_DATE_YMD, L'-', L"2026-13-01", false, 0);
+	check_date(E_DATE_YMD, L'-', L"2026-02-29", false, 0);
+	check_date(E_DATE_YMD, L'-', L"2026-10-16 24:00", false, 0);
+	check_date(E_DATE_DMY, L'.', L"01.01.218", false, 0);
+	check_date(E_DATE_DMY, L'/', L"10/16/2026", false, 0);
+	check_date(E_DATE_MON_D_Y, L' ', L"Octo 16 2026", false, 0);
+	check_date(E_DATE_MON_D_Y, L' ', L"Octobers 16 2026", false, 0);
+
+	ut_check_bool(s_date_parse_iso(L"2026-10-16 14:03", &epoch), true);
+	ut_check_double((double) epoch, 1792159380, "iso - epoch");
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function detects the format of a column with a header.
+ *****************************************************************************/
+
+static void check_detect(wchar_t **data, const int no_rows, const bool expected, const enum e_date_order order, const wchar_t sep) {
+	wchar_t *rows_data[no_rows][1];
+	wchar_t **rows[no_rows];
+	unsigned int candidates;
+	s_date_fmt fmt;
+
+	for (int i = 0; i < no_rows; i++) {
+		rows_data[i][0] = data[i];
+		rows[i] = rows_data[i];
+	}
+
+	ut_check_bool(s_date_detect(rows, 1, no_rows, 0, &candidates, &fmt), expected);
+
+	if (expected) {
+		ut_check_int(fmt.order, order, "detect - order");
+		ut_check_int(fmt.sep, sep, "detect - separator");
+	}
+}
+
+static void test_date_detect() {
+
+	log_debug_str("Start");
+
+	check_detect((wchar_t*[] ) { L"date", L"2026-10-16", L"", L"2026-01-02 10:00" }, 4, true, E_DATE_YMD, L'-');
+	check_detect((wchar_t*[] ) { L"date", L"01/02/2026", L"16/10/2026 14:03" }, 3, true, E_DATE_DMY, L'/');
+	check_detect((wchar_t*[] ) { L"date", L"01/02/2026", L"10/16/2026 14:03" }, 3, true, E_DATE_MDY, L'/');
+	check_detect((wchar_t*[] ) { L"date", L"Oct 16 2026", L"Jan 2 2026" }, 3, true, E_DATE_MON_D_Y, L' ');
+	check_detect((wchar_t*[] ) { L"date", L"2026-10-16", L"16/10/2026" }, 3, false, E_DATE_YMD, L'-');
+	check_detect((wchar_t*[] ) { L"count", L"12", L"13" }, 3, false, E_DATE_YMD, L'-');
+	check_detect((wchar_t*[] ) { L"empty", L"", L" " }, 3, false, E_DATE_YMD, L'-');
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that an ambiguous format is narrowed with a field, that
+ * is not part of the sample.
+ *****************************************************************************/
+
+static void test_date_narrow() {
+	wchar_t *rows_data[3][1] = { { L"date" }, { L"01/02/2026" }, { L"03/04/2026" } };
+	wchar_t **rows[3] = { rows_data[0], rows_data[1], rows_data[2] };
+	unsigned int candidates;
+	s_date_fmt fmt;
+	int64_t epoch;
+
+	log_debug_str("Start");
+
+	//
+	// The sample is day first and month first, day first is preferred.
+	//
+	ut_check_bool(s_date_detect(rows, 1, 3, 0, &candidates, &fmt), true);
+	ut_check_int(fmt.order, E_DATE_DMY, "narrow - detect");
+
+	//
+	// The field is only valid as month first.
+	//
+	ut_check_bool(s_date_narrow(&candidates, L"10/13/2026", &fmt), true);
+	ut_check_int(fmt.order, E_DATE_MDY, "narrow - order");
+	ut_check_int(fmt.sep, L'/', "narrow - separator");
+
+	ut_check_bool(s_date_parse(&fmt, L"10/13/2026", &epoch), true);
+	ut_check_bool(s_date_parse(&fmt, L"01/02/2026", &epoch), true);
+
+	//
+	// No candidate is left.
+	//
+	ut_check_bool(s_date_narrow(&candidates, L"13/13/2026", &fmt), false);
+	ut_check_int(candidates, 0, "narrow - candidates");
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_date_epoch();
+
+	test_date_parse();
+
+	test_date_detect();
+
+	test_date_narrow();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
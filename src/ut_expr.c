@@ -0,0 +1,197 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_expr.h"
+
+#include <stdbool.h>
+#include <locale.h>
+
+/******************************************************************************
+ * The header and the rows, that are used for the tests.
+ *****************************************************************************/
+
+#define NO_COLUMNS 3
+
+static wchar_t *header[] = { L"status", L"latency", L"host" };
+
+static wchar_t *row_1[] = { L"FAIL", L"700", L"prod-1" };
+
+static wchar_t *row_2[] = { L"FAIL", L"200", L"prod-2" };
+
+static wchar_t *row_3[] = { L"OK", L" 900 ", L"test-1" };
+
+static wchar_t *row_4[] = { L"fail", L"n/a", L"test-2" };
+
+/******************************************************************************
+ * The function compiles an expression and checks the result of the evaluation
+ * for the rows 1 - 4.
+ *****************************************************************************/
+
+static void check_eval(const wchar_t *str, const bool case_insensitive, const bool r1, const bool r2, const bool r3, const bool r4) {
+
+	s_expr *expr = s_expr_create(str, case_insensitive, header, NO_COLUMNS);
+
+	if (expr == NULL) {
+		log_exit("Unable to compile: %ls", str);
+	}
+
+	log_debug("Expression: '%ls'", str);
+
+	ut_check_bool(s_expr_eval(expr, row_1, -1), r1);
+	ut_check_bool(s_expr_eval(expr, row_2, -1), r2);
+	ut_check_bool(s_expr_eval(expr, row_3, -1), r3);
+	ut_check_bool(s_expr_eval(expr, row_4, -1), r4);
+
+	s_expr_free(expr);
+}
+
+/******************************************************************************
+ * The function checks the compilation of valid and invalid expressions.
+ *****************************************************************************/
+
+static void test_expr_create() {
+
+	log_debug_str("Start");
+
+	const wchar_t *invalid[] = { L"", L"  ", L"status=", L"=FAIL", L"unknown=1", L"4=1", L"0=1", L"latency>abc", L"(a", L"a)", L"a OR", L"AND a",
+			L"NOT", L"\"abc", L"status!x",
+			L"latency BETWEEN 1", L"latency BETWEEN 1 OR 2", L"latency BETWEEN a AND 2", L"latency BETWEEN 1 AND b", NULL };
+
+	for (int i = 0; invalid[i] != NULL; i++) {
+		log_debug("Invalid: '%ls'", invalid[i]);
+		ut_check_bool(s_expr_create(invalid[i], false, header, NO_COLUMNS) == NULL, true);
+	}
+
+	//
+	// Without a header, only column numbers are valid.
+	//
+	ut_check_bool(s_expr_create(L"status=FAIL", false, NULL, NO_COLUMNS) == NULL, true);
+
+	s_expr *expr = s_expr_create(L"1=FAIL", false, NULL, NO_COLUMNS);
+	ut_check_bool(expr != NULL, true);
+	s_expr_free(expr);
+}
+
+/******************************************************************************
+ * The function checks the evaluation of expressions.
+ *****************************************************************************/
+
+static void test_expr_eval() {
+
+	log_debug_str("Start");
+
+	//
+	// Predicates
+	//
+	check_eval(L"status=FAIL", false, true, true, false, false);
+	check_eval(L"status=FAIL", true, true, true, false, true);
+	check_eval(L"STATUS!=fail", false, true, true, true, false);
+	check_eval(L"host~prod", false, true, true, false, false);
+	check_eval(L"3!~prod", false, false, false, true, true);
+	check_eval(L"latency>500", false, true, false, true, false);
+	check_eval(L"latency>=700", false, true, false, true, false);
+	check_eval(L"latency<700", false, false, true, false, false);
+	check_eval(L"latency<=700", false, true, true, false, false);
+	check_eval(L"host=\"test-1\"", false, false, false, true, false);
+	check_eval(L"latency BETWEEN 200 AND 700", false, true, true, false, false);
+	check_eval(L"latency between 201 and 900 and host~1", false, true, false, true, false);
+	check_eval(L"test", false, false, false, true, true);
+
+	//
+	// Combinations
+	//
+	check_eval(L"status=FAIL AND latency>500 AND NOT host~test", false, true, false, false, false);
+	check_eval(L"status=FAIL latency>500", false, true, false, false, false);
+	check_eval(L"status=OK OR latency<500", false, false, true, true, false);
+	check_eval(L"status=OK or latency>500 and host~prod", false, true, false, true, false);
+	check_eval(L"(status=OK or latency>500) and host~prod", false, true, false, false, false);
+	check_eval(L"not not (host~1)", false, true, false, true, false);
+	check_eval(L"NOT(host~1)", false, false, true, false, true);
+}
+
+/******************************************************************************
+ * The function checks the matching and the searching of fields, which are
+ * used for highlighting. Negated predicates do not match.
+ *****************************************************************************/
+
+static void test_expr_fields() {
+	size_t len;
+
+	log_debug_str("Start");
+
+	s_expr *expr = s_expr_create(L"latency>500 AND (host~od OR host~-) AND NOT status=OK", false, header, NO_COLUMNS);
+
+	ut_check_bool(expr != NULL, true);
+
+	ut_check_bool(s_expr_field_matches(expr, 0, L"OK"), false);
+	ut_check_bool(s_expr_field_matches(expr, 1, L"700"), true);
+	ut_check_bool(s_expr_field_matches(expr, 1, L"200"), false);
+	ut_check_bool(s_expr_field_matches(expr, 2, L"700"), false);
+	ut_check_bool(s_expr_field_matches(expr, 2, L"prod-1"), true);
+
+	//
+	// The comparison matches the whole field.
+	//
+	const wchar_t *str = L"700";
+	ut_check_bool(s_expr_search(expr, 1, str, 0, &len) == str, true);
+	ut_check_size(len, 3, "search - len");
+	ut_check_wcs_null(s_expr_search(expr, 1, str, 1, &len), UT_IS_NULL);
+
+	//
+	// The first match of the contains predicates.
+	//
+	str = L"prod-1";
+	ut_check_bool(s_expr_search(expr, 2, str, 0, &len) == str + 2, true);
+	ut_check_size(len, 2, "search - len");
+	ut_check_bool(s_expr_search(expr, 2, str, 3, &len) == str + 4, true);
+	ut_check_size(len, 1, "search - len");
+	ut_check_wcs_null(s_expr_search(expr, 2, str, 5, &len), UT_IS_NULL);
+
+	s_expr_free(expr);
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	//
+	// The case insensitive matching of non ASCII chars requires a locale.
+	//
+	setlocale(LC_ALL, "");
+
+	test_expr_create();
+
+	test_expr_eval();
+
+	test_expr_fields();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
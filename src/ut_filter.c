@@ -26,6 +26,7 @@
 #include "ncv_filter.h"
 
 #include <stdbool.h>
+#include <unistd.h>
 
 /******************************************************************************
  * The function checks if two s_filter structs are equal.
@@ -37,6 +38,8 @@ static void s_filter_cmp(const s_filter *filter_1, const s_filter *filter_2) {
 	ut_check_bool(filter_1->is_active, filter_2->is_active);
 	ut_check_bool(filter_1->case_insensitive, filter_2->case_insensitive);
 	ut_check_bool(filter_1->is_search, filter_2->is_search);
+	ut_check_wchar_str(filter_1->cols_str, filter_2->cols_str);
+	ut_check_bool(filter_1->is_regex, filter_2->is_regex);
 }
 
 /******************************************************************************
@@ -109,6 +112,31 @@ static void test_s_filter_update() {
 
 	ut_check_bool(result, HAS_CHANGED);
 
+	//
+	// Columns differ => update
+	//
+	s_filter_set(&dst_filter, SF_IS_INACTIVE, L"Hello", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	s_filter_set(&src_filter, SF_IS_INACTIVE, L"Hello", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	s_filter_set_columns(&src_filter, L"2");
+
+	result = s_filter_update(&dst_filter, &src_filter);
+	s_filter_cmp(&dst_filter, &src_filter);
+
+	ut_check_bool(result, HAS_CHANGED);
+	ut_check_bool(dst_filter.is_restricted, true);
+
+	//
+	// Regex flag differs => update
+	//
+	s_filter_set(&dst_filter, SF_IS_INACTIVE, L"Hello", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	s_filter_set(&src_filter, SF_IS_INACTIVE, L"Hello", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	src_filter.is_regex = true;
+
+	result = s_filter_update(&dst_filter, &src_filter);
+	s_filter_cmp(&dst_filter, &src_filter);
+
+	ut_check_bool(result, HAS_CHANGED);
+
 	log_debug_str("End");
 }
 
@@ -153,6 +181,210 @@ static void test_search_str() {
 	log_debug_str("End");
 }
 
+/******************************************************************************
+ * The function checks the parsing of the column restriction of a filter.
+ *****************************************************************************/
+
+static void test_set_columns() {
+	s_filter filter;
+
+	log_debug_str("Start");
+
+	s_filter_init(&filter);
+	s_filter_set(&filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	//
+	// Without a restriction all columns are searched.
+	//
+	ut_check_bool(s_filter_prepare(&filter, NULL, 8), true);
+	ut_check_bool(s_filter_is_restricted(&filter), false);
+	ut_check_bool(s_filter_has_column(&filter, 7), true);
+	ut_check_int(s_filter_num_columns(&filter, 4), 4, "unrestricted - num columns");
+	ut_check_int(s_filter_get_column(&filter, 2), 2, "unrestricted - get column");
+
+	//
+	// Single columns and ranges are sorted and unique. The columns are
+	// created, when the filter is prepared.
+	//
+	ut_check_bool(s_filter_set_columns(&filter, L" 5, 2-3 ,3 "), true);
+	ut_check_bool(s_filter_is_restricted(&filter), true);
+	ut_check_bool(s_filter_is_prepared(&filter), false);
+	ut_check_wchar_str(filter.cols_str, L" 5, 2-3 ,3 ");
+
+	ut_check_bool(s_filter_prepare(&filter, NULL, 8), true);
+	ut_check_int_array(filter.columns, (int[] ) { 1, 2, 4 }, 3, "columns - sorted");
+	ut_check_int(s_filter_num_columns(&filter, 8), 3, "restricted - num columns");
+	ut_check_int(s_filter_get_column(&filter, 1), 2, "restricted - get column");
+
+	ut_check_bool(s_filter_has_column(&filter, 0), false);
+	ut_check_bool(s_filter_has_column(&filter, 2), true);
+	ut_check_bool(s_filter_has_column(&filter, 4), true);
+	ut_check_bool(s_filter_has_column(&filter, 7), false);
+
+	//
+	// Columns that are not part of the table are invalid.
+	//
+	ut_check_bool(s_filter_prepare(&filter, NULL, 4), false);
+	ut_check_bool(s_filter_is_prepared(&filter), false);
+
+	//
+	// Invalid strings leave the filter unchanged.
+	//
+	ut_check_bool(s_filter_set_columns(&filter, L"0"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"a"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"3-2"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"2 3"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"1-2,"), true);
+	ut_check_bool(s_filter_set_columns(&filter, L","), false);
+
+	//
+	// Column numbers, that overflow an int or a long, are invalid.
+	//
+	ut_check_bool(s_filter_set_columns(&filter, L"2147483648"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"4294967296"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"99999999999999999999"), false);
+	ut_check_bool(s_filter_set_columns(&filter, L"1-4294967296"), false);
+	ut_check_wchar_str(filter.cols_str, L"1-2,");
+
+	//
+	// Wide tables can be restricted to any of their columns.
+	//
+	ut_check_bool(s_filter_set_columns(&filter, L"2-20,1500-2000"), true);
+	ut_check_bool(s_filter_prepare(&filter, NULL, 2000), true);
+	ut_check_int(s_filter_num_columns(&filter, 2000), 19 + 501, "wide - num");
+	ut_check_int(s_filter_get_column(&filter, 19 + 500), 1999, "wide - last");
+	ut_check_bool(s_filter_has_column(&filter, 1498), false);
+	ut_check_bool(s_filter_has_column(&filter, 1499), true);
+
+	ut_check_bool(s_filter_set_columns(&filter, L"2000-2147483647"), true);
+	ut_check_bool(s_filter_prepare(&filter, NULL, 2000), false);
+
+	//
+	// An empty string removes the restriction.
+	//
+	ut_check_bool(s_filter_set_columns(&filter, L""), true);
+	ut_check_bool(s_filter_is_restricted(&filter), false);
+	ut_check_bool(s_filter_prepare(&filter, NULL, 4), true);
+
+	s_filter_free(&filter);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks whether a filter is a refinement of an other filter.
+ *****************************************************************************/
+
+static void test_is_refinement() {
+	s_filter old_filter;
+	s_filter new_filter;
+
+	log_debug_str("Start");
+
+	s_filter_set(&old_filter, SF_IS_ACTIVE, L"ell", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	//
+	// The new filter string contains the old filter string.
+	//
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), true);
+
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"el", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	//
+	// The options have to be the same.
+	//
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_SEARCHING);
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	s_filter_set_columns(&new_filter, L"2");
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	//
+	// Regular expressions and inactive filters are no refinements.
+	//
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	new_filter.is_regex = true;
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	s_filter_set_inactive(&old_filter);
+	s_filter_set(&new_filter, SF_IS_ACTIVE, L"Hello", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	ut_check_bool(s_filter_is_refinement(&old_filter, &new_filter), false);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function writes the data to a temp file and checks a multi pattern
+ * filter, which reads the patterns from the file.
+ *****************************************************************************/
+
+static void check_pattern_file(const wchar_t *data, const bool expected, const int no_patterns) {
+	char name[] = "/tmp/ut_filter_XXXXXX";
+	s_filter filter;
+
+	const int fd = mkstemp(name);
+	FILE *file = fd == -1 ? NULL : fdopen(fd, "w");
+
+	if (file == NULL || fputws(data, file) == -1) {
+		log_exit("Unable to write file: %s", name);
+	}
+
+	fclose(file);
+
+	s_filter_init(&filter);
+	filter.is_active = true;
+	filter.is_multi = true;
+	swprintf(filter.str, FILTER_STR_LEN + 1, L"%c%s", FILTER_MULTI_FILE, name);
+
+	ut_check_bool(s_filter_prepare(&filter, NULL, 2), expected);
+
+	if (expected) {
+		ut_check_int(s_aho_no_patterns(filter.aho), no_patterns, "pattern file - patterns");
+	}
+
+	s_filter_free(&filter);
+
+	unlink(name);
+}
+
+/******************************************************************************
+ * The function checks the reading of a pattern file. A line, that is longer
+ * than the maximum, is not split into several patterns. Instead the file is
+ * rejected.
+ *****************************************************************************/
+
+static void test_pattern_file() {
+	wchar_t data[FILTER_MULTI_LINE_LEN + 16];
+
+	log_debug_str("Start");
+
+	check_pattern_file(L"ab\ncd\r\n\nef", true, 3);
+
+	//
+	// A line with the maximum length, with and without a newline.
+	//
+	wmemset(data, L'x', FILTER_MULTI_LINE_LEN);
+	wcscpy(data + FILTER_MULTI_LINE_LEN, L"\nab\n");
+	check_pattern_file(data, true, 2);
+
+	data[FILTER_MULTI_LINE_LEN] = W_STR_TERM;
+	check_pattern_file(data, true, 1);
+
+	//
+	// A line that is too long.
+	//
+	wcscpy(data + FILTER_MULTI_LINE_LEN, L"yy\nab\n");
+	check_pattern_file(data, false, 0);
+
+	log_debug_str("End");
+}
+
 /******************************************************************************
  * The main function simply starts the test.
  *****************************************************************************/
@@ -165,6 +397,12 @@ int main() {
 
 	test_search_str();
 
+	test_set_columns();
+
+	test_is_refinement();
+
+	test_pattern_file();
+
 	log_debug_str("End");
 
 	return EXIT_SUCCESS;
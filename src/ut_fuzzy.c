@@ -0,0 +1,257 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_fuzzy.h"
+
+#include <stdbool.h>
+#include <locale.h>
+
+/******************************************************************************
+ * The function computes the minimal edit distance of the pattern to a
+ * substring of the string with the dynamic programming algorithm of Sellers.
+ * It is used to check the bit-parallel algorithm.
+ *****************************************************************************/
+
+static int sellers(const wchar_t *pattern, const wchar_t *str) {
+	int col[FUZZY_MAX_LEN + 1];
+	int diag, tmp;
+
+	const int len = (int) wcslen(pattern);
+
+	for (int i = 0; i <= len; i++) {
+		col[i] = i;
+	}
+
+	int best = col[len];
+
+	for (const wchar_t *ptr = str; *ptr != W_STR_TERM; ptr++) {
+		diag = col[0];
+		col[0] = 0;
+
+		for (int i = 1; i <= len; i++) {
+			tmp = col[i];
+			col[i] = diag + (pattern[i - 1] == *ptr ? 0 : 1);
+
+			if (col[i - 1] + 1 < col[i]) {
+				col[i] = col[i - 1] + 1;
+			}
+
+			if (tmp + 1 < col[i]) {
+				col[i] = tmp + 1;
+			}
+
+			diag = tmp;
+		}
+
+		if (col[len] < best) {
+			best = col[len];
+		}
+	}
+
+	return best;
+}
+
+/******************************************************************************
+ * The function compiles a pattern and checks whether it matches a string.
+ *****************************************************************************/
+
+static void check_matches(const wchar_t *pattern, const bool case_insensitive, const wchar_t *str, const bool expected) {
+
+	s_fuzzy *fuzzy = s_fuzzy_create(pattern, case_insensitive);
+
+	if (fuzzy == NULL) {
+		log_exit("Unable to compile: %ls", pattern);
+	}
+
+	log_debug("Pattern: '%ls' str: '%ls'", pattern, str);
+
+	ut_check_bool(s_fuzzy_matches(fuzzy, str), expected);
+
+	s_fuzzy_free(fuzzy);
+}
+
+/******************************************************************************
+ * The function compiles a pattern, searches a string from an offset and
+ * checks the position and the length of the match.
+ *****************************************************************************/
+
+static void check_search(const wchar_t *pattern, const wchar_t *str, const size_t offset, const int start, const size_t len) {
+	size_t match_len;
+
+	s_fuzzy *fuzzy = s_fuzzy_create(pattern, false);
+
+	if (fuzzy == NULL) {
+		log_exit("Unable to compile: %ls", pattern);
+	}
+
+	log_debug("Pattern: '%ls' str: '%ls'", pattern, str);
+
+	const wchar_t *ptr = s_fuzzy_search(fuzzy, str, offset, &match_len);
+
+	if (start < 0) {
+		ut_check_wcs_null(ptr, UT_IS_NULL);
+
+	} else {
+		ut_check_int((int) (ptr - str), start, "search - start");
+		ut_check_size(match_len, len, "search - len");
+	}
+
+	s_fuzzy_free(fuzzy);
+}
+
+/******************************************************************************
+ * The function checks the compilation of patterns.
+ *****************************************************************************/
+
+static void test_fuzzy_create() {
+	wchar_t buf[FUZZY_MAX_LEN + 2];
+
+	log_debug_str("Start");
+
+	ut_check_bool(s_fuzzy_create(L"", false) == NULL, true);
+
+	//
+	// The maximal length of the pattern
+	//
+	wmemset(buf, L'a', FUZZY_MAX_LEN + 1);
+	buf[FUZZY_MAX_LEN + 1] = W_STR_TERM;
+	ut_check_bool(s_fuzzy_create(buf, false) == NULL, true);
+
+	buf[FUZZY_MAX_LEN] = W_STR_TERM;
+	s_fuzzy *fuzzy = s_fuzzy_create(buf, false);
+	ut_check_int(s_fuzzy_max_errors(fuzzy), 3, "max errors");
+	s_fuzzy_free(fuzzy);
+
+	//
+	// The number of errors depends on the length.
+	//
+	const wchar_t *patterns[] = { L"abc", L"abcd", L"abcdefg", L"abcdefgh", L"abcdefghijkl", NULL };
+	const int errors[] = { 0, 1, 1, 2, 3 };
+
+	for (int i = 0; patterns[i] != NULL; i++) {
+		fuzzy = s_fuzzy_create(patterns[i], false);
+		ut_check_int(s_fuzzy_max_errors(fuzzy), errors[i], "max errors");
+		s_fuzzy_free(fuzzy);
+	}
+}
+
+/******************************************************************************
+ * The function checks the matching.
+ *****************************************************************************/
+
+static void test_fuzzy_matches() {
+
+	log_debug_str("Start");
+
+	check_matches(L"received", false, L"mail recieved", true);
+	check_matches(L"received", false, L"mail recived", true);
+	check_matches(L"received", false, L"mail recievd", false);
+	check_matches(L"München", false, L"Munchen", true);
+	check_matches(L"München", false, L"munchen", false);
+	check_matches(L"München", true, L"MUNCHEN", true);
+	check_matches(L"hello", false, L"hallo", true);
+	check_matches(L"hello", false, L"help", false);
+	check_matches(L"abc", false, L"xabcx", true);
+	check_matches(L"abc", false, L"xabx", false);
+	check_matches(L"abcd", false, L"", false);
+}
+
+/******************************************************************************
+ * The function checks the bit-parallel algorithm with the dynamic programming
+ * algorithm for generated strings with a small alphabet.
+ *****************************************************************************/
+
+static void test_fuzzy_sellers() {
+	wchar_t pattern[FUZZY_MAX_LEN + 1];
+	wchar_t str[128];
+	unsigned int seed = 42;
+
+	log_debug_str("Start");
+
+	for (int run = 0; run < 2000; run++) {
+
+		const int pattern_len = 1 + rand_r(&seed) % FUZZY_MAX_LEN;
+		const int str_len = rand_r(&seed) % 127;
+
+		for (int i = 0; i < pattern_len; i++) {
+			pattern[i] = L'a' + rand_r(&seed) % 3;
+		}
+		pattern[pattern_len] = W_STR_TERM;
+
+		for (int i = 0; i < str_len; i++) {
+			str[i] = L'a' + rand_r(&seed) % 3;
+		}
+		str[str_len] = W_STR_TERM;
+
+		s_fuzzy *fuzzy = s_fuzzy_create(pattern, false);
+
+		ut_check_bool(s_fuzzy_matches(fuzzy, str), sellers(pattern, str) <= s_fuzzy_max_errors(fuzzy));
+
+		s_fuzzy_free(fuzzy);
+	}
+}
+
+/******************************************************************************
+ * The function checks the searching.
+ *****************************************************************************/
+
+static void test_fuzzy_search() {
+
+	log_debug_str("Start");
+
+	check_search(L"received", L"the recieved mail", 0, 4, 8);
+	check_search(L"received", L"the received mail", 0, 4, 8);
+	check_search(L"München", L"xx Munchen yy Munchen", 0, 3, 7);
+	check_search(L"München", L"xx Munchen yy Munchen", 10, 14, 7);
+	check_search(L"München", L"xx Munchen yy", 10, -1, 0);
+	check_search(L"hello", L"say hallo", 0, 4, 5);
+	check_search(L"hello", L"say help", 0, -1, 0);
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	//
+	// The case insensitive matching of non ASCII chars requires a locale.
+	//
+	setlocale(LC_ALL, "");
+
+	test_fuzzy_create();
+
+	test_fuzzy_matches();
+
+	test_fuzzy_sellers();
+
+	test_fuzzy_search();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
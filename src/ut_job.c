@@ -0,0 +1,412 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ncv_job.h"
+#include "ncv_parser.h"
+#include "ut_utils.h"
+
+#include <locale.h>
+
+/******************************************************************************
+ * The function runs a job and waits until it is finished.
+ *****************************************************************************/
+
+static wchar_t* run_job(s_table *table, s_cursor *cursor, const s_filter *filter, const s_sort *sort, const bool filter_changed, const bool sort_changed) {
+	s_job job;
+
+	s_job_start(&job, table, cursor, filter, sort, filter_changed, sort_changed);
+
+	while (!s_job_wait(&job, 10)) {
+		log_debug_str("Waiting for job.");
+	}
+
+	return s_job_finish(&job, table, cursor);
+}
+
+/******************************************************************************
+ * The function runs a job, that combines the filters, and waits until it is
+ * finished.
+ *****************************************************************************/
+
+static wchar_t* run_combine_job(s_table *table, s_cursor *cursor, const enum e_combine combine) {
+	s_job job;
+
+	s_job_start_combine(&job, table, cursor, combine);
+
+	while (!s_job_wait(&job, 10)) {
+		log_debug_str("Waiting for job.");
+	}
+
+	return s_job_finish(&job, table, cursor);
+}
+
+/******************************************************************************
+ * The function checks that the result of a job is published to the table and
+ * that a cancelled job leaves the table unchanged.
+ *****************************************************************************/
+
+static void test_job() {
+	s_table table;
+	s_cursor cursor;
+	s_filter filter;
+	s_sort sort;
+	s_job job;
+
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"Number" DL "Name" NL
+	L"3" DL "ccxx" NL
+	L"1" DL "aaaa" NL
+	L"2" DL "bbxx" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	s_cursor_set(&cursor, 0, 0, true);
+
+	//
+	// Filter with a regex. The table is unchanged until the job finished.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"x+$", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	filter.is_regex = true;
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+
+	ut_check_bool(table.filter.is_active, true);
+	ut_check_int(table.filter.count, 2, "filter - count");
+	ut_check_table_column(&table, 1, 3, (const wchar_t*[] ) { L"Name", L"ccxx", L"bbxx" });
+	ut_check_int(cursor.row, 1, "filter - cursor row");
+	ut_check_int(cursor.col, 1, "filter - cursor col");
+
+	//
+	// Sort the filtered table. The regex of the filter is compiled by the job.
+	//
+	sort = table.sort;
+	s_sort_update(&sort, 0, E_DIR_FORWARD);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &table.filter, &sort, false, true), UT_IS_NULL);
+
+	ut_check_table_column(&table, 1, 3, (const wchar_t*[] ) { L"Name", L"bbxx", L"ccxx" });
+	ut_check_int(table.filter.count, 2, "sort - count");
+
+	//
+	// A cancelled job does not change the table.
+	//
+	filter = table.filter;
+	s_filter_set_inactive(&filter);
+
+	s_job_start(&job, &table, &cursor, &filter, &table.sort, true, false);
+	s_job_cancel(&job);
+
+	ut_check_wcs_null(s_job_finish(&job, &table, &cursor), UT_IS_NOT_NULL);
+
+	ut_check_bool(table.filter.is_active, true);
+	ut_check_table_column(&table, 1, 3, (const wchar_t*[] ) { L"Name", L"bbxx", L"ccxx" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that a job with a refined filter, only filters the rows
+ * of the current view and preserves the sorting.
+ *****************************************************************************/
+
+static void test_job_refine() {
+	s_table table;
+	s_cursor cursor;
+	s_filter filter;
+	s_sort sort;
+
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"Number" DL "Name" NL
+	L"1" DL "abc" NL
+	L"2" DL "bcd" NL
+	L"3" DL "abx" NL
+	L"4" DL "xyz" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	s_cursor_set(&cursor, 0, 0, true);
+
+	//
+	// Filter and sort the table backward.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"b", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	sort = table.sort;
+	s_sort_update(&sort, 0, E_DIR_BACKWARD);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &sort, true, true), UT_IS_NULL);
+	ut_check_table_column(&table, 0, 4, (const wchar_t*[] ) { L"Number", L"3", L"2", L"1" });
+
+	//
+	// Extend the filter string, which is a refinement.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"ab", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_bool(s_filter_is_refinement(&table.filter, &filter), true);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+	ut_check_table_column(&table, 0, 3, (const wchar_t*[] ) { L"Number", L"3", L"1" });
+	ut_check_int(table.filter.count, 2, "refine - count");
+	ut_check_int(cursor.row, 1, "refine - cursor row");
+
+	//
+	// A refinement without a match resets the table.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"abz", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NOT_NULL);
+	ut_check_bool(table.filter.is_active, false);
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"Number", L"4", L"3", L"2", L"1" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that a search with a match limit stops after the first
+ * matching row and that the count job indexes the remaining matches, without
+ * changing the cursor.
+ *****************************************************************************/
+
+static void test_job_count() {
+	s_table table;
+	s_cursor cursor;
+	s_filter filter;
+	s_job job;
+
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"Number" DL "Name" NL
+	L"1" DL "aaaa" NL
+	L"2" DL "bbxx" NL
+	L"3" DL "xxxx" NL
+	L"4" DL "ccxx" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	s_cursor_set(&cursor, 0, 0, true);
+
+	table.match_limit = 1;
+
+	//
+	// The search stops with the first matching row.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"xx", SF_IS_SENSITIVE, SF_IS_SEARCHING);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+	ut_check_bool(table.is_counting, true);
+	ut_check_int(table.filter.count, 1, "search - count");
+	ut_check_int(cursor.row, 2, "search - cursor row");
+
+	//
+	// The count job indexes all matches.
+	//
+	s_cursor_pos(&cursor, 4, 0);
+
+	s_job_start_count(&job, &table, &cursor);
+
+	while (!s_job_wait(&job, 10)) {
+		log_debug_str("Waiting for job.");
+	}
+
+	ut_check_int(atomic_load(&job.progress.found), 3, "count - found");
+	ut_check_wcs_null(s_job_finish(&job, &table, &cursor), UT_IS_NULL);
+
+	ut_check_bool(table.is_counting, false);
+	ut_check_int(table.filter.count, 3, "count - count");
+	ut_check_int(table.matches[2].row, 4, "count - last match");
+	ut_check_int(cursor.row, 4, "count - cursor row");
+
+	//
+	// A filter indexes all matches.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"xx", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+	ut_check_bool(table.is_counting, false);
+	ut_check_int(table.filter.count, 3, "filter - count");
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that a job combines the view of the filter with the
+ * rows of the previous filter and that a failed or cancelled combination
+ * leaves the table unchanged.
+ *****************************************************************************/
+
+static void test_job_combine() {
+	s_table table;
+	s_cursor cursor;
+	s_filter filter;
+	s_job job;
+
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"Number" DL "Name" NL
+	L"1" DL "aazz" NL
+	L"2" DL "bbxx" NL
+	L"3" DL "ccyy" NL
+	L"4" DL "ddxx" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	s_cursor_set(&cursor, 0, 0, true);
+
+	//
+	// The results of the two filters are cached.
+	//
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"zz", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+
+	filter = table.filter;
+	s_filter_set(&filter, SF_IS_ACTIVE, L"xx", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_wcs_null(run_job(&table, &cursor, &filter, &table.sort, true, false), UT_IS_NULL);
+	ut_check_table_column(&table, 0, 3, (const wchar_t*[] ) { L"Number", L"2", L"4" });
+
+	//
+	// AND has no rows left, so the table is unchanged.
+	//
+	ut_check_wcs_null(run_combine_job(&table, &cursor, E_COMBINE_AND), UT_IS_NOT_NULL);
+	ut_check_bool(s_table_is_combined(&table), false);
+	ut_check_table_column(&table, 0, 3, (const wchar_t*[] ) { L"Number", L"2", L"4" });
+
+	//
+	// OR has the rows of both filters. The job compiles the filter and
+	// indexes the matches of the current filter.
+	//
+	ut_check_wcs_null(run_combine_job(&table, &cursor, E_COMBINE_OR), UT_IS_NULL);
+	ut_check_bool(s_table_is_combined(&table), true);
+	ut_check_table_column(&table, 0, 4, (const wchar_t*[] ) { L"Number", L"1", L"2", L"4" });
+	ut_check_int(table.filter.count, 2, "combine or - count");
+	ut_check_int(cursor.row, 2, "combine or - cursor row");
+
+	//
+	// A cancelled combination does not change the table.
+	//
+	s_job_start_combine(&job, &table, &cursor, E_COMBINE_NOT);
+	s_job_cancel(&job);
+
+	ut_check_wcs_null(s_job_finish(&job, &table, &cursor), UT_IS_NOT_NULL);
+	ut_check_bool(s_table_is_combined(&table), true);
+	ut_check_table_column(&table, 0, 4, (const wchar_t*[] ) { L"Number", L"1", L"2", L"4" });
+
+	//
+	// NOT has the rows, that are not in the view.
+	//
+	ut_check_wcs_null(run_combine_job(&table, &cursor, E_COMBINE_NOT), UT_IS_NULL);
+	ut_check_table_column(&table, 0, 2, (const wchar_t*[] ) { L"Number", L"3" });
+	ut_check_int(table.filter.count, 0, "combine not - count");
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	setlocale(LC_ALL, "C");
+
+	test_job();
+
+	test_job_refine();
+
+	test_job_count();
+
+	test_job_combine();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
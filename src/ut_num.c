@@ -0,0 +1,314 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_num.h"
+
+#include <stdbool.h>
+#include <math.h>
+#include <string.h>
+
+/******************************************************************************
+ * The function checks the parsing of a column. The rows have one column.
+ *****************************************************************************/
+
+static void test_num_column_parse() {
+	s_num_column column;
+
+	log_debug_str("Start");
+
+	wchar_t *data[] = { L"1", L"", L"abc", L"2.5 Euro", L"1e999", L" -3 " };
+	wchar_t *rows_data[6][1];
+	wchar_t **rows[6];
+
+	for (int i = 0; i < 6; i++) {
+		rows_data[i][0] = data[i];
+		rows[i] = rows_data[i];
+	}
+
+	s_num_column_init(&column);
+
+	ut_check_bool(s_num_column_parse(&column, rows, 6, 0, NULL), true);
+	ut_check_bool(column.is_parsed, true);
+
+	//
+	// The valid and the empty fields
+	//
+	const bool valid[] = { true, false, false, true, false, true };
+	const bool empty[] = { false, true, false, false, false, false };
+
+	for (int i = 0; i < 6; i++) {
+		ut_check_bool(s_num_bit(column.valid, i), valid[i]);
+		ut_check_bool(s_num_bit(column.empty, i), empty[i]);
+		ut_check_bool(isnan(column.values[i]), !valid[i]);
+	}
+
+	ut_check_double(column.values[0], 1.0, "parse - value");
+	ut_check_double(column.values[3], 2.5, "parse - value");
+	ut_check_double(column.values[5], -3.0, "parse - value");
+
+	ut_check_wchar_str(column.suffixes[0], L"");
+	ut_check_wchar_str(column.suffixes[3], L" Euro");
+	ut_check_wchar_str(column.suffixes[5], L" ");
+
+	ut_check_int(column.type, E_NUM_TYPE_STR, "parse - type");
+
+	s_num_column_free(&column);
+	ut_check_bool(column.is_parsed, false);
+}
+
+/******************************************************************************
+ * The function checks the parsing of a number, which has to be identical to
+ * the result of wcstod.
+ *****************************************************************************/
+
+static void check_num_parse(const wchar_t *str) {
+	const wchar_t *suffix;
+	wchar_t *tailptr;
+	double value;
+
+	const double expected = wcstod(str, &tailptr);
+
+	ut_check_bool(s_num_parse(str, &value, &suffix), true);
+	ut_check_bool(memcmp(&value, &expected, sizeof(double)) == 0, true);
+	ut_check_bool(suffix == tailptr, true);
+}
+
+static void test_num_parse() {
+	const wchar_t *suffix;
+	wchar_t buf[32];
+	double value;
+
+	log_debug_str("Start");
+
+	//
+	// Numbers for the fast parser and for wcstod.
+	//
+	const wchar_t *data[] = { L"0", L"-0", L"+12", L"007", L"3.25", L"-.5", L"1.", L"0.1", L"2.5 Euro", L"9007199254740992",
+			L"9007199254740993", L"123456789012345678901", L"0.0000000000000000000001", L"1e10", L"1E-3x", L"0x1A", L" -3 ",
+			L"inf", L"12abc", L"1.7976931348623157e308" };
+
+	for (size_t i = 0; i < sizeof(data) / sizeof(data[0]); i++) {
+		check_num_parse(data[i]);
+	}
+
+	//
+	// Pseudo random decimals
+	//
+	unsigned int seed = 1;
+
+	for (int i = 0; i < 10000; i++) {
+		seed = seed * 1103515245 + 12345;
+		const unsigned int high = seed >> 8;
+		seed = seed * 1103515245 + 12345;
+
+		swprintf(buf, 32, L"%u.%0*u", high, (int) (seed % 9) + 1, (seed >> 8) % 1000000000);
+		check_num_parse(buf);
+	}
+
+	//
+	// Strings that are not numbers.
+	//
+	ut_check_bool(s_num_parse(L"abc", &value, &suffix), false);
+	ut_check_bool(s_num_parse(L"-", &value, &suffix), false);
+	ut_check_bool(s_num_parse(L".", &value, &suffix), false);
+	ut_check_bool(s_num_parse(L"1e999", &value, &suffix), false);
+
+	//
+	// A decimal comma
+	//
+	ut_check_bool(s_num_parse_dec(L"1000,25 Euro", L',', &value, &suffix), true);
+	ut_check_double(value, 1000.25, "parse - decimal comma");
+	ut_check_wchar_str(suffix, L" Euro");
+}
+
+/******************************************************************************
+ * The function parses a column with a header and checks the inferred type.
+ *****************************************************************************/
+
+static void check_num_type(wchar_t **data, const int no_rows, const enum e_num_type type, const bool first_has_type) {
+	s_num_column column;
+	wchar_t *rows_data[no_rows][1];
+	wchar_t **rows[no_rows];
+
+	for (int i = 0; i < no_rows; i++) {
+		rows_data[i][0] = data[i];
+		rows[i] = rows_data[i];
+	}
+
+	s_num_column_init(&column);
+
+	ut_check_bool(s_num_column_parse(&column, rows, no_rows, 0, NULL), true);
+	ut_check_int(column.type, type, "type - type");
+	ut_check_bool(column.first_has_type, first_has_type);
+
+	s_num_column_free(&column);
+}
+
+static void test_num_type() {
+
+	log_debug_str("Start");
+
+	check_num_type((wchar_t*[] ) { L"count", L"1", L"", L"-20" }, 4, E_NUM_TYPE_INT, false);
+	check_num_type((wchar_t*[] ) { L"7", L"1", L"", L"-20" }, 4, E_NUM_TYPE_INT, true);
+	check_num_type((wchar_t*[] ) { L"7.5", L"1", L"-20" }, 3, E_NUM_TYPE_INT, false);
+	check_num_type((wchar_t*[] ) { L"price", L"1.5 Euro", L"2 Euro" }, 3, E_NUM_TYPE_FLOAT, false);
+	check_num_type((wchar_t*[] ) { L"3 Euro", L"1.5 Euro", L"2 Euro" }, 3, E_NUM_TYPE_FLOAT, true);
+	check_num_type((wchar_t*[] ) { L"3", L"1.5 Euro", L"2 Euro" }, 3, E_NUM_TYPE_FLOAT, false);
+	check_num_type((wchar_t*[] ) { L"price", L"1.5 Euro", L"2 Dollar" }, 3, E_NUM_TYPE_STR, true);
+	check_num_type((wchar_t*[] ) { L"active", L"true", L"FALSE" }, 3, E_NUM_TYPE_BOOL, false);
+	check_num_type((wchar_t*[] ) { L"active", L"true", L"1" }, 3, E_NUM_TYPE_STR, true);
+	check_num_type((wchar_t*[] ) { L"name", L"abc", L"1" }, 3, E_NUM_TYPE_STR, true);
+	check_num_type((wchar_t*[] ) { L"empty", L"", L"" }, 3, E_NUM_TYPE_STR, true);
+}
+
+/******************************************************************************
+ * The function checks a date column, where the only month first date is not
+ * part of the sample of the date detection. The format is narrowed to month
+ * first, instead of parsing the column as strings.
+ *****************************************************************************/
+
+#define NO_DATE_ROWS 1000
+
+static void test_num_date_narrow() {
+	s_num_column column;
+	wchar_t buf[NO_DATE_ROWS][16];
+	wchar_t *rows_data[NO_DATE_ROWS][1];
+	wchar_t **rows[NO_DATE_ROWS];
+
+	log_debug_str("Start");
+
+	for (int i = 0; i < NO_DATE_ROWS; i++) {
+		swprintf(buf[i], 16, L"%02d/%02d/2026", i % 12 + 1, i % 12 + 1);
+		rows_data[i][0] = buf[i];
+		rows[i] = rows_data[i];
+	}
+
+	wcscpy(buf[0], L"date");
+	wcscpy(buf[2], L"10/13/2026");
+
+	s_num_column_init(&column);
+
+	ut_check_bool(s_num_column_parse(&column, rows, NO_DATE_ROWS, 0, NULL), true);
+	ut_check_int(column.type, E_NUM_TYPE_DATE, "date narrow - type");
+	ut_check_int(column.date_fmt.order, E_DATE_MDY, "date narrow - order");
+	ut_check_bool(column.first_has_type, false);
+
+	ut_check_double(column.values[2], (double) s_date_epoch(2026, 10, 13, 0, 0, 0), "date narrow - value");
+	ut_check_double(column.values[3], (double) s_date_epoch(2026, 4, 4, 0, 0, 0), "date narrow - value");
+
+	s_num_column_free(&column);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the bitmaps of the ranges with more than 64 rows.
+ *****************************************************************************/
+
+#define NO_ROWS 130
+
+static void check_range(const s_num_column *column, const double min, const bool min_incl, const double max, const bool max_incl) {
+	s_num_range range;
+
+	s_num_range_init(&range, 0, min, min_incl, max, max_incl);
+	s_num_range_apply(&range, column, NO_ROWS);
+
+	for (int i = 0; i < NO_ROWS; i++) {
+		ut_check_bool(s_num_bit(range.bitmap, i), s_num_range_matches(&range, column->values[i]));
+	}
+
+	s_num_range_free(&range);
+}
+
+static void test_num_range() {
+	s_num_column column;
+	wchar_t buf[NO_ROWS][8];
+	wchar_t *rows_data[NO_ROWS][1];
+	wchar_t **rows[NO_ROWS];
+
+	log_debug_str("Start");
+
+	//
+	// Every 7th field is not a number.
+	//
+	for (int i = 0; i < NO_ROWS; i++) {
+
+		if (i % 7 == 0) {
+			swprintf(buf[i], 8, L"n/a");
+		} else {
+			swprintf(buf[i], 8, L"%d", i);
+		}
+
+		rows_data[i][0] = buf[i];
+		rows[i] = rows_data[i];
+	}
+
+	s_num_column_init(&column);
+	s_num_column_parse(&column, rows, NO_ROWS, 0, NULL);
+
+	check_range(&column, 10, true, 100, true);
+	check_range(&column, 10, false, 100, false);
+	check_range(&column, -INFINITY, true, 64, false);
+	check_range(&column, 64, true, INFINITY, true);
+
+	//
+	// Check some bits directly.
+	//
+	s_num_range range;
+	s_num_range_init(&range, 0, 63, false, 65, true);
+	s_num_range_apply(&range, &column, NO_ROWS);
+
+	ut_check_bool(s_num_bit(range.bitmap, 63), false);
+	ut_check_bool(s_num_bit(range.bitmap, 64), true);
+	ut_check_bool(s_num_bit(range.bitmap, 65), true);
+	ut_check_bool(s_num_bit(range.bitmap, 66), false);
+
+	s_num_range_free(&range);
+
+	s_num_column_free(&column);
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_num_column_parse();
+
+	test_num_parse();
+
+	test_num_type();
+
+	test_num_date_narrow();
+
+	test_num_range();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -201,6 +201,65 @@ static void test_add_remove() {
 	log_debug_str("End");
 }
 
+/******************************************************************************
+ * The function parses a csv file with sampling. If the sample is larger than
+ * the file, all rows are part of the table. The first column has the numbers
+ * of the rows.
+ *****************************************************************************/
+
+static void test_parser_sample() {
+	s_table table;
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"id" DL "name" NL
+	L"1" DL EC"a,a"EC NL
+	L"2" NL
+	L"3" DL "cc" DL "" NL
+	L"4" DL "dd" NL;
+
+	s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = true, .strict = false, .sample = 10 };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	ut_check_int(table.no_columns, 3, "sample all - no cols");
+	ut_check_int(table.no_rows, 5, "sample all - no rows");
+
+	ut_check_table_row(&table, 0, 3, (const wchar_t*[] ) { L"1", L"id", L"name" });
+	ut_check_table_row(&table, 1, 3, (const wchar_t*[] ) { L"2", L"1", L"a,a" });
+	ut_check_table_row(&table, 2, 3, (const wchar_t*[] ) { L"3", L"2", L"" });
+	ut_check_table_row(&table, 4, 3, (const wchar_t*[] ) { L"5", L"4", L"dd" });
+
+	s_table_free(&table);
+
+	//
+	// A smaller sample has the first row and rows in the order of the file.
+	//
+	rewind(tmp);
+	cfg_parser.sample = 2;
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	ut_check_int(table.no_rows, 3, "sample - no rows");
+	ut_check_wchar_str(table.__fields[0][1], L"id");
+	ut_check_bool(wcstol(table.__fields[1][0], NULL, 10) < wcstol(table.__fields[2][0], NULL, 10), true);
+
+	for (int row = 1; row < table.no_rows; row++) {
+		ut_check_int((int) wcstol(table.__fields[row][1], NULL, 10), (int) wcstol(table.__fields[row][0], NULL, 10) - 1, "sample - row number");
+	}
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
 /******************************************************************************
  * The main function simply starts the test.
  *****************************************************************************/
@@ -219,6 +278,8 @@ int main() {
 
 	test_add_remove();
 
+	test_parser_sample();
+
 	log_debug_str("End");
 
 	return EXIT_SUCCESS;
@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_psort.h"
+
+#include <string.h>
+
+/******************************************************************************
+ * The elements of the tests have a key with many duplicates and an index, so
+ * the comparison is a total order.
+ *****************************************************************************/
+
+typedef struct s_elem {
+
+	int key;
+
+	int idx;
+
+} s_elem;
+
+/******************************************************************************
+ * The comparison function of the elements. The argument is not used.
+ *****************************************************************************/
+
+static int compare_elem(const void *ptr_1, const void *ptr_2, void *arg) {
+
+	const s_elem *elem_1 = (const s_elem*) ptr_1;
+	const s_elem *elem_2 = (const s_elem*) ptr_2;
+
+	(void) arg;
+
+	if (elem_1->key != elem_2->key) {
+		return elem_1->key < elem_2->key ? -1 : 1;
+	}
+
+	return elem_1->idx < elem_2->idx ? -1 : elem_1->idx > elem_2->idx;
+}
+
+/******************************************************************************
+ * The function sorts an array of elements with the parallel sort and checks,
+ * that the result is identical to the result of qsort_r.
+ *****************************************************************************/
+
+static void check_psort(const int no_elems, const int no_threads) {
+
+	s_elem *elems = xmalloc(sizeof(s_elem) * no_elems);
+	s_elem *expected = xmalloc(sizeof(s_elem) * no_elems);
+
+	unsigned int seed = 4711;
+
+	for (int i = 0; i < no_elems; i++) {
+		seed = seed * 1103515245 + 12345;
+		elems[i] = (s_elem ) { .key = (seed >> 16) % 1000, .idx = i };
+	}
+
+	memcpy(expected, elems, sizeof(s_elem) * no_elems);
+
+	qsort_r(expected, no_elems, sizeof(s_elem), compare_elem, NULL);
+
+	psort_r(elems, no_elems, sizeof(s_elem), compare_elem, NULL, no_threads);
+
+	ut_check_bool(memcmp(elems, expected, sizeof(s_elem) * no_elems) == 0, true);
+
+	free(elems);
+	free(expected);
+}
+
+/******************************************************************************
+ * The function checks the parallel sort with different numbers of elements
+ * and threads. Small arrays are sorted by the calling thread.
+ *****************************************************************************/
+
+static void test_psort() {
+
+	log_debug_str("Start");
+
+	check_psort(0, 4);
+
+	check_psort(100, 4);
+
+	check_psort(PSORT_MIN_RUN * 2, 1);
+
+	check_psort(PSORT_MIN_RUN * 2, 2);
+
+	check_psort(PSORT_MIN_RUN * 7 + 13, 7);
+
+	check_psort(PSORT_MIN_RUN * 5 + 1, 3);
+
+	check_psort(PSORT_MIN_RUN * 16, 16);
+
+	ut_check_bool(psort_threads() >= 1, true);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_psort();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_regex.h"
+
+#include <stdbool.h>
+#include <locale.h>
+
+/******************************************************************************
+ * The function compiles a pattern and checks whether it matches a string.
+ *****************************************************************************/
+
+static void check_matches(const wchar_t *pattern, const bool case_insensitive, const wchar_t *str, const bool expected) {
+
+	s_regex *regex = s_regex_create(pattern, case_insensitive);
+
+	if (regex == NULL) {
+		log_exit("Unable to compile: %ls", pattern);
+	}
+
+	log_debug("Pattern: '%ls' str: '%ls'", pattern, str);
+
+	ut_check_bool(s_regex_matches(regex, str), expected);
+
+	//
+	// Matching twice uses the cached DFA states.
+	//
+	ut_check_bool(s_regex_matches(regex, str), expected);
+
+	s_regex_free(regex);
+}
+
+/******************************************************************************
+ * The function compiles a pattern, searches a string from an offset and
+ * checks the position and the length of the match.
+ *****************************************************************************/
+
+static void check_search(const wchar_t *pattern, const wchar_t *str, const size_t offset, const int start, const size_t len) {
+	size_t match_len;
+
+	s_regex *regex = s_regex_create(pattern, false);
+
+	if (regex == NULL) {
+		log_exit("Unable to compile: %ls", pattern);
+	}
+
+	log_debug("Pattern: '%ls' str: '%ls'", pattern, str);
+
+	const wchar_t *ptr = s_regex_search(regex, str, offset, &match_len);
+
+	if (start < 0) {
+		ut_check_wcs_null(ptr, UT_IS_NULL);
+
+	} else {
+		ut_check_int((int) (ptr - str), start, "search - start");
+		ut_check_size(match_len, len, "search - len");
+	}
+
+	s_regex_free(regex);
+}
+
+/******************************************************************************
+ * The function checks the compilation of valid and invalid patterns.
+ *****************************************************************************/
+
+static void test_regex_create() {
+
+	log_debug_str("Start");
+
+	const wchar_t *invalid[] = { L"(ab", L"ab)", L"[ab", L"*a", L"a{2,1}", L"a{1000}", L"ab\\", L"[z-a]", L"a{2", L"(((((((((((((((((((((((((((((((((a)))))))))))))))))))))))))))))))))", L"(a{100}){100}", NULL };
+
+	for (int i = 0; invalid[i] != NULL; i++) {
+		log_debug("Invalid: %ls", invalid[i]);
+		ut_check_bool(s_regex_create(invalid[i], false) == NULL, true);
+	}
+
+	const wchar_t *valid[] = { L"", L"a|", L"()", L"[]a]", L"[a-]", L"a{2,}", L"\\d+\\.\\d*", L"(a*)*", NULL };
+
+	for (int i = 0; valid[i] != NULL; i++) {
+		log_debug("Valid: %ls", valid[i]);
+		s_regex *regex = s_regex_create(valid[i], false);
+		ut_check_bool(regex != NULL, true);
+		s_regex_free(regex);
+	}
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the matching with the lazy DFA.
+ *****************************************************************************/
+
+static void test_regex_matches() {
+
+	log_debug_str("Start");
+
+	//
+	// Literals, any chars and classes
+	//
+	check_matches(L"ell", false, L"Hello", true);
+	check_matches(L"elo", false, L"Hello", false);
+	check_matches(L"H.l", false, L"Hello", true);
+	check_matches(L"a.b", false, L"a\nb", false);
+	check_matches(L"[0-9]+-[0-9]+", false, L"id: 12-34", true);
+	check_matches(L"[^a-z]", false, L"hello", false);
+	check_matches(L"\\d\\s\\w", false, L"x1 _", true);
+	check_matches(L"\\D", false, L"123", false);
+	check_matches(L"a\\.b", false, L"axb", false);
+
+	//
+	// Anchors
+	//
+	check_matches(L"^Hel", false, L"Hello", true);
+	check_matches(L"^ell", false, L"Hello", false);
+	check_matches(L"llo$", false, L"Hello", true);
+	check_matches(L"ell$", false, L"Hello", false);
+	check_matches(L"^$", false, L"", true);
+	check_matches(L"^$", false, L"a", false);
+	check_matches(L"^(a|b)*$", false, L"abba", true);
+	check_matches(L"^(a|b)*$", false, L"abca", false);
+
+	//
+	// Repetitions
+	//
+	check_matches(L"^a{2,3}$", false, L"a", false);
+	check_matches(L"^a{2,3}$", false, L"aaa", true);
+	check_matches(L"^a{2,3}$", false, L"aaaa", false);
+	check_matches(L"^a{2,}$", false, L"aaaaaa", true);
+	check_matches(L"^ab?c$", false, L"ac", true);
+	check_matches(L"FAIL|ERROR", false, L"status: ERROR", true);
+
+	//
+	// Case insensitive
+	//
+	check_matches(L"hello", true, L"HeLLo", true);
+	check_matches(L"HELLO", true, L"hello", true);
+	check_matches(L"[A-Z]+", true, L"abc", true);
+	check_matches(L"[a-z]", false, L"ABC", false);
+	check_matches(L"Ä", true, L"ä", true);
+
+	//
+	// Pathological pattern for backtracking engines.
+	//
+	check_matches(L"^(a+)+$", false, L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab", false);
+	check_matches(L"(a|aa)*c", false, L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", false);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the leftmost longest search.
+ *****************************************************************************/
+
+static void test_regex_search() {
+
+	log_debug_str("Start");
+
+	check_search(L"b+", L"abbbc", 0, 1, 3);
+	check_search(L"x", L"abbbc", 0, -1, 0);
+	check_search(L"a|ab", L"xabc", 0, 1, 2);
+	check_search(L"b*", L"abc", 0, 0, 0);
+	check_search(L"c$", L"cac", 0, 2, 1);
+
+	//
+	// Searching from an offset: ^ only matches at the start of the string.
+	//
+	check_search(L"a", L"aaa", 1, 1, 1);
+	check_search(L"^a", L"aaa", 1, -1, 0);
+	check_search(L"[0-9]+", L"12 345", 2, 3, 3);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	//
+	// The case insensitive matching of non ASCII chars requires a locale.
+	//
+	setlocale(LC_ALL, "");
+
+	test_regex_create();
+
+	test_regex_matches();
+
+	test_regex_search();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_sample.h"
+
+#include <stdbool.h>
+
+/******************************************************************************
+ * The number of rows of the stream, the size of the sample and the number of
+ * runs of the uniformity test.
+ *****************************************************************************/
+
+#define NO_ROWS 100
+
+#define SAMPLE_SIZE 10
+
+#define NO_RUNS 4000
+
+/******************************************************************************
+ * The function streams rows with one field, which is the number of the row,
+ * through a sample.
+ *****************************************************************************/
+
+static void stream_rows(s_sample *sample, const int no_rows) {
+	wchar_t buf[32];
+
+	for (int row = 1; row <= no_rows; row++) {
+		swprintf(buf, 32, L"%d", row);
+
+		s_sample_start_row(sample);
+		s_sample_add_field(sample, buf);
+	}
+}
+
+/******************************************************************************
+ * The function checks that the sample keeps the first row and the rows in the
+ * order of the stream.
+ *****************************************************************************/
+
+static void test_sample_rows() {
+	s_sample sample;
+
+	log_debug_str("Start");
+
+	//
+	// A stream with less rows than the size of the sample.
+	//
+	s_sample_init(&sample, SAMPLE_SIZE, 42);
+	stream_rows(&sample, 5);
+
+	ut_check_int(sample.no_rows, 4, "rows - small");
+	ut_check_wchar_str(sample.first.fields[0], L"1");
+	ut_check_wchar_str(sample.rows[3].fields[0], L"5");
+
+	s_sample_free(&sample);
+
+	//
+	// A stream with more rows, the fields match the numbers of the rows.
+	//
+	s_sample_init(&sample, SAMPLE_SIZE, 42);
+	stream_rows(&sample, NO_ROWS);
+	s_sample_sort(&sample);
+
+	ut_check_int(sample.no_rows, SAMPLE_SIZE, "rows - large");
+	ut_check_int(sample.first.number, 1, "rows - first");
+
+	for (int i = 0; i < SAMPLE_SIZE; i++) {
+		ut_check_int((int) wcstol(sample.rows[i].fields[0], NULL, 10), (int) sample.rows[i].number, "rows - number");
+
+		if (i > 0) {
+			ut_check_bool(sample.rows[i - 1].number < sample.rows[i].number, true);
+		}
+	}
+
+	s_sample_free(&sample);
+}
+
+/******************************************************************************
+ * The function checks that each row has the same probability to be part of
+ * the sample. The expected count of a row is: NO_RUNS * SAMPLE_SIZE / 99,
+ * which is about 404. A deviation of 25% is far beyond the variance.
+ *****************************************************************************/
+
+static void test_sample_uniform() {
+	s_sample sample;
+	int counts[NO_ROWS + 1] = { 0 };
+
+	log_debug_str("Start");
+
+	for (int run = 0; run < NO_RUNS; run++) {
+		s_sample_init(&sample, SAMPLE_SIZE, 1 + run * 7919);
+		stream_rows(&sample, NO_ROWS);
+
+		for (int i = 0; i < sample.no_rows; i++) {
+			counts[sample.rows[i].number]++;
+		}
+
+		s_sample_free(&sample);
+	}
+
+	const int expected = NO_RUNS * SAMPLE_SIZE / (NO_ROWS - 1);
+
+	for (int row = 2; row <= NO_ROWS; row++) {
+
+		if (counts[row] < expected * 3 / 4 || counts[row] > expected * 5 / 4) {
+			log_exit("Row: %d count: %d expected: %d", row, counts[row], expected);
+		}
+	}
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	test_sample_rows();
+
+	test_sample_uniform();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -63,6 +63,62 @@ static void test_sort_update() {
 	log_debug_str("End");
 }
 
+/******************************************************************************
+ * The function checks the adding and removing of sort keys.
+ *****************************************************************************/
+
+static void test_sort_add_key() {
+	s_sort sort;
+
+	log_debug_str("Start");
+
+	//
+	// Adding to an inactive sorting
+	//
+	s_sort_set_inactive(&sort, true);
+	ut_check_bool(s_sort_add_key(&sort, 2, E_DIR_FORWARD), true);
+	ut_check_int(sort.no_keys, 1, "first");
+	ut_check_int(s_sort_key_idx(&sort, 2), 0, "first idx");
+
+	//
+	// Add keys up to the maximum
+	//
+	for (int col = 3; col < 2 + SORT_MAX_KEYS; col++) {
+		ut_check_bool(s_sort_add_key(&sort, col, E_DIR_BACKWARD), true);
+	}
+
+	ut_check_int(sort.no_keys, SORT_MAX_KEYS, "max");
+	ut_check_bool(s_sort_add_key(&sort, 0, E_DIR_FORWARD), false);
+
+	//
+	// Change the direction and remove a key
+	//
+	ut_check_bool(s_sort_add_key(&sort, 3, E_DIR_FORWARD), true);
+	ut_check_int(sort.keys[1].direction, E_DIR_FORWARD, "direction");
+
+	ut_check_bool(s_sort_add_key(&sort, 3, E_DIR_FORWARD), true);
+	ut_check_int(sort.no_keys, SORT_MAX_KEYS - 1, "removed");
+	ut_check_int(s_sort_key_idx(&sort, 3), -1, "removed idx");
+	ut_check_int(s_sort_key_idx(&sort, 4), 1, "moved idx");
+
+	//
+	// The type is kept, if the column is set as the only key.
+	//
+	ut_check_bool(s_sort_toggle_type(&sort, 4), true);
+	ut_check_bool(s_sort_toggle_type(&sort, 0), false);
+	ut_check_bool(s_sort_update(&sort, 4, E_DIR_FORWARD), true);
+	ut_check_int(sort.no_keys, 1, "update");
+	ut_check_int(sort.keys[0].type, E_SORT_STR, "type");
+
+	//
+	// Removing the last key deactivates the sorting.
+	//
+	ut_check_bool(s_sort_add_key(&sort, 4, E_DIR_FORWARD), true);
+	ut_check_bool(s_sort_is_active(&sort), false);
+
+	log_debug_str("End");
+}
+
 /******************************************************************************
  * The main function simply starts the test.
  *****************************************************************************/
@@ -73,6 +129,8 @@ int main() {
 
 	test_sort_update();
 
+	test_sort_add_key();
+
 	log_debug_str("End");
 
 	return EXIT_SUCCESS;
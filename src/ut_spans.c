@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_spans.h"
+
+#include <locale.h>
+
+/******************************************************************************
+ * The function checks the spans of a cache entry. The expected spans are given
+ * as an array of line, start and len triples.
+ *****************************************************************************/
+
+static void check_spans(const s_spans_entry *entry, const int expected[], const int count) {
+
+	ut_check_int(entry->count, count, "spans - count");
+
+	for (int i = 0; i < count; i++) {
+		ut_check_int(entry->spans[i].line, expected[3 * i], "spans - line");
+		ut_check_int(entry->spans[i].start, expected[3 * i + 1], "spans - start");
+		ut_check_int(entry->spans[i].len, expected[3 * i + 2], "spans - len");
+	}
+}
+
+/******************************************************************************
+ * The function checks the computation of the spans for plain and regex
+ * filters.
+ *****************************************************************************/
+
+static void test_spans_compute() {
+	s_spans_cache cache;
+	s_filter filter;
+
+	log_debug_str("Start");
+
+	s_spans_cache_init(&cache);
+	s_filter_init(&filter);
+
+	//
+	// Plain filter with matches on several lines.
+	//
+	s_filter_set(&filter, SF_IS_ACTIVE, L"ab", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+
+	check_spans(s_spans_cache_get(&cache, 0, L"xxab\nAB\n\naxbab", &filter), (int[] ) { 0, 2, 2, 1, 0, 2, 3, 3, 2 }, 3);
+
+	check_spans(s_spans_cache_get(&cache, 0, L"", &filter), NULL, 0);
+
+	//
+	// A regex is matched on each line and empty matches are skipped.
+	//
+	s_spans_cache_invalidate(&cache);
+
+	s_filter_set(&filter, SF_IS_ACTIVE, L"^a*", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	filter.is_regex = true;
+	ut_check_bool(s_filter_prepare(&filter, NULL, 1), true);
+
+	check_spans(s_spans_cache_get(&cache, 0, L"aab\nba\naa", &filter), (int[] ) { 0, 0, 2, 2, 0, 2 }, 2);
+
+	s_filter_free(&filter);
+	s_spans_cache_free(&cache);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that entries are reused until the cache is invalidated.
+ *****************************************************************************/
+
+static void test_spans_cache() {
+	s_spans_cache cache;
+	s_filter filter;
+
+	const wchar_t *field = L"Hello World";
+
+	log_debug_str("Start");
+
+	s_spans_cache_init(&cache);
+	s_filter_init(&filter);
+
+	s_filter_set(&filter, SF_IS_ACTIVE, L"o", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	const s_spans_entry *entry = s_spans_cache_get(&cache, 0, field, &filter);
+	check_spans(entry, (int[] ) { 0, 4, 1, 0, 7, 1 }, 2);
+
+	//
+	// The filter changed, but the cache is not invalidated, so the cached
+	// spans are returned.
+	//
+	s_filter_set(&filter, SF_IS_ACTIVE, L"l", SF_IS_SENSITIVE, SF_IS_FILTERING);
+
+	ut_check_bool(s_spans_cache_get(&cache, 0, field, &filter) == entry, true);
+	check_spans(entry, (int[] ) { 0, 4, 1, 0, 7, 1 }, 2);
+
+	//
+	// After the invalidation the spans are computed again.
+	//
+	s_spans_cache_invalidate(&cache);
+
+	check_spans(s_spans_cache_get(&cache, 0, field, &filter), (int[] ) { 0, 2, 1, 0, 3, 1, 0, 9, 1 }, 3);
+
+	s_spans_cache_free(&cache);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	setlocale(LC_ALL, "");
+
+	test_spans_compute();
+
+	test_spans_cache();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}
@@ -210,6 +210,14 @@ static void test_table_search_filter() {
 	FILE *tmp = ut_create_tmp_file(data);
 	parser_process_file(tmp, &cfg_parser, &table);
 
+	//
+	// The table has one block, which is skipped if a filter has a char that
+	// is not contained in the table, for example: hallo
+	//
+	ut_check_int(table.blocks.no_blocks, 1, "blocks");
+	ut_check_bool(s_blocks_may_contain(&table.blocks, 0, 1, L"zz"), true);
+	ut_check_bool(s_blocks_may_contain(&table.blocks, 0, 1, L"hallo"), false);
+
 	//
 	// SEARCHING, INSENSITIVE WITH 2 MATCHES
 	//
@@ -255,6 +263,97 @@ static void test_table_search_filter() {
 	check_filter_result(&table, SF_IS_INACTIVE, 0, 5, "filter sensitive - no matches - result");
 	check_cursor(&cursor, cursor_save.row, cursor_save.col, "filter sensitive - no matches - cursor");
 
+	//
+	// FILTERING, INSENSITIVE, RESTRICTED TO THE LAST COLUMN WITH 2 MATCHES
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"xx", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	s_filter_set_columns(&table.filter, L"3");
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 3, "filter restricted - result");
+	check_cursor(&cursor, 1, 2, "filter restricted - cursor");
+
+	//
+	// SEARCHING, RESTRICTED TO A COLUMN WITHOUT MATCHES
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"xx", SF_IS_INSENSITIVE, SF_IS_SEARCHING);
+	s_filter_set_columns(&table.filter, L"1");
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NOT_NULL);
+	check_filter_result(&table, SF_IS_INACTIVE, 0, 5, "search restricted - no matches - result");
+
+	//
+	// FILTERING, SENSITIVE, REGEX WITH 2 MATCHES
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"^(a|c).*[a-c]$", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	table.filter.is_regex = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 3, "filter regex - result");
+	check_cursor(&cursor, 1, 1, "filter regex - cursor");
+
+	//
+	// SEARCHING WITH AN INVALID REGEX
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"(zz", SF_IS_SENSITIVE, SF_IS_SEARCHING);
+	table.filter.is_regex = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NOT_NULL);
+	check_filter_result(&table, SF_IS_INACTIVE, 0, 5, "search regex - invalid - result");
+
+	//
+	// FILTERING, FUZZY WITH 1 MATCH (one error)
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"cxyc", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	table.filter.is_fuzzy = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 1, 2, "filter fuzzy - result");
+	check_cursor(&cursor, 1, 1, "filter fuzzy - cursor");
+
+	//
+	// FILTERING, MULTI PATTERN WITH 2 MATCHES AND THE COUNTS OF THE
+	// PATTERNS (overlapping occurrences are counted)
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"zz|dd|yy", SF_IS_SENSITIVE, SF_IS_FILTERING);
+	table.filter.is_multi = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 3, "filter multi - result");
+	ut_check_int(s_aho_get_count(table.filter.aho, 0), 1, "filter multi - count zz");
+	ut_check_int(s_aho_get_count(table.filter.aho, 1), 3, "filter multi - count dd");
+	ut_check_int(s_aho_get_count(table.filter.aho, 2), 0, "filter multi - count yy");
+
+	//
+	// SEARCHING, MULTI PATTERN WITHOUT PATTERNS
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"||", SF_IS_SENSITIVE, SF_IS_SEARCHING);
+	table.filter.is_multi = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NOT_NULL);
+	check_filter_result(&table, SF_IS_INACTIVE, 0, 5, "search multi - invalid - result");
+
+	//
+	// FILTERING WITH AN EXPRESSION WITH 2 MATCHES (the negated predicate is
+	// not a match)
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"Number>1 AND NOT header-2~b", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	table.filter.is_expr = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 3, "filter expr - result");
+	check_cursor(&cursor, 1, 0, "filter expr - cursor");
+
+	//
+	// FILTERING WITH A NUMERIC RANGE, WHICH USES THE PARSED COLUMN
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"1 BETWEEN 2 AND 3", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	table.filter.is_expr = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 3, "filter range - result");
+	ut_check_bool(table.num_cache[0].is_parsed, true);
+	ut_check_bool(table.num_cache[1].is_parsed, false);
+
+	//
+	// SEARCHING WITH AN EXPRESSION WITH AN UNKNOWN COLUMN
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"Header-4=xx", SF_IS_INSENSITIVE, SF_IS_SEARCHING);
+	table.filter.is_expr = true;
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NOT_NULL);
+	check_filter_result(&table, SF_IS_INACTIVE, 0, 5, "search expr - invalid - result");
+
 	//
 	// RESET AFTER FILTERING, SENSITIVE WITH 1 MATCH
 	//
@@ -316,6 +415,27 @@ static void test_table_prev_next() {
 	s_table_update_filter_sort(&table, &cursor, true, false);
 	check_prev_next(&table, &cursor, "search insensitive", 3, (const s_row_col[] ) { { 2, 1 }, { 2, 2 }, { 4, 2 } });
 
+	//
+	// The match index of the cursor position.
+	//
+	ut_check_int(s_table_match_idx(&table, &cursor), 0, "match idx - first");
+
+	s_cursor_pos(&cursor, 4, 2);
+	ut_check_int(s_table_match_idx(&table, &cursor), 2, "match idx - last");
+
+	s_cursor_pos(&cursor, 3, 0);
+	ut_check_int(s_table_match_idx(&table, &cursor), -1, "match idx - no match");
+
+	//
+	// Prev / next from a field that is not a match.
+	//
+	s_table_prev_next(&table, &cursor, E_DIR_FORWARD);
+	check_cursor(&cursor, 4, 2, "not a match - forward");
+
+	s_cursor_pos(&cursor, 3, 0);
+	s_table_prev_next(&table, &cursor, E_DIR_BACKWARD);
+	check_cursor(&cursor, 2, 2, "not a match - backward");
+
 	//
 	// SEARCHING, SENSITIVE
 	//
@@ -337,6 +457,14 @@ static void test_table_prev_next() {
 	s_table_update_filter_sort(&table, &cursor, true, false);
 	check_prev_next(&table, &cursor, "filter insensitive", 1, (const s_row_col[] ) { { 1, 1 } });
 
+	//
+	// SEARCHING, INSENSITIVE, RESTRICTED TO THE LAST COLUMN
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"xx", SF_IS_INSENSITIVE, SF_IS_SEARCHING);
+	s_filter_set_columns(&table.filter, L"3");
+	s_table_update_filter_sort(&table, &cursor, true, false);
+	check_prev_next(&table, &cursor, "search restricted", 2, (const s_row_col[] ) { { 2, 2 }, { 4, 2 } });
+
 	//
 	// FILTERING INACTIVE
 	//
@@ -411,6 +539,18 @@ static void test_filter_and_sort() {
 	s_table_update_filter_sort(&table, &cursor, UNCHANGED, s_sort_update(&table.sort, 0, E_DIR_BACKWARD));
 	ut_check_table_column(&table, 1, 3, (const wchar_t*[] ) { L"EE", L"BB", L"DD" });
 
+	//
+	// The matches are in the order of the sorted table.
+	//
+	check_prev_next(&table, &cursor, "filter sorted", 3, (const s_row_col[] ) { { 0, 2 }, { 1, 2 }, { 2, 2 } });
+
+	//
+	// Searching the sorted table
+	//
+	s_table_update_filter_sort(&table, &cursor, s_filter_set(&table.filter, SF_IS_ACTIVE, L"z", SF_IS_SENSITIVE, SF_IS_SEARCHING), UNCHANGED);
+	ut_check_table_column(&table, 1, 5, (const wchar_t*[] ) { L"EE", L"AA", L"BB", L"CC", L"DD" });
+	check_prev_next(&table, &cursor, "search sorted", 3, (const s_row_col[] ) { { 0, 2 }, { 2, 2 }, { 4, 2 } });
+
 	//
 	// Change the sorted column and direction
 	//
@@ -427,6 +567,100 @@ static void test_filter_and_sort() {
 	log_debug_str("End");
 }
 
+/******************************************************************************
+ * The function tests the cache of the filter results and the combination of
+ * the view with the previous filter.
+ *****************************************************************************/
+
+static void test_table_combine_filter() {
+	s_cursor cursor;
+
+	s_table table;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t *data =
+
+	L"Number" DL "Header-2" DL "Header-3" NL
+	"1" DL "azza" DL "AZZA" NL
+	"2" DL "bbbb" DL "BBBB" NL
+	"3" DL "cxxc" DL "CCXX" NL
+	"4" DL "dddd" DL "XXDD" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	//
+	// Without a filter, there is nothing to combine.
+	//
+	ut_check_bool(s_table_combine_filter(&table, &cursor, E_COMBINE_NOT) != NULL, true);
+
+	//
+	// The results of the filters are cached.
+	//
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"zz", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 2, "combine zz - result");
+
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"xx", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 3, 3, "combine xx - result");
+
+	ut_check_int(table.filter_cache->no_entries, 2, "combine - cache entries");
+
+	//
+	// AND has no rows left, so the view is unchanged.
+	//
+	ut_check_bool(s_table_combine_filter(&table, &cursor, E_COMBINE_AND) != NULL, true);
+	ut_check_int(table.no_rows, 3, "combine and - rows");
+	ut_check_bool(s_table_is_combined(&table), false);
+
+	//
+	// OR has the rows of both filters, the matches are the matches of the
+	// current filter.
+	//
+	ut_check_bool(s_table_combine_filter(&table, &cursor, E_COMBINE_OR) == NULL, true);
+	check_filter_result(&table, SF_IS_ACTIVE, 3, 4, "combine or - result");
+	check_cursor(&cursor, 2, 1, "combine or - cursor");
+
+	//
+	// A sorting without a filter change keeps the combined view.
+	//
+	s_sort_update(&table.sort, 0, E_DIR_BACKWARD);
+	check_table_update_filter_sort(&table, &cursor, false, true, UT_IS_NULL);
+	ut_check_int(table.no_rows, 4, "combine or - sort");
+	ut_check_wchar_str(table.fields[1][0], L"4");
+
+	//
+	// A new filter replaces the combined view (like a job does) and the
+	// cached result is used.
+	//
+	s_bitmap_free(&table.combined);
+
+	s_filter_set(&table.filter, SF_IS_ACTIVE, L"zz", SF_IS_INSENSITIVE, SF_IS_FILTERING);
+	check_table_update_filter_sort(&table, &cursor, true, false, UT_IS_NULL);
+	check_filter_result(&table, SF_IS_ACTIVE, 2, 2, "combine cached - result");
+	ut_check_int(table.filter_cache->no_entries, 2, "combine cached - cache entries");
+
+	//
+	// NOT has the rows, that do not match.
+	//
+	ut_check_bool(s_table_combine_filter(&table, &cursor, E_COMBINE_NOT) == NULL, true);
+	check_filter_result(&table, SF_IS_ACTIVE, 0, 4, "combine not - result");
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
 /******************************************************************************
  * The main function simply starts the test.
  *****************************************************************************/
@@ -445,6 +679,8 @@ int main() {
 
 	test_filter_and_sort();
 
+	test_table_combine_filter();
+
 	log_debug_str("End");
 
 	return EXIT_SUCCESS;
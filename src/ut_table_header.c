@@ -149,6 +149,18 @@ static void test_table_has_header() {
 	result = check_column_characteristic(&table, table.no_rows, 4, get_ratio);
 	ut_check_int(result, HAS_NO_HEADER, "has_header - ratio: 4");
 
+	//
+	// The types of the columns: integer, float with the suffix ".218", float
+	// with the suffix " Euro", string, string
+	//
+	ut_check_bool(check_column_type(&table, table.no_rows, 0, L'.'), true);
+	ut_check_bool(check_column_type(&table, table.no_rows, 1, L'.'), true);
+	ut_check_bool(check_column_type(&table, table.no_rows, 2, L'.'), true);
+	ut_check_bool(check_column_type(&table, table.no_rows, 3, L'.'), false);
+	ut_check_bool(check_column_type(&table, table.no_rows, 4, L'.'), false);
+
+	ut_check_bool(s_table_has_header(&table), true);
+
 	//
 	// Cleanup
 	//
@@ -156,6 +168,32 @@ static void test_table_has_header() {
 
 	fclose(tmp);
 
+	//
+	// A table without a header, with a float in the first row of an integer
+	// column. The type of the column is only one vote for a header.
+	//
+	s_table_set_defaults(table);
+
+	data =
+
+	L"3.5" DL "abc" DL "xyz" NL
+	"12" DL "abd" DL "xya" NL
+	"-345" DL "abe" DL "xyb" NL
+	"6" DL "abf" DL "xyc" NL
+	"-78" DL "abg" DL "xyd" NL
+	"110" DL "abh" DL "xye" NL
+	"-2" DL "abi" DL "xyf" NL;
+
+	tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	ut_check_bool(check_column_type(&table, table.no_rows, 0, L'.'), true);
+	ut_check_bool(s_table_has_header(&table), false);
+
+	s_table_free(&table);
+
+	fclose(tmp);
+
 	log_debug_str("End");
 }
 
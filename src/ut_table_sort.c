@@ -249,6 +249,502 @@ static void test_sort_num_header() {
 	log_debug_str("End");
 }
 
+/******************************************************************************
+ * The function checks the numeric sorting with negative values, zeros and
+ * large values, which have different signs and exponents. Equal values keep
+ * their order, because the sorting is stable.
+ *****************************************************************************/
+
+static void test_sort_num_radix() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"0" DL "    -2.5" DL "filter" NL
+	L"1" DL "   1e300" DL "filter" NL
+	L"2" DL "    -0.0" DL "filter" NL
+	L"3" DL "-1000000" DL "filter" NL
+	L"4" DL "     0.0" DL "filter" NL
+	L"5" DL "        " DL "filter" NL
+	L"6" DL "    0.25" DL "filter" NL
+	L"7" DL "    -2.5" DL "filter" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = false;
+	s_filter_set(&table.filter, true, L"filter", false, false);
+
+	//
+	// Forward with column 1
+	//
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 8, (const wchar_t*[] ) { L"3", L"0", L"7", L"2", L"4", L"6", L"1", L"5" });
+
+	//
+	// Backward with column 1
+	//
+	s_sort_update(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 8, (const wchar_t*[] ) { L"5", L"1", L"6", L"2", L"4", L"0", L"7", L"3" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks that the sorting of a column is reused for the same set
+ * of rows and that it is recreated, if the filtering changes the rows.
+ *****************************************************************************/
+
+static void test_sort_cache() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"Id" DL "Name" NL
+	L"3" DL "b3" NL
+	L"1" DL "a1" NL
+	L"4" DL "b4" NL
+	L"2" DL "a2" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	//
+	// The first sorting creates the permutation for the unfiltered table.
+	//
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"Id", L"1", L"2", L"3", L"4" });
+	ut_check_int(table.sort_cache->perms[1].view, 0, "view forward");
+
+	int *rows = table.sort_cache->perms[1].rows;
+
+	//
+	// Change the direction, which reuses the permutation.
+	//
+	s_sort_update(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"Id", L"4", L"3", L"2", L"1" });
+	ut_check_bool(table.sort_cache->perms[1].rows == rows, true);
+
+	//
+	// Filtering changes the view, so the permutation is recreated.
+	//
+	s_filter_set(&table.filter, true, L"b", false, false);
+	s_table_update_filter_sort(&table, &cursor, true, false);
+
+	ut_check_table_column(&table, 0, 3, (const wchar_t*[] ) { L"Id", L"4", L"3" });
+	ut_check_int(table.sort_cache->perms[1].view, table.view, "view filtered");
+	ut_check_int(table.sort_cache->perms[1].size, 2, "size filtered");
+
+	//
+	// Reset the filter, which restores the unfiltered view.
+	//
+	s_filter_set_inactive(&table.filter);
+	s_table_update_filter_sort(&table, &cursor, true, false);
+
+	ut_check_int(table.view, 0, "view reset");
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"Id", L"4", L"3", L"2", L"1" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the sorting with several keys. Rows with equal values
+ * are sorted by the next key and rows that are equal for all keys keep the
+ * order of the table.
+ *****************************************************************************/
+
+static void test_sort_multi_key() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"Id" DL "Region" DL "Amount" NL
+	L"0" DL "north" DL "10" NL
+	L"1" DL "south" DL "5" NL
+	L"2" DL "north" DL "5" NL
+	L"3" DL "east" DL "10" NL
+	L"4" DL "south" DL "5" NL
+	L"5" DL "north" DL "20" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	//
+	// Region forward, amount backward
+	//
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_sort_add_key(&table.sort, 2, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"3", L"5", L"0", L"2", L"1", L"4" });
+
+	//
+	// Amount forward, region backward. The rows 1 and 4 are equal.
+	//
+	s_sort_update(&table.sort, 2, E_DIR_FORWARD);
+	s_sort_add_key(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"1", L"4", L"2", L"0", L"3", L"5" });
+
+	//
+	// Sort the amount as text.
+	//
+	ut_check_bool(s_sort_toggle_type(&table.sort, 2), true);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"0", L"3", L"5", L"1", L"4", L"2" });
+
+	//
+	// Remove the amount key, so the table is sorted by the region.
+	//
+	s_sort_add_key(&table.sort, 2, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"1", L"4", L"0", L"2", L"5", L"3" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the sorting with the collation of the locale. With the
+ * 'C.UTF-8' locale the collation is the order of the chars. The long value
+ * does not fit into the initial arena. If a german or english locale is
+ * installed, the umlaut is sorted before the 'Z'.
+ *****************************************************************************/
+
+static void test_sort_coll() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	setlocale(LC_ALL, "C.UTF-8");
+
+	const wchar_t data[] =
+
+	L"Id" DL "Name" NL
+	L"0" DL "b" NL
+	L"1" DL "Zebra" NL
+	L"2" DL "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" NL
+	L"3" DL "\u00C4pfel" NL
+	L"4" DL "b" NL
+	L"5" DL "" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_sort_toggle_type(&table.sort, 1);
+	s_sort_toggle_type(&table.sort, 1);
+	ut_check_int(table.sort.keys[0].type, E_SORT_COLL, "type");
+
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"5", L"1", L"2", L"0", L"4", L"3" });
+
+	//
+	// Backward keeps the order of the equal values.
+	//
+	s_sort_update(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"3", L"0", L"4", L"2", L"1", L"5" });
+
+	if (setlocale(LC_COLLATE, "de_DE.UTF-8") != NULL || setlocale(LC_COLLATE, "en_US.UTF-8") != NULL) {
+
+		//
+		// The view is unchanged, so the permutation has to be removed.
+		//
+		table.sort_cache->perms[1].view = -1;
+
+		s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+		s_table_update_filter_sort(&table, &cursor, false, true);
+
+		ut_check_table_column(&table, 0, 7, (const wchar_t*[] ) { L"Id", L"5", L"2", L"3", L"0", L"4", L"1" });
+	}
+
+	setlocale(LC_ALL, "C");
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the natural sorting. Numbers are compared by their
+ * values, so leading zeros are ignored.
+ *****************************************************************************/
+
+static void test_sort_nat() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"Id" DL "Name" NL
+	L"0" DL "host10" NL
+	L"1" DL "v1.10" NL
+	L"2" DL "host2" NL
+	L"3" DL "v1.9" NL
+	L"4" DL "host" NL
+	L"5" DL "host02" NL
+	L"6" DL "" NL
+	L"7" DL "host0" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	table.sort.keys[0].type = E_SORT_NAT;
+
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 9, (const wchar_t*[] ) { L"Id", L"6", L"4", L"7", L"2", L"5", L"0", L"3", L"1" });
+
+	//
+	// The text sorting for comparison.
+	//
+	table.sort.keys[0].type = E_SORT_STR;
+
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 9, (const wchar_t*[] ) { L"Id", L"6", L"4", L"7", L"5", L"0", L"2", L"1", L"3" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the string sorting with strings, that are longer than
+ * the packed prefix and equal in the prefix.
+ *****************************************************************************/
+
+static void test_sort_wcs_prefix() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"0" DL "abcdefghiz" NL
+	L"1" DL "abcdefghi" NL
+	L"2" DL "abcdefghia" NL
+	L"3" DL "abcdefgh" NL
+	L"4" DL "abcdefghiz" NL
+	L"5" DL "b" NL
+	L"6" DL "abcdefghi" NL
+	L"7" DL "abcdefghijklmnopqrstuvwxyz" NL
+	L"8" DL "abcdefghijklmnopqrstuvwxya" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = false;
+
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 9, (const wchar_t*[] ) { L"3", L"1", L"6", L"2", L"8", L"7", L"0", L"4", L"5" });
+
+	//
+	// Equal strings have the same rank, so they keep their order backward.
+	//
+	s_sort_update(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 9, (const wchar_t*[] ) { L"5", L"0", L"4", L"7", L"8", L"2", L"1", L"6", L"3" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the sorting of a boolean column, which is sorted by its
+ * values and not by the strings.
+ *****************************************************************************/
+
+static void test_sort_bool() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"id" DL "active" NL
+	L"0" DL "true" NL
+	L"1" DL "FALSE" NL
+	L"2" DL "True" NL
+	L"3" DL "false" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"id", L"1", L"3", L"0", L"2" });
+
+	s_sort_update(&table.sort, 1, E_DIR_BACKWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 5, (const wchar_t*[] ) { L"id", L"0", L"2", L"1", L"3" });
+
+	ut_check_int(table.num_cache[1].type, E_NUM_TYPE_BOOL, "bool - type");
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The function checks the sorting of a date column, which is sorted by the
+ * seconds since 1970-01-01, and the filtering with a date range.
+ *****************************************************************************/
+
+static void test_sort_date() {
+	s_table table;
+	s_cursor cursor;
+	s_table_set_defaults(table);
+
+	log_debug_str("Start");
+
+	const wchar_t data[] =
+
+	L"id" DL "date" NL
+	L"0" DL "16/10/2026 14:03" NL
+	L"1" DL "02/01/2026" NL
+	L"2" DL "16/10/2026 09:00" NL
+	L"3" DL "" NL
+	L"4" DL "31/12/2025" NL;
+
+	const s_cfg_parser cfg_parser = { .filename = NULL, .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *tmp = ut_create_tmp_file(data);
+	parser_process_file(tmp, &cfg_parser, &table);
+
+	table.show_header = true;
+
+	s_sort_update(&table.sort, 1, E_DIR_FORWARD);
+	s_table_update_filter_sort(&table, &cursor, false, true);
+
+	ut_check_table_column(&table, 0, 6, (const wchar_t*[] ) { L"id", L"4", L"1", L"2", L"0", L"3" });
+	ut_check_int(table.num_cache[1].type, E_NUM_TYPE_DATE, "date - type");
+
+	//
+	// Filter with a date range, the rows stay sorted.
+	//
+	s_filter_set(&table.filter, true, L"date>=2026-02-01", false, false);
+	table.filter.is_expr = true;
+	s_table_update_filter_sort(&table, &cursor, true, true);
+
+	ut_check_table_column(&table, 0, 3, (const wchar_t*[] ) { L"id", L"2", L"0" });
+
+	//
+	// Cleanup
+	//
+	s_table_free(&table);
+
+	fclose(tmp);
+
+	log_debug_str("End");
+}
+
 /******************************************************************************
  * The main function simply starts the test.
  *****************************************************************************/
@@ -272,6 +768,22 @@ int main() {
 
 	test_sort_num_header();
 
+	test_sort_num_radix();
+
+	test_sort_cache();
+
+	test_sort_multi_key();
+
+	test_sort_coll();
+
+	test_sort_nat();
+
+	test_sort_wcs_prefix();
+
+	test_sort_bool();
+
+	test_sort_date();
+
 	log_debug_str("End");
 
 	return EXIT_SUCCESS;
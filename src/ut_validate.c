@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 dead-end
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ut_utils.h"
+#include "ncv_validate.h"
+
+#include <locale.h>
+#include <string.h>
+#include <errno.h>
+
+/******************************************************************************
+ * The function creates a tmp file with the bytes of a string. The validation
+ * reads bytes, so the file must not be wide oriented.
+ *****************************************************************************/
+
+static FILE* create_byte_file(const char *data) {
+	FILE *tmp;
+
+	if ((tmp = tmpfile()) == NULL) {
+		log_exit("Unable to create tmp file: %s", strerror(errno));
+	}
+
+	if (fputs(data, tmp) == EOF) {
+		log_exit_str("Unable write data to the tmp file!");
+	}
+
+	rewind(tmp);
+
+	return tmp;
+}
+
+/******************************************************************************
+ * The function validates a string and checks the result. The report is
+ * written to a tmp file and compared with the expected report.
+ *****************************************************************************/
+
+static void check_validate(const char *data, const long no_rows, const long no_errors, const char *report) {
+	s_validate_result result;
+	char buf[1024];
+
+	const s_cfg_parser cfg_parser = { .filename = "test.csv", .delim = W_DELIM, .do_trim = false, .strict = true };
+
+	FILE *in = create_byte_file(data);
+	FILE *out = tmpfile();
+
+	validate_file(in, &cfg_parser, out, &result);
+
+	ut_check_int((int) result.no_rows, (int) no_rows, "validate - rows");
+	ut_check_int((int) s_validate_no_errors(&result), (int) no_errors, "validate - errors");
+
+	rewind(out);
+
+	const size_t len = fread(buf, 1, sizeof(buf) - 1, out);
+	buf[len] = '\0';
+
+	ut_check_char_str(buf, report);
+
+	fclose(in);
+	fclose(out);
+}
+
+/******************************************************************************
+ * The function checks the validation of valid and invalid csv data.
+ *****************************************************************************/
+
+static void test_validate() {
+
+	log_debug_str("Start");
+
+	//
+	// Valid data, with escaped fields and different line endings.
+	//
+	check_validate("a,b\r\n\"1,\"\"x\"\"\",2\r\"3\n3\",4", 3, 0, "");
+
+	check_validate("", 0, 0, "");
+
+	//
+	// Rows with missing and additional columns.
+	//
+	check_validate("a,b\n1\n2,2\n3,3,3\n", 4, 2,
+
+	"test.csv: offset 4: row 2 has 1 columns, expected 2\n"
+	"test.csv: offset 10: row 4 has 3 columns, expected 2\n");
+
+	//
+	// A char after a closing quote and a missing quote.
+	//
+	check_validate("a,b\n\"1\"x,2\n\"3,4\n", 3, 3,
+
+	"test.csv: offset 7: invalid character after a quote: x\n"
+	"test.csv: offset 11: quote missing\n"
+	"test.csv: offset 11: row 3 has 1 columns, expected 2\n");
+
+	//
+	// An invalid utf-8 byte and an incomplete char at the end.
+	//
+	check_validate("a,b\n1,\xff\n2,\xc3", 3, 2,
+
+	"test.csv: offset 6: character encoding error\n"
+	"test.csv: offset 10: incomplete character at the end of the file\n");
+
+	log_debug_str("End");
+}
+
+/******************************************************************************
+ * The main function simply starts the test.
+ *****************************************************************************/
+
+int main() {
+
+	log_debug_str("Start");
+
+	setlocale(LC_ALL, "C.UTF-8");
+
+	test_validate();
+
+	log_debug_str("End");
+
+	return EXIT_SUCCESS;
+}